@@ -0,0 +1,174 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file AsyncBamWriter.h
+/// \brief Defines the AsyncBamWriter class.
+//
+// Author: Derek Barnett
+
+#ifndef ASYNCBAMWRITER_H
+#define ASYNCBAMWRITER_H
+
+#include "pbbam/BamHeader.h"
+#include "pbbam/BamRecord.h"
+#include "pbbam/BamWriter.h"
+#include "pbbam/Config.h"
+#include <memory>
+#include <string>
+
+namespace PacBio {
+namespace BAM {
+
+namespace internal { class AsyncBamWriterPrivate; }
+
+/// \brief The AsyncBamWriter class provides a writing interface that hands
+///        records off to a background thread for serialization &
+///        compression.
+///
+/// Write() places each record on a bounded queue & returns immediately,
+/// unless the queue is full, in which case it waits for the background
+/// thread to catch up. The background thread feeds queued records to a
+/// BamWriter, so any validation (PBBAM_AUTOVALIDATE), encoding, compression,
+/// and optional index generation happens off of the caller's thread.
+///
+/// Errors raised on the background thread are stored and rethrown from the
+/// next call to Write, Flush, or Close.
+///
+/// \note AsyncBamWriter is intended for a single producer thread. Records are
+///       written in the order that Write() is called.
+///
+/// \note As with BamWriter, the output file is not complete until Close is
+///       called (or the writer is destroyed). Prefer calling Close
+///       explicitly, as errors from the destructor cannot be reported.
+///
+class PBBAM_EXPORT AsyncBamWriter
+{
+public:
+    /// \name Constructors & Related Methods
+    /// \{
+
+    /// \brief Opens a %BAM file for writing, writes the header information,
+    ///        & starts the background writing thread.
+    ///
+    /// \note Set \p filename to "-" for stdout.
+    ///
+    /// \param[in] filename         path to output %BAM file
+    /// \param[in] header           BamHeader object
+    /// \param[in] maxQueueSize     maximum number of records waiting to be
+    ///                             written, before Write() blocks
+    /// \param[in] compressionLevel zlib compression level
+    /// \param[in] numThreads       number of threads for compression (see
+    ///                             BamWriter)
+    /// \param[in] binCalculationMode BAI bin calculation mode (see BamWriter)
+    /// \param[in] indexTypes       index files to generate on the fly (see
+    ///                             BamWriter::IndexType)
+    ///
+    /// \throws std::runtime_error if there was a problem opening the file for
+    ///         writing or if an error occurred while writing the header
+    ///
+    AsyncBamWriter(const std::string& filename,
+                   const BamHeader& header,
+                   const size_t maxQueueSize = 1024,
+                   const BamWriter::CompressionLevel compressionLevel = BamWriter::DefaultCompression,
+                   const size_t numThreads = 4,
+                   const BamWriter::BinCalculationMode binCalculationMode = BamWriter::BinCalculation_ON,
+                   const BamWriter::IndexTypes indexTypes = BamWriter::NoIndex);
+
+    /// \brief Finishes writing (if Close has not been called).
+    ///
+    /// Any errors are swallowed here, leaving no output file. Call Close to
+    /// observe them.
+    ///
+    ~AsyncBamWriter(void);
+
+    /// \}
+
+public:
+    /// \name Data Writing & Resource Management
+    /// \{
+
+    /// \brief Queues a copy of \p record for writing.
+    ///
+    /// \param[in] record BamRecord object
+    ///
+    /// \throws std::runtime_error if writer has been closed, or rethrows any
+    ///         error from the background thread
+    ///
+    void Write(const BamRecord& record);
+
+    /// \brief Queues \p record for writing, taking ownership of its data.
+    ///
+    /// No record data is copied, which is useful for large records (e.g. with
+    /// kinetics tags).
+    ///
+    /// \param[in] record BamRecord object, left in a moved-from state
+    ///
+    /// \throws std::runtime_error if writer has been closed, or rethrows any
+    ///         error from the background thread
+    ///
+    void Write(BamRecord&& record);
+
+    /// \brief Waits for all queued records to be written, then tries to flush
+    ///        buffered data to file.
+    ///
+    /// \note As with BamWriter::TryFlush, buffered data is not guaranteed to
+    ///       reach the file until Close().
+    ///
+    /// \throws std::runtime_error if writer has been closed, or rethrows any
+    ///         error from the background thread
+    ///
+    void Flush(void);
+
+    /// \brief Waits for all queued records to be written, stops the background
+    ///        thread, & closes the file (writing any requested index files).
+    ///
+    /// No further records may be written after this call.
+    ///
+    /// \throws rethrows any error from the background thread
+    ///
+    void Close(void);
+
+    /// \}
+
+private:
+    std::unique_ptr<internal::AsyncBamWriterPrivate> d_;
+    DISABLE_MOVE_AND_COPY(AsyncBamWriter);
+};
+
+} // namespace BAM
+} // namespace PacBio
+
+#endif // ASYNCBAMWRITER_H
@@ -84,6 +84,23 @@ public:
     /// \name Index & Filename Methods
     /// \{
 
+    /// \brief Creates both ".pbi" & ".bai" files for this %BAM file.
+    ///
+    /// Both indices are built from a single pass over the %BAM records,
+    /// rather than the separate passes made by calling CreatePacBioIndex() &
+    /// CreateStandardIndex().
+    ///
+    /// \note Existing index files will be overwritten.
+    ///
+    /// \param[in] numThreads number of threads for PBI compression. If set to
+    ///            0, a reasonable estimate will be determined. If set to 1,
+    ///            this will force single-threaded execution.
+    ///
+    /// \throws if either index file could not be properly created (e.g. this
+    ///         %BAM is not coordinate-sorted) or could not be written to disk
+    ///
+    void CreateIndexes(const size_t numThreads = 4) const;
+
     /// \brief Creates a ".pbi" file for this %BAM file.
     ///
     /// \note Existing index file will be overwritten. Use
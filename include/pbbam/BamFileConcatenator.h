@@ -0,0 +1,95 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file BamFileConcatenator.h
+/// \brief Defines the BamFileConcatenator class.
+//
+// Author: Derek Barnett
+
+#ifndef BAMFILECONCATENATOR_H
+#define BAMFILECONCATENATOR_H
+
+#include "pbbam/BamFile.h"
+#include "pbbam/Config.h"
+#include "pbbam/ProgramInfo.h"
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace BAM {
+
+/// \brief The BamFileConcatenator class joins %BAM files, in the order
+///        provided, without decoding their records.
+///
+/// After writing a merged header, each input's compressed BGZF blocks are
+/// copied verbatim to the output. Only the (usually empty) remainder of the
+/// block holding the end of an input's header is re-compressed. Input PBI
+/// files are concatenated with their file offsets rebased onto the output, so
+/// no record is ever decoded and throughput is bound by disk I/O.
+///
+/// Since records are not decoded, all inputs must share an identical @SQ list
+/// and the caller is responsible for the order of the inputs (e.g. sequential
+/// chunks of a movie, or non-overlapping coordinate ranges).
+///
+class PBBAM_EXPORT BamFileConcatenator
+{
+public:
+    /// \brief Concatenates input %BAM files into a single output %BAM.
+    ///
+    /// When this function exits, the output %BAM (and optional PBI) will have
+    /// been written and closed.
+    ///
+    /// \param[in] inputFiles       source %BAM files, in output order
+    /// \param[in] outputFilename   resulting %BAM output ("-" for stdout)
+    /// \param[in] program          info about the calling program. If valid,
+    ///                             adds a @PG entry to the merged header.
+    /// \param[in] createPbi        if true, concatenates the inputs' PBI files
+    ///                             into a PBI alongside the output %BAM.
+    ///                             Ignored if writing to stdout.
+    ///
+    /// \throws std::runtime_error if headers are incompatible, if a requested
+    ///         input PBI is missing, or on any other read/write error
+    ///
+    static void Concatenate(const std::vector<BamFile>& inputFiles,
+                            const std::string& outputFilename,
+                            const ProgramInfo& program = ProgramInfo(),
+                            bool createPbi = true);
+};
+
+} // namespace BAM
+} // namespace PacBio
+
+#endif // BAMFILECONCATENATOR_H
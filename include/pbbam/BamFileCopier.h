@@ -0,0 +1,124 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file BamFileCopier.h
+/// \brief Defines the BamFileCopier class.
+//
+// Author: Derek Barnett
+
+#ifndef BAMFILECOPIER_H
+#define BAMFILECOPIER_H
+
+#include "pbbam/BamFile.h"
+#include "pbbam/Config.h"
+#include "pbbam/DataSet.h"
+#include "pbbam/PbiFilter.h"
+#include "pbbam/ProgramInfo.h"
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace BAM {
+
+/// \brief The BamFileCopier class writes the records of %BAM files that pass
+///        a PbiFilter to a new %BAM file, re-compressing as little data as
+///        possible.
+///
+/// Input PBI files are used to determine which byte ranges of each input's
+/// (decompressed) record stream belong to accepted records. Any BGZF block
+/// holding only accepted record data is copied to the output verbatim.
+/// Only blocks that are partially selected (or that also hold header data)
+/// are decompressed, and just their accepted byte ranges are re-compressed.
+/// Records are never parsed, so for mild filters throughput is bound mostly
+/// by disk I/O.
+///
+/// This is equivalent to writing every record from a PbiFilterQuery to a
+/// BamWriter, but much faster.
+///
+/// Since records are not decoded, all inputs must share an identical @SQ list.
+/// Records are written in input order.
+///
+class PBBAM_EXPORT BamFileCopier
+{
+public:
+    /// \brief Copies records from \p inputFiles that pass \p filter into a
+    ///        single output %BAM.
+    ///
+    /// When this function exits, the output %BAM (and optional PBI) will have
+    /// been written and closed.
+    ///
+    /// \param[in] inputFiles       source %BAM files, in output order. Each
+    ///                             must have a PBI file.
+    /// \param[in] filter           record filter
+    /// \param[in] outputFilename   resulting %BAM output ("-" for stdout)
+    /// \param[in] program          info about the calling program. If valid,
+    ///                             adds a @PG entry to the merged header.
+    /// \param[in] createPbi        if true, writes a PBI alongside the output
+    ///                             %BAM, from the inputs' PBI data. Ignored if
+    ///                             writing to stdout.
+    ///
+    /// \throws std::runtime_error if headers are incompatible, if an input PBI
+    ///         is missing, or on any other read/write error
+    ///
+    static void Copy(const std::vector<BamFile>& inputFiles,
+                     const PbiFilter& filter,
+                     const std::string& outputFilename,
+                     const ProgramInfo& program = ProgramInfo(),
+                     bool createPbi = true);
+
+    /// \brief Copies records from \p dataset's %BAM files that pass its
+    ///        filters into a single output %BAM.
+    ///
+    /// Equivalent to:
+    /// \code{.cpp}
+    ///    BamFileCopier::Copy(dataset.BamFiles(),
+    ///                        PbiFilter::FromDataSet(dataset),
+    ///                        outputFilename, program, createPbi);
+    /// \endcode
+    ///
+    /// \throws std::runtime_error if headers are incompatible, if an input PBI
+    ///         is missing, or on any other read/write error
+    ///
+    static void Copy(const DataSet& dataset,
+                     const std::string& outputFilename,
+                     const ProgramInfo& program = ProgramInfo(),
+                     bool createPbi = true);
+};
+
+} // namespace BAM
+} // namespace PacBio
+
+#endif // BAMFILECOPIER_H
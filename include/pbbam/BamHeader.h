@@ -53,7 +53,10 @@
 namespace PacBio {
 namespace BAM {
 
-namespace internal { class BamHeaderPrivate; }
+namespace internal {
+class BamHeaderPrivate;
+class ReadGroupTable;
+}
 
 /// \brief The BamHeader class represents the header section of the %BAM file.
 ///
@@ -82,9 +85,9 @@ public:
     BamHeader(void);
     BamHeader(const std::string& samHeaderText);
     BamHeader(const BamHeader& other);
-    BamHeader(BamHeader&& other);
+    BamHeader(BamHeader&& other) noexcept;
     BamHeader& operator=(const BamHeader& other);
-    BamHeader& operator=(BamHeader&& other);
+    BamHeader& operator=(BamHeader&& other) noexcept;
     ~BamHeader(void);
 
     /// \brief Detaches underlying data from the shared-pointer, returning a
@@ -178,6 +181,16 @@ public:
     ///
     std::vector<ReadGroupInfo> ReadGroups(void) const;
 
+    /// \internal
+    /// \returns lookup table of this header's read groups, with pre-parsed
+    ///          movie names & record types (used for per-record lookups).
+    ///
+    /// The table is built on first request and is safe to share between
+    /// threads. It (and any references into it) remains valid until this
+    /// header's read groups are modified.
+    ///
+    const internal::ReadGroupTable& ReadGroupLookupTable(void) const;
+
     /// \}
 
 public:
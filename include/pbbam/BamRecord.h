@@ -46,6 +46,7 @@
 #include "pbbam/Frames.h"
 #include "pbbam/BamRecordImpl.h"
 #include "pbbam/BamHeader.h"
+#include "pbbam/internal/CacheState.h"
 #include "pbbam/LocalContextFlags.h"
 #include "pbbam/Orientation.h"
 #include "pbbam/ReadGroupInfo.h"
@@ -118,6 +119,15 @@ enum class FrameEncodingType
 /// Mapping and clipping APIs are provided as well to ensure that such
 /// operations "trickle down" to all data fields properly.
 ///
+/// Copying a BamRecord does not copy its %BAM data; copies share it until one
+/// of them is modified (see BamRecordImpl).
+///
+/// A single record may be shared by several threads, as long as they only call
+/// const methods. Values computed lazily on first access (aligned start/end,
+/// record type, tag offsets) are computed once, and are safe to request
+/// concurrently. Modifying a record while it is accessed elsewhere is not
+/// safe.
+///
 /// \sa https://samtools.github.io/hts-specs/SAMv1.pdf
 ///     for more information on standard %BAM data, and
 ///     https://github.com/PacificBiosciences/PacBioFileFormats/blob/3.0/BAM.rst
@@ -134,9 +144,9 @@ public:
     BamRecord(const BamRecordImpl& impl);
     BamRecord(BamRecordImpl&& impl);
     BamRecord(const BamRecord& other);
-    BamRecord(BamRecord&& other);
+    BamRecord(BamRecord&& other) noexcept;
     BamRecord& operator=(const BamRecord& other);
-    BamRecord& operator=(BamRecord&& other);
+    BamRecord& operator=(BamRecord&& other) noexcept;
     virtual ~BamRecord(void);
 
     /// \}
@@ -162,7 +172,13 @@ public:
     PacBio::BAM::LocalContextFlags LocalContextFlags(void) const;
 
     /// \returns this record's movie name
-    std::string MovieName(void) const;
+    ///
+    /// \note The returned reference is owned by this record's header, and
+    ///       remains valid until the header's read groups are modified.
+    ///
+    /// \throws std::runtime_error if this record's read group is missing
+    ///
+    const std::string& MovieName(void) const;
 
     /// \returns "number of complete passes of the insert"
     int32_t NumPasses(void) const;
@@ -185,7 +201,13 @@ public:
     Accuracy ReadAccuracy(void) const;
 
     /// \returns ReadGroupInfo object for this record
-    ReadGroupInfo ReadGroup(void) const;
+    ///
+    /// \note The returned reference is owned by this record's header, and
+    ///       remains valid until the header's read groups are modified.
+    ///
+    /// \throws std::runtime_error if this record's read group is missing
+    ///
+    const ReadGroupInfo& ReadGroup(void) const;
 
     /// \returns string ID of this record's read group
     /// \sa ReadGroupInfo::Id
@@ -465,6 +487,18 @@ public:
                             bool aligned = false,
                             bool exciseSoftClips = false) const;
 
+    /// \brief Fetches this record's DeletionTag values into an existing string.
+    ///
+    /// This is an overloaded method, reusing \p tags' storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] tags           result
+    ///
+    void DeletionTag(std::string* tags,
+                     Orientation orientation = Orientation::NATIVE,
+                     bool aligned = false,
+                     bool exciseSoftClips = false) const;
+
     /// \brief Fetches this record's DNA sequence (SEQ field).
     ///
     /// \note If \p aligned is true, and gaps/padding need to be inserted, the
@@ -482,6 +516,18 @@ public:
                          bool aligned = false,
                          bool exciseSoftClips = false) const;
 
+    /// \brief Fetches this record's DNA sequence into an existing string.
+    ///
+    /// This is an overloaded method, reusing \p sequence's storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] sequence       result
+    ///
+    void Sequence(std::string* sequence,
+                  Orientation orientation = Orientation::NATIVE,
+                  bool aligned = false,
+                  bool exciseSoftClips = false) const;
+
     /// \brief Fetches this record's SubstitutionTag values ("st" tag).
     ///
     /// \note If \p aligned is true, and gaps/padding need to be inserted, the
@@ -499,6 +545,18 @@ public:
                                 bool aligned = false,
                                 bool exciseSoftClips = false) const;
 
+    /// \brief Fetches this record's SubstitutionTag values into an existing string.
+    ///
+    /// This is an overloaded method, reusing \p tags' storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] tags           result
+    ///
+    void SubstitutionTag(std::string* tags,
+                         Orientation orientation = Orientation::NATIVE,
+                         bool aligned = false,
+                         bool exciseSoftClips = false) const;
+
     /// \}
 
 public:
@@ -533,6 +591,18 @@ public:
                              bool aligned = false,
                              bool exciseSoftClips = false) const;
 
+    /// \brief Fetches this record's DeletionQV values into an existing QualityValues.
+    ///
+    /// This is an overloaded method, reusing \p qualities's storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] qualities      result
+    ///
+    void DeletionQV(QualityValues* qualities,
+                    Orientation orientation = Orientation::NATIVE,
+                    bool aligned = false,
+                    bool exciseSoftClips = false) const;
+
     /// \brief Fetches this record's InsertionQV values ("iq" tag).
     ///
     /// \note If \p aligned is true, and gaps/padding need to be inserted, the
@@ -550,6 +620,18 @@ public:
                               bool aligned = false,
                               bool exciseSoftClips = false) const;
 
+    /// \brief Fetches this record's InsertionQV values into an existing QualityValues.
+    ///
+    /// This is an overloaded method, reusing \p qualities's storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] qualities      result
+    ///
+    void InsertionQV(QualityValues* qualities,
+                     Orientation orientation = Orientation::NATIVE,
+                     bool aligned = false,
+                     bool exciseSoftClips = false) const;
+
     /// \brief Fetches this record's LabelQV values ("pq" tag).
     ///
     /// \note If \p aligned is true, and gaps/padding need to be inserted, the
@@ -578,6 +660,18 @@ public:
                           bool aligned = false,
                           bool exciseSoftClips = false) const;
 
+    /// \brief Fetches this record's MergeQV values into an existing QualityValues.
+    ///
+    /// This is an overloaded method, reusing \p qualities's storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] qualities      result
+    ///
+    void MergeQV(QualityValues* qualities,
+                 Orientation orientation = Orientation::NATIVE,
+                 bool aligned = false,
+                 bool exciseSoftClips = false) const;
+
     /// \brief Fetches  this record's %BAM quality values (QUAL field).
     ///
     /// \note If \p aligned is true, and gaps/padding need to be inserted, the
@@ -595,6 +689,18 @@ public:
                             bool aligned = false,
                             bool exciseSoftClips = false) const;
 
+    /// \brief Fetches this record's %BAM quality values into an existing QualityValues.
+    ///
+    /// This is an overloaded method, reusing \p qualities's storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] qualities      result
+    ///
+    void Qualities(QualityValues* qualities,
+                   Orientation orientation = Orientation::NATIVE,
+                   bool aligned = false,
+                   bool exciseSoftClips = false) const;
+
     /// \brief Fetches this record's SubstitutionQV values ("sq" tag).
     ///
     /// \note If \p aligned is true, and gaps/padding need to be inserted, the
@@ -612,6 +718,18 @@ public:
                                  bool aligned = false,
                                  bool exciseSoftClips = false) const;
 
+    /// \brief Fetches this record's SubstitutionQV values into an existing QualityValues.
+    ///
+    /// This is an overloaded method, reusing \p qualities's storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] qualities      result
+    ///
+    void SubstitutionQV(QualityValues* qualities,
+                        Orientation orientation = Orientation::NATIVE,
+                        bool aligned = false,
+                        bool exciseSoftClips = false) const;
+
     /// \}
 
 public:
@@ -635,6 +753,18 @@ public:
                bool aligned = false,
                bool exciseSoftClips = false) const;
 
+    /// \brief Fetches this record's IPD values into an existing Frames.
+    ///
+    /// This is an overloaded method, reusing \p frames's storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] frames         result
+    ///
+    void IPD(Frames* frames,
+             Orientation orientation = Orientation::NATIVE,
+             bool aligned = false,
+             bool exciseSoftClips = false) const;
+
     /// \brief Fetches this record's IPD values ("ip" tag), but does not upscale.
     ///
     /// \param[in] orientation     Orientation of output.
@@ -649,6 +779,16 @@ public:
     ///
     std::vector<float> Pkmean(Orientation orientation = Orientation::NATIVE) const;
 
+    /// \brief Fetches this record's Pkmean values into an existing vector.
+    ///
+    /// This is an overloaded method, reusing \p photons' storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] photons     result
+    ///
+    void Pkmean(std::vector<float>* photons,
+                Orientation orientation = Orientation::NATIVE) const;
+
     /// \brief Fetches this record's Pkmid values ("pm" tag).
     ///
     /// \param[in] orientation     Orientation of output.
@@ -656,6 +796,16 @@ public:
     ///
     std::vector<float> Pkmid(Orientation orientation = Orientation::NATIVE) const;
 
+    /// \brief Fetches this record's Pkmid values into an existing vector.
+    ///
+    /// This is an overloaded method, reusing \p photons' storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] photons     result
+    ///
+    void Pkmid(std::vector<float>* photons,
+               Orientation orientation = Orientation::NATIVE) const;
+
     /// \brief Fetches this record's Pkmean2 values ("pi" tag).
     ///
     /// \param[in] orientation     Orientation of output.
@@ -663,6 +813,16 @@ public:
     ///
     std::vector<float> Pkmean2(Orientation orientation = Orientation::NATIVE) const;
 
+    /// \brief Fetches this record's Pkmean2 values into an existing vector.
+    ///
+    /// This is an overloaded method, reusing \p photons' storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] photons     result
+    ///
+    void Pkmean2(std::vector<float>* photons,
+                 Orientation orientation = Orientation::NATIVE) const;
+
     /// \brief Fetches this record's Pkmid2 values ("ps" tag).
     ///
     /// \param[in] orientation     Orientation of output.
@@ -670,6 +830,16 @@ public:
     ///
     std::vector<float> Pkmid2(Orientation orientation = Orientation::NATIVE) const;
 
+    /// \brief Fetches this record's Pkmid2 values into an existing vector.
+    ///
+    /// This is an overloaded method, reusing \p photons' storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] photons     result
+    ///
+    void Pkmid2(std::vector<float>* photons,
+                Orientation orientation = Orientation::NATIVE) const;
+
     /// \brief Fetches this record's PreBaseFrames aka IPD values ("ip" tag).
     ///
     /// \note If \p aligned is true, and gaps/padding need to be inserted, the
@@ -687,6 +857,18 @@ public:
                          bool aligned = false,
                          bool exciseSoftClips = false) const;
 
+    /// \brief Fetches this record's PreBaseFrames values into an existing Frames.
+    ///
+    /// This is an overloaded method, reusing \p frames's storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] frames         result
+    ///
+    void PreBaseFrames(Frames* frames,
+                       Orientation orientation = Orientation::NATIVE,
+                       bool aligned = false,
+                       bool exciseSoftClips = false) const;
+
     /// \brief Fetches this record's PrePulseFrames values ("pd" tag).
     ///
     /// \param[in] orientation     Orientation of output.
@@ -732,6 +914,18 @@ public:
                       bool aligned = false,
                       bool exciseSoftClips = false) const;
 
+    /// \brief Fetches this record's PulseWidth values into an existing Frames.
+    ///
+    /// This is an overloaded method, reusing \p frames's storage instead of
+    /// returning a new object.
+    ///
+    /// \param[out] frames         result
+    ///
+    void PulseWidth(Frames* frames,
+                    Orientation orientation = Orientation::NATIVE,
+                    bool aligned = false,
+                    bool exciseSoftClips = false) const;
+
     /// \brief Fetches this record's PulseWidth values ("pw" tag), but does not
     ///        upscale.
     ///
@@ -1108,21 +1302,26 @@ public:
     /// \name Low-Level Access & Operations
     /// \{
 
-    /// \brief Resets cached aligned start/end.
+    /// \brief Resets cached aligned start/end (and CIGAR-derived values, e.g.
+    ///        NumMatches).
     ///
-    /// \note This method should not be needed in most client code. It exists
-    ///       primarily as a hook for internal reading loops (queries, index
-    ///       build, etc.) It's essentially a workaround and will likely be
-    ///       removed from the API.
+    /// \note This method should not be needed in most client code. Cached
+    ///       values are already reset by any method that modifies the record.
+    ///       It's essentially a workaround and will likely be removed from the
+    ///       API.
+    ///
+    /// \warning Although const, this must not be called while other threads
+    ///          are accessing the same record.
     ///
     void ResetCachedPositions(void) const;
 
-    /// \brief Resets cached aligned start/end.
+    /// \brief Resets cached aligned start/end (and CIGAR-derived values, e.g.
+    ///        NumMatches).
     ///
-    /// \note This method should not be needed in most client code. It exists
-    ///       primarily as a hook for internal reading loops (queries, index
-    ///       build, etc.) It's essentially a workaround and will likely be
-    ///       removed from the API.
+    /// \note This method should not be needed in most client code. Cached
+    ///       values are already reset by any method that modifies the record.
+    ///       It's essentially a workaround and will likely be removed from the
+    ///       API.
     ///
     void ResetCachedPositions(void);
 
@@ -1200,42 +1399,91 @@ private:
     /// cached positions (mutable to allow lazy-calc in const methods)
     mutable Position alignedStart_;
     mutable Position alignedEnd_;
+    internal::CacheState alignedPositionsState_;
+
+    /// \internal
+    /// cached record type (reset whenever tags/name may have changed)
+    mutable RecordType recordType_;
+    internal::CacheState recordTypeState_;
+
+    /// \internal
+    /// cached CIGAR-derived alignment statistics, computed together in one
+    /// pass over the CIGAR (reset along with aligned positions)
+    struct AlignmentStats
+    {
+        size_t numMatches;
+        size_t numMismatches;
+        size_t numInsertedBases;  // aligned query span - matches - mismatches
+        size_t numDeletedBases;   // reference span - matches - mismatches
+        size_t referenceSpan;     // sum of reference-consuming op lengths
+        int32_t startOffset;      // aligned region within SEQ (-1 if invalid)
+        int32_t endOffset;        // .
+    };
+    mutable AlignmentStats alignmentStats_;
+    internal::CacheState alignmentStatsState_;
 
 private:
     /// \internal
-    std::vector<float> FetchPhotons(const std::string& tagName,
+    std::vector<float> FetchPhotons(const TagId& tagName,
                                     const Orientation orientation) const;
-    std::string FetchBasesRaw(const std::string& tagName) const;
+    void FetchPhotons(const TagId& tagName,
+                      std::vector<float>* photons,
+                      const Orientation orientation) const;
 
-    std::string FetchBases(const std::string& tagName,
+    std::string FetchBasesRaw(const TagId& tagName) const;
+    void FetchBasesRaw(const TagId& tagName, std::string* bases) const;
+
+    std::string FetchBases(const TagId& tagName,
                            const Orientation orientation) const;
 
-    std::string FetchBases(const std::string& tagName,
+    std::string FetchBases(const TagId& tagName,
                            const Orientation orientation,
                            const bool aligned,
                            const bool exciseSoftClips) const;
 
-    Frames FetchFramesRaw(const std::string& tagName) const;
+    void FetchBases(const TagId& tagName,
+                    std::string* bases,
+                    const Orientation orientation,
+                    const bool aligned,
+                    const bool exciseSoftClips) const;
+
+    Frames FetchFramesRaw(const TagId& tagName) const;
 
-    Frames FetchFrames(const std::string& tagName,
+    Frames FetchFrames(const TagId& tagName,
                        const Orientation orientation) const;
 
-    Frames FetchFrames(const std::string& tagName,
+    Frames FetchFrames(const TagId& tagName,
                        const Orientation orientation,
                        const bool aligned,
                        const bool exciseSoftClips) const;
 
-    QualityValues FetchQualitiesRaw(const std::string& tagName) const;
+    void FetchFrames(const TagId& tagName,
+                     Frames* frames,
+                     const Orientation orientation,
+                     const bool aligned,
+                     const bool exciseSoftClips) const;
+
+    QualityValues FetchQualitiesRaw(const TagId& tagName) const;
+    void FetchQualitiesRaw(const TagId& tagName, QualityValues* quals) const;
 
-    QualityValues FetchQualities(const std::string& tagName,
+    QualityValues FetchQualities(const TagId& tagName,
                                  const Orientation orientation) const;
 
-    QualityValues FetchQualities(const std::string& tagName,
+    QualityValues FetchQualities(const TagId& tagName,
                                  const Orientation orientation,
                                  const bool aligned,
                                  const bool exciseSoftClips) const;
 
+    void FetchQualities(const TagId& tagName,
+                        QualityValues* quals,
+                        const Orientation orientation,
+                        const bool aligned,
+                        const bool exciseSoftClips) const;
+
     void ClipFields(const size_t clipPos, const size_t clipLength);
+    void ClipFields(const Cigar& cigar,
+                    const size_t clipPos,
+                    const size_t clipLength);
     BamRecord& ClipToQuery(const PacBio::BAM::Position start,
                            const PacBio::BAM::Position end);
     BamRecord& ClipToReference(const PacBio::BAM::Position start,
@@ -1249,6 +1497,11 @@ private:
     // marked const to allow calling from const methods
     // but updates our mutable cached values
     void CalculateAlignedPositions(void) const;
+    void CalculateAlignmentStats(void) const;
+
+    // copies other's cached values, but only those that are complete (other
+    // may be in concurrent const use)
+    void CopyCachedValues(const BamRecord& other);
 
     friend class internal::BamRecordMemory;
 };
@@ -102,6 +102,24 @@ public:
     /// \brief Replaces an existing BamRecord's data with current builder
     ///        attributes.
     ///
+    /// The exact size of the record's variable-length data (name, CIGAR,
+    /// SEQ, QUAL, & tags) is computed up front and each section is written
+    /// straight into \p record's existing buffer, which is only reallocated
+    /// if too small. So building many records through one builder & one
+    /// record does not allocate once the buffer has grown large enough:
+    ///
+    /// \code{.cpp}
+    ///
+    /// BamRecordBuilder builder(header);
+    /// BamRecord record(header);
+    /// for (...) {
+    ///     builder.Reset();
+    ///     builder.Name(...).Sequence(...).Qualities(...).Tags(...);
+    ///     builder.BuildInPlace(record);
+    ///     writer.Write(record);
+    /// }
+    /// \endcode
+    ///
     /// \param[out] record resulting record
     /// \returns true if successful
     ///
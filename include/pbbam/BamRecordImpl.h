@@ -43,13 +43,20 @@
 #define BAMRECORDIMPL_H
 
 #include "pbbam/Cigar.h"
+#include "pbbam/CigarView.h"
 #include "pbbam/Config.h"
+#include "pbbam/internal/CacheState.h"
 #include "pbbam/Position.h"
 #include "pbbam/QualityValues.h"
+#include "pbbam/TagBatch.h"
 #include "pbbam/TagCollection.h"
+#include "pbbam/TagId.h"
+#include "pbbam/TagView.h"
 #include <htslib/sam.h>
-#include <map>
+#include <atomic>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace PacBio {
 namespace BAM {
@@ -61,6 +68,13 @@ namespace internal { class BamRecordMemory; }
 ///
 /// For PacBio-specific extensions and convenience methods, see BamRecord.
 ///
+/// Copies are cheap: they share the original's (reference-counted) data, and
+/// a record only makes its own copy of the data on the first modifying call
+/// (copy-on-write). Records that share data may be read from different
+/// threads, as may a single record (const methods only, including the first
+/// tag lookup), but a record must not be modified while being accessed
+/// elsewhere.
+///
 /// \note This class is mostly an internal implementation detail and will
 ///       likely be removed from the public API in the future. Please use
 ///       BamRecord as much as possible.
@@ -92,9 +106,9 @@ public:
 
     BamRecordImpl(void);
     BamRecordImpl(const BamRecordImpl& other);
-    BamRecordImpl(BamRecordImpl&& other);
+    BamRecordImpl(BamRecordImpl&& other) noexcept;
     BamRecordImpl& operator=(const BamRecordImpl& other);
-    BamRecordImpl& operator=(BamRecordImpl&& other);
+    BamRecordImpl& operator=(BamRecordImpl&& other) noexcept;
     virtual ~BamRecordImpl(void);
 
     /// \}
@@ -284,7 +298,13 @@ public:
     ///
     BamRecordImpl& CigarData(const std::string& cigarString);
 
-    // TODO: CIGAR iterator - Cigar only or here as well ??
+    /// \brief Fetches a read-only view of the record's CIGAR operations,
+    ///        without copying them into a Cigar.
+    ///
+    /// \note The view is only valid while this record is alive and its
+    ///       variable-length data is unmodified.
+    ///
+    CigarView CigarDataView(void) const;
 
     /// \returns the record's query name
     std::string Name(void) const;
@@ -304,6 +324,17 @@ public:
     ///
     QualityValues Qualities(void) const;
 
+    /// \brief Fetches a read-only view of the record's numeric quality values
+    ///        (BAM QUAL data), without copying them.
+    ///
+    /// \returns TagView (TagDataType::UINT8_ARRAY) over QUAL. If the record
+    ///          has no quality values, a null view is returned.
+    ///
+    /// \note The view is only valid while this record is alive and its
+    ///       variable-length data is unmodified.
+    ///
+    TagView QualitiesView(void) const;
+
     /// \returns the record's DNA sequence.
     std::string Sequence(void) const;
 
@@ -378,6 +409,45 @@ public:
                                                      const size_t rawSequenceLength,
                                                      const char* qualities = 0);
 
+    /// \brief Clips SEQ, QUAL, & per-base tags to a window of \p length
+    ///        bases, in place.
+    ///
+    /// SEQ & QUAL keep bases [\p seqPosition, \p seqPosition + \p length),
+    /// in their stored orientation. Each of \p perBaseTags present as a
+    /// string or array tag keeps elements [\p tagPosition,
+    /// \p tagPosition + \p length). Windows are truncated at the end of the
+    /// data. All other tags are kept as-is.
+    ///
+    /// The raw bytes are sliced without decoding (e.g. lossy frame codes stay
+    /// codes), and the record's data is compacted in a single pass, without
+    /// reallocating.
+    ///
+    /// \param[in] seqPosition  first base kept in SEQ & QUAL
+    /// \param[in] tagPosition  first element kept in per-base tags
+    /// \param[in] length       number of bases to keep
+    /// \param[in] perBaseTags  tags to clip
+    /// \returns reference to this record
+    ///
+    BamRecordImpl& ClipSequenceAndTags(const size_t seqPosition,
+                                       const size_t tagPosition,
+                                       const size_t length,
+                                       const std::vector<TagId>& perBaseTags);
+
+    /// \brief Replaces CIGAR data, then clips SEQ, QUAL, & per-base tags to a
+    ///        window of \p length bases, in place.
+    ///
+    /// This is an overloaded method, for clipping aligned records. Since
+    /// \p cigar is written in the same pass, it should have no more
+    /// operations than the current CIGAR data (as is the case when clipping).
+    ///
+    /// \returns reference to this record
+    ///
+    BamRecordImpl& ClipSequenceAndTags(const Cigar& cigar,
+                                       const size_t seqPosition,
+                                       const size_t tagPosition,
+                                       const size_t length,
+                                       const std::vector<TagId>& perBaseTags);
+
     /// \}
 
 public:
@@ -432,6 +502,17 @@ public:
                 const Tag& value,
                 const TagModifier additionalModifier);
 
+    /// \brief Adds a new tag to this record.
+    ///
+    /// This is an overloaded method, taking a TagId instead of a tag name
+    /// string.
+    ///
+    /// \returns true if tag was successfully added.
+    ///
+    bool AddTag(const TagId& tagId,
+                const Tag& value,
+                const TagModifier additionalModifier = TagModifier::NONE);
+
     /// \brief Edits an existing tag on this record.
     ///
     /// \param[in] tagName      2-character tag name. Name must be present
@@ -475,9 +556,40 @@ public:
                  const Tag& value,
                  const TagModifier additionalModifier);
 
+    /// \brief Edits an existing tag on this record.
+    ///
+    /// This is an overloaded method, taking a TagId instead of a tag name
+    /// string.
+    ///
+    /// \returns true if tag was successfully edited.
+    ///
+    bool EditTag(const TagId& tagId,
+                 const Tag& newValue,
+                 const TagModifier additionalModifier = TagModifier::NONE);
+
+    /// \brief Applies a batch of tag changes to this record, in one pass.
+    ///
+    /// Tags set in the batch are added, or overwrite existing values (as
+    /// with EditTag, an overwritten tag moves to the end of the tag data).
+    /// Tags removed in the batch are dropped, if present. Other tags are
+    /// unchanged.
+    ///
+    /// Unlike a series of AddTag/EditTag/RemoveTag calls, the record's data
+    /// is resized at most once, and existing tags are shifted at most once.
+    ///
+    /// \param[in] batch    tag changes to apply
+    /// \returns reference to this record
+    ///
+    /// \sa TagBatch
+    ///
+    BamRecordImpl& EditTags(const TagBatch& batch);
+
     /// \returns true if a tag with this name is present in this record.
     bool HasTag(const std::string& tagName) const;
 
+    /// \returns true if a tag with this ID is present in this record.
+    bool HasTag(const TagId& tagId) const;
+
     /// \brief Removes an existing tag from this record.
     ///
     /// \param[in] tagName  2-character tag name.
@@ -488,6 +600,15 @@ public:
     ///
     bool RemoveTag(const std::string& tagName);
 
+    /// \brief Removes an existing tag from this record.
+    ///
+    /// This is an overloaded method, taking a TagId instead of a tag name
+    /// string.
+    ///
+    /// \returns true if tag was actually removed
+    ///
+    bool RemoveTag(const TagId& tagId);
+
     /// \brief Fetches a tag from this record.
     ///
     /// \param[in] tagName  2-character tag name.
@@ -497,6 +618,37 @@ public:
     ///
     Tag TagValue(const std::string& tagName) const;
 
+    /// \brief Fetches a tag from this record.
+    ///
+    /// This is an overloaded method, taking a TagId instead of a tag name
+    /// string.
+    ///
+    /// \returns Tag object for the requested ID, or a null Tag if not found.
+    ///
+    Tag TagValue(const TagId& tagId) const;
+
+    /// \brief Fetches a read-only view of a tag's value, without copying it.
+    ///
+    /// \param[in] tagName  2-character tag name.
+    ///
+    /// \returns TagView over this record's raw tag data. If name is unknown, a
+    ///          null view is returned (TagView::IsNull() is true).
+    ///
+    /// \note The view is only valid while this record is alive and its
+    ///       variable-length data is unmodified.
+    ///
+    TagView TagValueView(const std::string& tagName) const;
+
+    /// \brief Fetches a read-only view of a tag's value, without copying it.
+    ///
+    /// This is an overloaded method, taking a TagId instead of a tag name
+    /// string.
+    ///
+    /// \returns TagView over this record's raw tag data, or a null view if
+    ///          not found.
+    ///
+    TagView TagValueView(const TagId& tagId) const;
+
     // change above to Tag();
 
 //    template<typename T>
@@ -512,15 +664,36 @@ private:
     // internal memory setup/expand methods
     void InitializeData(void);
     void MaybeReallocData(void);
-    void UpdateTagMap(void) const; // allowed to be called from const methods
-                                   // (lazy update on request)
+
+    // Copy-on-write: copies share d_ until one of them is modified. Every
+    // modifying method calls DetachData() first, which duplicates the data if
+    // it is still shared. DetachDataForOverwrite() is for callers that replace
+    // the entire record (e.g. reading the next record into it), so shared
+    // contents are not worth duplicating.
+    void DetachData(void);
+    void DetachDataForOverwrite(void);
+    void DuplicateData(void);
+
+    // Tag offsets are only scanned on first tag lookup after a change to the
+    // record's tag data. Invalidating is cheap, so it's done on every load or
+    // tag edit, without touching the tag data itself.
+    void BuildTagMap(void) const;      // allowed to be called from const methods
+    void InvalidateTagMap(void) const; // (lazy update on request)
 
     // internal tag helper methods
-    bool AddTagImpl(const std::string& tagName,
+    bool AddTagImpl(const TagId& tagId,
                     const Tag& value,
                     const TagModifier additionalModifier);
-    bool RemoveTagImpl(const std::string& tagName);
-    int TagOffset(const std::string& tagName) const;
+    bool RemoveTagImpl(const TagId& tagId);
+    int TagOffset(const TagId& tagId) const;
+
+    // clip logic shared by ClipSequenceAndTags() overloads (null cigar keeps
+    // current CIGAR data)
+    BamRecordImpl& ClipSequenceAndTagsImpl(const Cigar* cigar,
+                                           const size_t seqPosition,
+                                           const size_t tagPosition,
+                                           const size_t length,
+                                           const std::vector<TagId>& perBaseTags);
 
     // core seq/qual logic shared by the public API
     BamRecordImpl& SetSequenceAndQualitiesInternal(const char* sequence,
@@ -532,7 +705,17 @@ private:
 
     // data members
     PBBAM_SHARED_PTR<bam1_t> d_;
-    mutable std::map<uint16_t, int> tagOffsets_;
+
+    // (tag name code, offset into tag data), in record order. A linear scan
+    // over these few entries beats a node-based map, and its storage is
+    // reused from record to record. Built at most once per change, even when
+    // first queried from several threads at once.
+    mutable std::vector<std::pair<uint16_t, int> > tagOffsets_;
+    internal::CacheState tagMapState_;
+
+    // number of shared record buffers duplicated on modification, across all
+    // instances (lets tests verify that copies & moves do not deep-copy)
+    static std::atomic<uint64_t> numDeepCopies_;
 
     // friends
     friend class internal::BamRecordMemory;
@@ -0,0 +1,152 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file BamRecordPool.h
+/// \brief Defines the BamRecordPool class.
+//
+// Author: Derek Barnett
+
+#ifndef BAMRECORDPOOL_H
+#define BAMRECORDPOOL_H
+
+#include "pbbam/BamRecord.h"
+#include "pbbam/Config.h"
+#include <vector>
+#include <cstddef>
+
+namespace PacBio {
+namespace BAM {
+
+/// \brief The BamRecordPool class recycles BamRecord objects (and their
+///        underlying %BAM data buffers) between reads.
+///
+/// A new BamRecord allocates its data buffer on construction, and readers
+/// grow that buffer as needed to fit each record read into it. Records drawn
+/// from a pool, filled by a reader's GetNext(), then released back to the pool
+/// keep their buffers at the size they have already grown to. So, once warmed
+/// up, reading into pooled records does not allocate per record.
+///
+/// Group queries (e.g. QNameQuery, ZmwGroupQuery) use a pool internally: the
+/// records in the vector passed to GetNext() are recycled, rather than
+/// destroyed, when the vector is refilled with the next group.
+///
+/// \code{.cpp}
+///
+/// BamRecordPool pool;
+/// BamReader reader(fn);
+/// BamRecord record = pool.Acquire();
+/// while (reader.GetNext(record)) {
+///     // ... use record, or move it elsewhere & acquire a replacement
+/// }
+/// pool.Release(std::move(record));
+///
+/// \endcode
+///
+/// \note The contents of an acquired record are unspecified (it may hold a
+///       previously released record's data). It is intended to be overwritten,
+///       e.g. by a reader's GetNext().
+///
+/// \note BamRecordPool is not thread-safe. Use one pool per thread/query.
+///
+class PBBAM_EXPORT BamRecordPool
+{
+public:
+    /// \name Constructors & Related Methods
+    /// \{
+
+    /// \brief Creates an empty pool.
+    ///
+    /// \param[in] maxSize  maximum number of records kept for reuse, extra
+    ///                     released records are destroyed
+    ///
+    explicit BamRecordPool(const size_t maxSize = 256);
+
+    BamRecordPool(const BamRecordPool&) = delete;
+    BamRecordPool& operator=(const BamRecordPool&) = delete;
+    ~BamRecordPool(void);
+
+    /// \}
+
+public:
+    /// \name Pool Operations
+    /// \{
+
+    /// \returns a recycled record if available, otherwise a new record
+    BamRecord Acquire(void);
+
+    /// \brief Returns a record to the pool for later reuse.
+    ///
+    /// Moved-from records (with no data buffer) are discarded, as are records
+    /// whose buffer is still shared with a copy (it could not be reused
+    /// without detaching anyway) and records released while the pool is full.
+    ///
+    /// \param[in] record   record to recycle
+    ///
+    void Release(BamRecord&& record);
+
+    /// \brief Returns all records in a container to the pool, leaving the
+    ///        container empty (but with its capacity intact).
+    ///
+    /// \param[in,out] records  records to recycle
+    ///
+    void Release(std::vector<BamRecord>& records);
+
+    /// \brief Destroys all pooled records.
+    void Clear(void);
+
+    /// \}
+
+public:
+    /// \name Attributes
+    /// \{
+
+    /// \returns maximum number of records kept for reuse
+    size_t MaxSize(void) const;
+
+    /// \returns number of records currently available for reuse
+    size_t Size(void) const;
+
+    /// \}
+
+private:
+    std::vector<BamRecord> records_;
+    size_t maxSize_;
+};
+
+} // namespace BAM
+} // namespace PacBio
+
+#endif // BAMRECORDPOOL_H
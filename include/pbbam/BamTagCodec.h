@@ -45,6 +45,8 @@
 #include "pbbam/Config.h"
 #include "pbbam/TagCollection.h"
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 
 namespace PacBio {
 namespace BAM {
@@ -75,6 +77,24 @@ public:
     ///
     static std::vector<uint8_t> Encode(const PacBio::BAM::TagCollection& tags);
 
+    /// \brief Encodes a TagCollection directly into pre-allocated memory.
+    ///
+    /// \param[in]  tags    TagCollection containing tag data
+    /// \param[out] out     destination, must hold at least EncodedSize(tags)
+    ///                     bytes
+    /// \returns number of bytes written (0 if \p tags could not be encoded)
+    ///
+    static size_t Encode(const PacBio::BAM::TagCollection& tags, uint8_t* out);
+
+    /// \brief Determines the size of a TagCollection's binary BAM data,
+    ///        without encoding it.
+    ///
+    /// \param[in] tags     TagCollection containing tag data
+    /// \returns number of bytes needed to encode \p tags (0 if they could not
+    ///          be encoded)
+    ///
+    static size_t EncodedSize(const PacBio::BAM::TagCollection& tags);
+
     /// \}
 
 public:
@@ -116,6 +136,11 @@ public:
     static PacBio::BAM::Tag FromRawData(uint8_t* rawData);
 
     /// \}
+
+private:
+    // writes (or only counts) encoded tags, for Encode & EncodedSize
+    template<typename Sink>
+    static bool EncodeTags(const PacBio::BAM::TagCollection& tags, Sink& sink);
 };
 
 } // namespace BAM
@@ -117,6 +117,28 @@ public:
       , BinCalculation_OFF
     };
 
+    /// \brief This enum allows you to request index files to be generated
+    ///        alongside the output %BAM file.
+    ///
+    /// Indices requested this way are built on the fly, from the same virtual
+    /// offsets captured while writing records, avoiding the extra full passes
+    /// over the output file made by BamFile::CreatePacBioIndex() &
+    /// BamFile::CreateStandardIndex().
+    ///
+    /// \note A standard (BAI) index requires that records be written in
+    ///       coordinate-sorted order.
+    ///
+    enum IndexType
+    {
+        NoIndex       = 0x0000  ///< no index files generated
+      , PacBioIndex   = 0x0001  ///< generate "<filename>.pbi"
+      , StandardIndex = 0x0002  ///< generate "<filename>.bai"
+    };
+
+    /// \brief Helper typedef for storing multiple IndexType flags.
+    ///
+    typedef uint16_t IndexTypes;
+
 public:
 
     /// \name Constructors & Related Methods
@@ -142,6 +164,12 @@ public:
     ///            records written. This extra step may turned off when bin
     ///            numbers are not needed. Though if in doubt, keep the default.
     ///
+    /// \param[in] indexTypes index files (IndexType flags) to generate on the
+    ///            fly while writing. Index files are written when the BamWriter
+    ///            is destroyed. Not available when writing to stdout. An
+    ///            index that cannot be completed (e.g. unsorted records for
+    ///            BAI) is not written.
+    ///
     /// \throws std::runtmie_error if there was a problem opening the file for
     ///         writing or if an error occurred while writing the header
     ///
@@ -149,9 +177,11 @@ public:
               const BamHeader& header,
               const BamWriter::CompressionLevel compressionLevel = BamWriter::DefaultCompression,
               const size_t numThreads = 4,
-              const BinCalculationMode binCalculationMode = BamWriter::BinCalculation_ON);
+              const BinCalculationMode binCalculationMode = BamWriter::BinCalculation_ON,
+              const IndexTypes indexTypes = BamWriter::NoIndex);
 
-    /// Fully flushes all buffered data & closes file.
+    /// Fully flushes all buffered data, closes file, & writes any requested
+    /// index files.
     ~BamWriter(void);
 
     /// \}
@@ -175,7 +205,8 @@ public:
     ///
     /// \param[in] record BamRecord object
     ///
-    /// \throws std::runtime_error on failure to write
+    /// \throws std::runtime_error on failure to write, or if a BAI index was
+    ///         requested & records are not in coordinate-sorted order
     ///
     void Write(const BamRecord& record);
 
@@ -184,7 +215,8 @@ public:
     /// \param[in] record BamRecord object
     /// \param[out] vOffset BGZF virtual offset to start of \p record
     ///
-    /// \throws std::runtime_error on failure to write
+    /// \throws std::runtime_error on failure to write, or if a BAI index was
+    ///         requested & records are not in coordinate-sorted order
     ///
     void Write(const BamRecord& record, int64_t* vOffset);
 
@@ -192,7 +224,8 @@ public:
     ///
     /// \param[in] recordImpl BamRecordImpl object
     ///
-    /// \throws std::runtime_error on failure to write
+    /// \throws std::runtime_error on failure to write, or if a BAI index was
+    ///         requested & records are not in coordinate-sorted order
     ///
     void Write(const BamRecordImpl& recordImpl);
 
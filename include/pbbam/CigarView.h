@@ -0,0 +1,189 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file CigarView.h
+/// \brief Defines the CigarView class.
+//
+// Author: Derek Barnett
+
+#ifndef CIGARVIEW_H
+#define CIGARVIEW_H
+
+#include "pbbam/Cigar.h"
+#include "pbbam/CigarOperation.h"
+#include "pbbam/Config.h"
+#include <iterator>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace PacBio {
+namespace BAM {
+
+/// \brief The CigarView class provides read-only, non-owning access to a
+///        record's CIGAR operations, directly over its packed BAM data.
+///
+/// Unlike Cigar (returned by BamRecordImpl::CigarData), a CigarView does not
+/// allocate or convert anything up front. Operations are decoded one at a
+/// time, as they are visited:
+///
+/// \code{.cpp}
+///
+/// size_t numInserted = 0;
+/// for (const CigarOperation& op : record.Impl().CigarDataView()) {
+///     if (op.Type() == CigarOperationType::INSERTION)
+///         numInserted += op.Length();
+/// }
+///
+/// \endcode
+///
+/// A CigarView is valid only as long as the record it was obtained from is
+/// alive and its variable-length data (CIGAR, sequence, tags, etc.) is
+/// unmodified.
+///
+/// \sa BamRecordImpl::CigarDataView
+///
+class PBBAM_EXPORT CigarView
+{
+public:
+    /// \brief Read-only, forward iterator over a CigarView's operations.
+    ///
+    /// Dereferencing yields each CigarOperation by value.
+    ///
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef CigarOperation            value_type;
+        typedef std::ptrdiff_t            difference_type;
+        typedef const CigarOperation*     pointer;
+        typedef CigarOperation            reference;
+
+    public:
+        const_iterator(void);
+        explicit const_iterator(const uint32_t* op);
+
+    public:
+        CigarOperation operator*(void) const;
+        const_iterator& operator++(void);
+        const_iterator operator++(int);
+        bool operator==(const const_iterator& other) const;
+        bool operator!=(const const_iterator& other) const;
+
+    private:
+        const uint32_t* op_;
+    };
+
+public:
+    /// \name Constructors & Related Methods
+    /// \{
+
+    /// \brief Creates an empty view.
+    CigarView(void);
+
+    /// \brief Creates a view over packed (BAM) CIGAR data.
+    ///
+    /// \param[in] data    first packed operation (length << 4 | type)
+    /// \param[in] numOps  number of operations
+    ///
+    CigarView(const uint32_t* data, const size_t numOps);
+
+    CigarView(const CigarView& other) = default;
+    CigarView& operator=(const CigarView& other) = default;
+    ~CigarView(void) = default;
+
+    /// \}
+
+public:
+    /// \name Iterators
+    /// \{
+
+    const_iterator begin(void) const;
+    const_iterator end(void) const;
+
+    /// \}
+
+public:
+    /// \name Data Access
+    /// \{
+
+    /// \returns number of CIGAR operations
+    size_t Size(void) const;
+
+    /// \returns true if view contains no operations
+    bool IsEmpty(void) const;
+
+    /// \returns operation at index \p i (not bounds-checked)
+    CigarOperation operator[](const size_t i) const;
+
+    /// \returns type of the operation at index \p i (not bounds-checked)
+    CigarOperationType Type(const size_t i) const;
+
+    /// \returns length of the operation at index \p i (not bounds-checked)
+    uint32_t Length(const size_t i) const;
+
+    /// \returns pointer to the packed operations
+    const uint32_t* RawData(void) const;
+
+    /// \}
+
+public:
+    /// \name Conversion Methods
+    /// \{
+
+    /// \returns full, owning Cigar object with the same operations
+    ///
+    /// \throws std::runtime_error if the view contains an ALIGNMENT_MATCH
+    ///         ('M') operation, as with BamRecordImpl::CigarData
+    ///
+    Cigar ToCigar(void) const;
+
+    /// \returns SAM/BAM formatted CIGAR string
+    std::string ToStdString(void) const;
+
+    /// \}
+
+private:
+    const uint32_t* data_;
+    size_t numOps_;
+};
+
+} // namespace BAM
+} // namespace PacBio
+
+#include "pbbam/internal/CigarView.inl"
+
+#endif // CIGARVIEW_H
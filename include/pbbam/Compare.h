@@ -262,7 +262,7 @@ public:
     /// \note Currently only supports std::less<T> comparisons (i.e. sorting by
     ///       ascending value).
     ///
-    struct MovieName : public MemberFunctionBase<std::string, &BamRecord::MovieName> { };
+    struct MovieName : public MemberFunctionBase<const std::string&, &BamRecord::MovieName, std::less<std::string> > { };
 
     /// \brief Provides an operator() is essentially a no-op for
     ///        comparing/sorting.
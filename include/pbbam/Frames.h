@@ -73,6 +73,46 @@ public:
     ///
     static Frames Decode(const std::vector<uint8_t>& codedData);
 
+    /// \brief Constructs a Frames object from encoded (lossy, 8-bit) data.
+    ///
+    /// This is an overloaded method, reading codes directly from a raw buffer
+    /// (e.g. a TagView over a record's tag data).
+    ///
+    /// \param[in] codedData    pointer to encoded data
+    /// \param[in] length       number of codes
+    /// \returns Frames object
+    ///
+    static Frames Decode(const uint8_t* codedData, const size_t length);
+
+    /// \brief Decodes encoded (lossy, 8-bit) data into an existing Frames
+    ///        object.
+    ///
+    /// This is an overloaded method, reusing \p frames' storage instead of
+    /// returning a new object.
+    ///
+    /// \param[in]  codedData   pointer to encoded data
+    /// \param[in]  length      number of codes
+    /// \param[out] frames      decoded frame data
+    ///
+    static void Decode(const uint8_t* codedData,
+                       const size_t length,
+                       Frames* frames);
+
+    /// \brief Decodes encoded (lossy, 8-bit) data into a caller-provided
+    ///        buffer.
+    ///
+    /// This is an overloaded method, for filling larger arrays (e.g.
+    /// PerBaseColumns) without an intermediate Frames object.
+    ///
+    /// \param[in]  codedData   pointer to encoded data
+    /// \param[in]  length      number of codes
+    /// \param[out] frames      decoded frame data, with room for at least
+    ///                         \p length values
+    ///
+    static void Decode(const uint8_t* codedData,
+                       const size_t length,
+                       uint16_t* frames);
+
     /// \brief Creates encoded, compressed frame data from raw input data.
     ///
     /// \param[in] frames   raw frame data
@@ -0,0 +1,182 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file OrderedBamWriter.h
+/// \brief Defines the OrderedBamWriter class.
+//
+// Author: Derek Barnett
+
+#ifndef ORDEREDBAMWRITER_H
+#define ORDEREDBAMWRITER_H
+
+#include "pbbam/BamHeader.h"
+#include "pbbam/BamRecord.h"
+#include "pbbam/BamWriter.h"
+#include "pbbam/Config.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace PacBio {
+namespace BAM {
+
+namespace internal { class OrderedBamWriterPrivate; }
+
+/// \brief The OrderedBamWriter class provides a thread-safe writing interface
+///        for parallel producers, with deterministic output order.
+///
+/// Each Write() call supplies a sequence number along with the record(s)
+/// produced for it (e.g. all records for a ZMW). Sequence numbers start at 0
+/// & must be unique and contiguous. Producers may call Write() from any
+/// thread, in any order. Records are written in sequence number order, in
+/// the order given within each call.
+///
+/// Out-of-order submissions are held in a bounded window. A producer that
+/// gets more than the window size ahead of the oldest missing sequence number
+/// waits until that gap is filled. Use an empty record list to mark a
+/// sequence number that produced no records.
+///
+/// A background thread feeds the reordered records to a BamWriter. Encoding,
+/// compression, & index generation (including PBI offsets, captured in the
+/// final output order) all happen on that thread, outside of any lock
+/// shared with producers.
+///
+/// Errors raised on the background thread are stored and rethrown from the
+/// next call to Write or Close.
+///
+/// \note As with BamWriter, the output file is not complete until Close is
+///       called (or the writer is destroyed). Prefer calling Close
+///       explicitly, as errors from the destructor cannot be reported.
+///
+class PBBAM_EXPORT OrderedBamWriter
+{
+public:
+    /// \name Constructors & Related Methods
+    /// \{
+
+    /// \brief Opens a %BAM file for writing, writes the header information,
+    ///        & starts the background writing thread.
+    ///
+    /// \note Set \p filename to "-" for stdout.
+    ///
+    /// \param[in] filename         path to output %BAM file
+    /// \param[in] header           BamHeader object
+    /// \param[in] windowSize       maximum number of sequence numbers held for
+    ///                             reordering
+    /// \param[in] compressionLevel zlib compression level
+    /// \param[in] numThreads       number of threads for compression (see
+    ///                             BamWriter)
+    /// \param[in] binCalculationMode BAI bin calculation mode (see BamWriter)
+    /// \param[in] indexTypes       index files to generate on the fly (see
+    ///                             BamWriter::IndexType)
+    ///
+    /// \throws std::runtime_error if there was a problem opening the file for
+    ///         writing or if an error occurred while writing the header
+    ///
+    OrderedBamWriter(const std::string& filename,
+                     const BamHeader& header,
+                     const size_t windowSize = 1024,
+                     const BamWriter::CompressionLevel compressionLevel = BamWriter::DefaultCompression,
+                     const size_t numThreads = 4,
+                     const BamWriter::BinCalculationMode binCalculationMode = BamWriter::BinCalculation_ON,
+                     const BamWriter::IndexTypes indexTypes = BamWriter::NoIndex);
+
+    /// \brief Finishes writing (if Close has not been called).
+    ///
+    /// Any errors are swallowed here, leaving no output file. Call Close to
+    /// observe them.
+    ///
+    ~OrderedBamWriter(void);
+
+    /// \}
+
+public:
+    /// \name Data Writing & Resource Management
+    /// \{
+
+    /// \brief Submits a copy of \p record for \p sequenceNumber.
+    ///
+    /// \throws std::runtime_error if writer has been closed, if
+    ///         \p sequenceNumber has already been submitted, or rethrows any
+    ///         error from the background thread
+    ///
+    void Write(const uint64_t sequenceNumber, const BamRecord& record);
+
+    /// \brief Submits \p record for \p sequenceNumber, taking ownership of its
+    ///        data.
+    ///
+    /// \throws std::runtime_error if writer has been closed, if
+    ///         \p sequenceNumber has already been submitted, or rethrows any
+    ///         error from the background thread
+    ///
+    void Write(const uint64_t sequenceNumber, BamRecord&& record);
+
+    /// \brief Submits all \p records for \p sequenceNumber, taking ownership
+    ///        of their data.
+    ///
+    /// \param[in] sequenceNumber   submission's position in output order
+    /// \param[in] records          records to write, in order. May be empty.
+    ///
+    /// \throws std::runtime_error if writer has been closed, if
+    ///         \p sequenceNumber has already been submitted, or rethrows any
+    ///         error from the background thread
+    ///
+    void Write(const uint64_t sequenceNumber, std::vector<BamRecord>&& records);
+
+    /// \brief Waits for all submitted records to be written, stops the
+    ///        background thread, & closes the file (writing any requested
+    ///        index files).
+    ///
+    /// No further records may be written after this call.
+    ///
+    /// \throws std::runtime_error if any sequence number below the highest
+    ///         one submitted is missing, or rethrows any error from the
+    ///         background thread
+    ///
+    void Close(void);
+
+    /// \}
+
+private:
+    std::unique_ptr<internal::OrderedBamWriterPrivate> d_;
+    DISABLE_MOVE_AND_COPY(OrderedBamWriter);
+};
+
+} // namespace BAM
+} // namespace PacBio
+
+#endif // ORDEREDBAMWRITER_H
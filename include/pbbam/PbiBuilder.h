@@ -193,6 +193,26 @@ public:
     ///
     void AddRecord(const BamRecord& record, const int64_t vOffset);
 
+    /// \brief Adds a row copied from existing index data.
+    ///
+    /// This allows PBI data to be collated from source indices (e.g. when
+    /// merging %BAM files), without re-extracting values from each record.
+    /// Only the file offset is replaced.
+    ///
+    /// Rows from an index without MappedData (or BarcodeData) are stored as
+    /// unmapped (or without barcodes).
+    ///
+    /// \param[in] index    source index data
+    /// \param[in] row      record number in \p index
+    /// \param[in] vOffset  \b virtual offset into the \b new %BAM file where
+    ///                     record begins
+    ///
+    /// \throws std::out_of_range if \p row is not valid for \p index
+    ///
+    void AddRow(const PbiRawData& index,
+                const uint32_t row,
+                const int64_t vOffset);
+
     /// \returns const reference to current raw index data. Mostly only used for
     ///          testing; shouldn't be needed by most client code.
     ///
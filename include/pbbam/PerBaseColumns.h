@@ -0,0 +1,229 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file PerBaseColumns.h
+/// \brief Defines the PerBaseField enum & PerBaseColumns class.
+//
+// Author: Derek Barnett
+
+#ifndef PERBASECOLUMNS_H
+#define PERBASECOLUMNS_H
+
+#include "pbbam/BamRecord.h"
+#include "pbbam/Config.h"
+#include "pbbam/Orientation.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace PacBio {
+namespace BAM {
+
+/// \brief Per-base record fields that can be extracted into PerBaseColumns.
+///
+enum class PerBaseField
+{
+    IPD              ///< interpulse duration, in frames ('ip' tag)
+  , PULSE_WIDTH      ///< pulse width, in frames ('pw' tag)
+  , DELETION_QV      ///< deletion QVs ('dq' tag)
+  , INSERTION_QV     ///< insertion QVs ('iq' tag)
+  , MERGE_QV         ///< merge QVs ('mq' tag)
+  , SUBSTITUTION_QV  ///< substitution QVs ('sq' tag)
+  , QUALITIES        ///< base qualities (BAM QUAL)
+};
+
+/// \brief The PerBaseColumns class extracts per-base kinetics & QV data from
+///        many records into contiguous, columnar buffers.
+///
+/// Each requested field is stored as one flat array of values for all
+/// records (frame counts as uint16_t, QVs as numeric uint8_t), plus an
+/// offsets array: record i's values for that field are in
+/// [Offsets(field)[i], Offsets(field)[i+1]). Lossy (8-bit) frame codes are
+/// decoded, and FASTQ-encoded QVs converted, straight into these buffers -
+/// no Frames or QualityValues objects are created per record.
+///
+/// Records are processed on several threads: one pass sizes each record's
+/// fields, then each thread fills its own records' (disjoint) slices of the
+/// buffers.
+///
+/// \code{.cpp}
+///
+/// PerBaseColumns columns({ PerBaseField::IPD, PerBaseField::PULSE_WIDTH });
+/// EntireFileQuery query(dataset);
+/// columns.AppendQuery(query);
+///
+/// const std::vector<uint16_t>& ipd = columns.FrameData(PerBaseField::IPD);
+/// const std::vector<size_t>& offsets = columns.Offsets(PerBaseField::IPD);
+/// for (size_t i = 0; i < columns.NumRecords(); ++i) {
+///     const uint16_t* recordIpd = ipd.data() + offsets[i];
+///     const size_t numBases = offsets[i+1] - offsets[i];
+///     // ...
+/// }
+///
+/// \endcode
+///
+/// Buffers keep their capacity across Clear(), so a PerBaseColumns object
+/// can be refilled, batch after batch, without reallocating.
+///
+/// \note A field missing from a record contributes no values for it (an
+///       empty range). Fields from one record may therefore differ in length.
+///
+class PBBAM_EXPORT PerBaseColumns
+{
+public:
+    /// \name Constructors & Related Methods
+    /// \{
+
+    /// \brief Creates an empty set of columns.
+    ///
+    /// \param[in] fields       per-base fields to extract
+    /// \param[in] orientation  orientation of extracted data (reverse-strand
+    ///                         records' data is reversed as needed, as with
+    ///                         BamRecord::IPD, BamRecord::Qualities, etc.)
+    /// \param[in] numThreads   maximum number of threads used to fill the
+    ///                         columns (0 to use the number of hardware
+    ///                         threads)
+    ///
+    /// \throws std::runtime_error if \p fields is empty or lists a field more
+    ///         than once
+    ///
+    PerBaseColumns(const std::vector<PerBaseField>& fields,
+                   const Orientation orientation = Orientation::NATIVE,
+                   const size_t numThreads = 0);
+
+    PerBaseColumns(const PerBaseColumns& other) = default;
+    PerBaseColumns(PerBaseColumns&& other) = default;
+    PerBaseColumns& operator=(const PerBaseColumns& other) = default;
+    PerBaseColumns& operator=(PerBaseColumns&& other) = default;
+    ~PerBaseColumns(void) = default;
+
+    /// \}
+
+public:
+    /// \name Filling
+    /// \{
+
+    /// \brief Appends data from a range of records.
+    ///
+    /// \param[in] records     pointer to first record
+    /// \param[in] numRecords  number of records
+    ///
+    /// \throws std::runtime_error if a record's tag data has an unexpected
+    ///         type (e.g. a float array for IPD). Columns are left unchanged
+    ///         in that case.
+    ///
+    void Append(const BamRecord* records, const size_t numRecords);
+
+    /// \brief Appends data from a vector of records.
+    void Append(const std::vector<BamRecord>& records);
+
+    /// \brief Appends data from all records returned by a query (or any
+    ///        other range of BamRecords), in batches of \p batchSize.
+    ///
+    /// \returns number of records appended
+    ///
+    template<typename QueryType>
+    size_t AppendQuery(QueryType& query, const size_t batchSize = 10000);
+
+    /// \brief Removes all records' data, keeping allocated storage.
+    void Clear(void);
+
+    /// \}
+
+public:
+    /// \name Data Access
+    /// \{
+
+    /// \returns fields extracted, in requested order
+    const std::vector<PerBaseField>& Fields(void) const;
+
+    /// \returns true if \p field is extracted
+    bool HasField(const PerBaseField field) const;
+
+    /// \returns number of records appended
+    size_t NumRecords(void) const;
+
+    /// \returns value offsets (NumRecords() + 1 entries) for \p field
+    ///
+    /// \throws std::runtime_error if \p field was not requested
+    ///
+    const std::vector<size_t>& Offsets(const PerBaseField field) const;
+
+    /// \returns all records' frame counts for \p field (IPD or PULSE_WIDTH)
+    ///
+    /// \throws std::runtime_error if \p field was not requested or is not a
+    ///         frame field
+    ///
+    const std::vector<uint16_t>& FrameData(const PerBaseField field) const;
+
+    /// \returns all records' numeric QVs for \p field (a QV field or
+    ///          QUALITIES)
+    ///
+    /// \throws std::runtime_error if \p field was not requested or is not a
+    ///         QV field
+    ///
+    const std::vector<uint8_t>& QualityData(const PerBaseField field) const;
+
+    /// \}
+
+private:
+    struct Column
+    {
+        PerBaseField field;
+        bool isFrames;
+        std::vector<size_t> offsets;
+        std::vector<uint16_t> frames;
+        std::vector<uint8_t> quals;
+    };
+
+    const Column& ColumnFor(const PerBaseField field) const;
+
+private:
+    std::vector<PerBaseField> fields_;
+    Orientation orientation_;
+    size_t numThreads_;
+    std::vector<Column> columns_;
+
+    // per-record value counts, (record, column) order (reused between calls)
+    std::vector<size_t> lengths_;
+};
+
+} // namespace BAM
+} // namespace PacBio
+
+#include "pbbam/internal/PerBaseColumns.inl"
+
+#endif // PERBASECOLUMNS_H
@@ -86,8 +86,9 @@ public:
     ///
     QualityValue(const uint8_t value = 0);
 
-    QualityValue(const QualityValue& other);
-    ~QualityValue(void);
+    QualityValue(const QualityValue& other) = default;
+    QualityValue& operator=(const QualityValue& other) = default;
+    ~QualityValue(void) = default;
 
     /// \}
 
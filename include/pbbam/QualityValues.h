@@ -62,6 +62,63 @@ public:
     ///
     static QualityValues FromFastq(const std::string& fastq);
 
+    /// \brief Creates a QualityValues object from a FASTQ-encoded character
+    ///        array (e.g. a TagView over a record's string tag data).
+    ///
+    /// \param[in] fastq    FASTQ-encoded characters
+    /// \param[in] length   number of characters
+    /// \returns corresponding QualityValues object
+    ///
+    static QualityValues FromFastq(const char* fastq, const size_t length);
+
+    /// \brief Fills an existing QualityValues object from a FASTQ-encoded
+    ///        character array.
+    ///
+    /// This is an overloaded method, reusing \p quals' storage instead of
+    /// returning a new object.
+    ///
+    /// \param[in]  fastq   FASTQ-encoded characters
+    /// \param[in]  length  number of characters
+    /// \param[out] quals   resulting quality values
+    ///
+    static void FromFastq(const char* fastq,
+                          const size_t length,
+                          QualityValues* quals);
+
+    /// \brief Fills an existing QualityValues object from numeric quality
+    ///        values (e.g. a record's QUAL field).
+    ///
+    /// \param[in]  rawQuals    numeric quality values, one byte each
+    /// \param[in]  length      number of values
+    /// \param[out] quals       resulting quality values
+    ///
+    static void FromRawData(const uint8_t* rawQuals,
+                            const size_t length,
+                            QualityValues* quals);
+
+    /// \brief Converts FASTQ-encoded characters into a caller-provided buffer
+    ///        of numeric quality values.
+    ///
+    /// \param[in]  fastq   FASTQ-encoded characters
+    /// \param[in]  length  number of characters
+    /// \param[out] quals   resulting values, with room for at least \p length
+    ///
+    static void FromFastq(const char* fastq,
+                          const size_t length,
+                          uint8_t* quals);
+
+    /// \brief Copies numeric quality values (e.g. a record's QUAL field) into
+    ///        a caller-provided buffer, clamped to QualityValue::MAX.
+    ///
+    /// \param[in]  rawQuals    numeric quality values, one byte each
+    /// \param[in]  length      number of values
+    /// \param[out] quals       resulting values, with room for at least
+    ///                         \p length
+    ///
+    static void FromRawData(const uint8_t* rawQuals,
+                            const size_t length,
+                            uint8_t* quals);
+
 public:
     /// \name Constructors & Related Methods
     ///  \{
@@ -96,6 +153,14 @@ public:
     ///
     explicit QualityValues(const std::vector<uint8_t>& quals);
 
+    /// \brief Creates a QualityValues object from an array of (numeric) quality
+    ///        values, e.g. a record's raw QUAL data.
+    ///
+    /// \param[in] quals    pointer to quality value numbers
+    /// \param[in] length   number of quality values
+    ///
+    QualityValues(const uint8_t* quals, const size_t length);
+
     /// \brief Creates a QualityValues object from the contents of the range:
     ///        [first, last)
     ///
@@ -189,6 +254,23 @@ public:
     /// \returns the FASTQ-encoded string for this sequence of quality values
     std::string Fastq(void) const;
 
+    /// \returns pointer to the numeric quality values, stored contiguously
+    ///          (one byte per QualityValue)
+    const uint8_t* RawData(void) const;
+
+    /// \returns pointer to the numeric quality values, stored contiguously
+    ///          (one byte per QualityValue)
+    uint8_t* RawData(void);
+
+    /// \}
+
+public:
+    /// \name Modifiers
+    /// \{
+
+    /// \brief Reverses the order of the quality values, in place.
+    void Reverse(void);
+
     /// \}
 };
 
@@ -0,0 +1,164 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file SortingBamWriter.h
+/// \brief Defines the SortingBamWriter class.
+//
+// Author: Derek Barnett
+
+#ifndef SORTINGBAMWRITER_H
+#define SORTINGBAMWRITER_H
+
+#include "pbbam/BamHeader.h"
+#include "pbbam/BamRecord.h"
+#include "pbbam/BamWriter.h"
+#include "pbbam/Config.h"
+#include <memory>
+#include <string>
+
+namespace PacBio {
+namespace BAM {
+
+namespace internal { class SortingBamWriterPrivate; }
+
+/// \brief The SortingBamWriter class provides a writing interface for creating
+///        new, sorted %BAM files from records supplied in any order.
+///
+/// Records are accumulated in memory, up to a requested limit. Each full batch
+/// is sorted (using multiple threads, if requested) and written to a temporary
+/// %BAM file. On Close, these sorted runs are merged into the final output.
+/// If all records fit in memory, no temporary files are used.
+///
+/// Temporary files are written alongside the output file, named
+/// "<output>.sort.<N>.bam", and are removed after merging.
+///
+/// \note As with BamWriter, the output file is not complete until Close is
+///       called (or the writer is destroyed). Prefer calling Close
+///       explicitly, as errors from the destructor cannot be reported.
+///
+class PBBAM_EXPORT SortingBamWriter
+{
+public:
+    /// \brief This enum describes the available record orderings.
+    ///
+    enum SortOrder
+    {
+        SortOrder_Coordinate = 0 ///< reference ID (unmapped last), then position
+      , SortOrder_QName          ///< PacBio order: movie name, hole number, CCS
+                                 ///  reads last, then query start
+    };
+
+public:
+    /// \name Constructors & Related Methods
+    /// \{
+
+    /// \brief Opens a sorting writer.
+    ///
+    /// The output header's sort order (@HD:SO) is set to "coordinate" for
+    /// SortOrder_Coordinate or "unknown" for SortOrder_QName.
+    ///
+    /// \note Set \p filename to "-" for stdout.
+    ///
+    /// \param[in] filename         path to output %BAM file
+    /// \param[in] header           BamHeader object
+    /// \param[in] sortOrder        requested record order
+    /// \param[in] memoryLimit      approximate number of bytes of record data
+    ///                             to hold in memory before writing a sorted
+    ///                             run to a temporary file
+    /// \param[in] numThreads       number of threads for sorting & compression.
+    ///                             If set to 0, SortingBamWriter will attempt
+    ///                             to determine a reasonable estimate.
+    /// \param[in] createPbi        if true, writes a PBI file alongside the
+    ///                             output %BAM (ignored for stdout)
+    /// \param[in] createBai        if true, writes a BAI file alongside the
+    ///                             output %BAM (coordinate order only, ignored
+    ///                             for stdout)
+    /// \param[in] compressionLevel zlib compression level of the output %BAM
+    ///
+    /// \throws std::runtime_error if \p filename is empty
+    ///
+    SortingBamWriter(const std::string& filename,
+                     const BamHeader& header,
+                     const SortOrder sortOrder,
+                     const size_t memoryLimit = 0x40000000,
+                     const size_t numThreads = 4,
+                     const bool createPbi = false,
+                     const bool createBai = false,
+                     const BamWriter::CompressionLevel compressionLevel = BamWriter::DefaultCompression);
+
+    /// \brief Finishes writing (if Close has not been called) and removes any
+    ///        remaining temporary files.
+    ///
+    /// Any errors are swallowed here, leaving no output file. Call Close to
+    /// observe them.
+    ///
+    ~SortingBamWriter(void);
+
+    /// \}
+
+public:
+    /// \name Data Writing
+    /// \{
+
+    /// \brief Adds a record to be sorted.
+    ///
+    /// \param[in] record BamRecord object
+    ///
+    /// \throws std::runtime_error if writer has been closed, or on failure to
+    ///         write a temporary run
+    ///
+    void Write(const BamRecord& record);
+
+    /// \brief Sorts & merges all records, writing the final output file(s).
+    ///
+    /// No further records may be written after this call.
+    ///
+    /// \throws std::runtime_error on failure to read temporary runs or to
+    ///         write output
+    ///
+    void Close(void);
+
+    /// \}
+
+private:
+    std::unique_ptr<internal::SortingBamWriterPrivate> d_;
+    DISABLE_MOVE_AND_COPY(SortingBamWriter);
+};
+
+} // namespace BAM
+} // namespace PacBio
+
+#endif // SORTINGBAMWRITER_H
@@ -443,6 +443,9 @@ private :
 
     var_t data_;
     TagModifier modifier_;
+
+    // reads strings & arrays in place, when encoding
+    friend class BamTagCodec;
 };
 
 } // namespace BAM
@@ -0,0 +1,188 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file TagBatch.h
+/// \brief Defines the TagBatch class.
+//
+// Author: Derek Barnett
+
+#ifndef TAGBATCH_H
+#define TAGBATCH_H
+
+#include "pbbam/Config.h"
+#include "pbbam/Tag.h"
+#include "pbbam/TagId.h"
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace PacBio {
+namespace BAM {
+
+class BamRecordImpl;
+
+/// \brief The TagBatch class collects several tag changes (new values,
+///        overwritten values, & removals), to be applied to a record at once.
+///
+/// Each AddTag, EditTag, or RemoveTag call on a BamRecordImpl resizes the
+/// record's data and shifts any trailing tags. Setting many tags that way
+/// (e.g. when producing a new record) repeats that work for every tag.
+/// BamRecordImpl::EditTags instead applies a whole batch in one pass: the
+/// final tag data size is computed once, existing tags are kept (or dropped)
+/// in place, and the new values are written at the end.
+///
+/// Values are encoded as they are added to the batch, so the batch does not
+/// hold on to the Tag objects, and may be reused (after Clear) without
+/// reallocating.
+///
+/// \code{.cpp}
+/// TagBatch batch;
+/// batch.Set("ip", ipdValues);
+/// batch.Set("pw", pwValues);
+/// batch.Remove("XY");
+/// record.Impl().EditTags(batch);
+/// \endcode
+///
+/// \sa BamRecordImpl::EditTags
+///
+class PBBAM_EXPORT TagBatch
+{
+public:
+    /// \name Constructors & Related Methods
+    /// \{
+
+    /// \brief Creates an empty batch.
+    TagBatch(void);
+
+    TagBatch(const TagBatch& other) = default;
+    TagBatch(TagBatch&& other) = default;
+    TagBatch& operator=(const TagBatch& other) = default;
+    TagBatch& operator=(TagBatch&& other) = default;
+    ~TagBatch(void) = default;
+
+    /// \}
+
+public:
+    /// \name Tag Changes
+    /// \{
+
+    /// \brief Sets a tag's value, adding the tag or overwriting its existing
+    ///        value when applied.
+    ///
+    /// Setting a tag more than once in the same batch keeps the last value.
+    ///
+    /// \param[in] tagId                tag name
+    /// \param[in] value                Tag object that describes the type &
+    ///                                 value of data to be set
+    /// \param[in] additionalModifier   optional extra modifier (for explicit
+    ///                                 modification of an otherwise const Tag)
+    ///
+    /// \returns true if value could be encoded & was added to the batch
+    ///
+    bool Set(const TagId& tagId,
+             const Tag& value,
+             const TagModifier additionalModifier = TagModifier::NONE);
+
+    /// \brief Sets a tag's value, adding the tag or overwriting its existing
+    ///        value when applied.
+    ///
+    /// This is an overloaded method, taking a tag name instead of a TagId.
+    ///
+    /// \returns true if tag name is valid & value could be encoded
+    ///
+    bool Set(const std::string& tagName,
+             const Tag& value,
+             const TagModifier additionalModifier = TagModifier::NONE);
+
+    /// \brief Removes a tag (if present) when applied.
+    ///
+    /// Also drops any value already set for this tag in the batch.
+    ///
+    void Remove(const TagId& tagId);
+
+    /// \brief Removes a tag (if present) when applied.
+    ///
+    /// This is an overloaded method, taking a tag name instead of a TagId.
+    ///
+    /// \returns true if tag name is valid
+    ///
+    bool Remove(const std::string& tagName);
+
+    /// \brief Drops all changes, keeping allocated storage for reuse.
+    void Clear(void);
+
+    /// \}
+
+public:
+    /// \name Attributes
+    /// \{
+
+    /// \returns true if the batch contains no changes
+    bool IsEmpty(void) const;
+
+    /// \returns number of tags set in the batch
+    size_t NumSetTags(void) const;
+
+    /// \returns number of tags removed by the batch
+    size_t NumRemovedTags(void) const;
+
+    /// \}
+
+private:
+    // true if applying the batch replaces or removes this tag
+    bool Changes(const uint16_t tagCode) const;
+
+    void EraseSetTag(const uint16_t tagCode);
+
+private:
+    // new values, as they will appear in the record's tag data
+    // ("<TAG><TYPE><DATA>"), & (tag code, offset into data_) for each
+    std::vector<uint8_t> data_;
+    std::vector<std::pair<uint16_t, size_t> > setTags_;
+
+    std::vector<uint16_t> removedTags_;
+
+    friend class BamRecordImpl;
+};
+
+} // namespace BAM
+} // namespace PacBio
+
+#include "pbbam/internal/TagBatch.inl"
+
+#endif // TAGBATCH_H
@@ -0,0 +1,116 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file TagId.h
+/// \brief Defines the TagId class.
+//
+// Author: Derek Barnett
+
+#ifndef TAGID_H
+#define TAGID_H
+
+#include "pbbam/Config.h"
+#include <string>
+#include <cstdint>
+
+namespace PacBio {
+namespace BAM {
+
+/// \brief The TagId class is a compact, compile-time representation of a
+///        2-character %BAM tag name.
+///
+/// The name is packed into a 16-bit code (first character in the high byte),
+/// so tag lookups using a TagId avoid constructing or comparing strings.
+///
+/// \code{.cpp}
+/// static constexpr TagId ipdTag('i', 'p');
+/// if (record.Impl().HasTag(ipdTag)) { ... }
+/// \endcode
+///
+class PBBAM_EXPORT TagId
+{
+public:
+    /// \name Constructors & Related Methods
+    /// \{
+
+    /// \brief Creates a TagId from its 2 characters.
+    constexpr TagId(const char c1, const char c2)
+        : code_(static_cast<uint16_t>((static_cast<uint8_t>(c1) << 8) | static_cast<uint8_t>(c2)))
+    { }
+
+    /// \brief Creates a TagId from a 2-character tag name string.
+    ///
+    /// \throws std::runtime_error if \p name is not exactly 2 characters
+    ///
+    explicit TagId(const std::string& name);
+
+    /// \}
+
+public:
+    /// \name Attributes
+    /// \{
+
+    /// \returns packed 16-bit tag name code
+    constexpr uint16_t Code(void) const
+    { return code_; }
+
+    /// \returns tag name as a 2-character string
+    std::string ToString(void) const;
+
+    /// \}
+
+public:
+    /// \name Comparison Operators
+    /// \{
+
+    constexpr bool operator==(const TagId& other) const
+    { return code_ == other.code_; }
+
+    constexpr bool operator!=(const TagId& other) const
+    { return code_ != other.code_; }
+
+    /// \}
+
+private:
+    uint16_t code_;
+};
+
+} // namespace BAM
+} // namespace PacBio
+
+#include "pbbam/internal/TagId.inl"
+
+#endif // TAGID_H
@@ -0,0 +1,187 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file TagView.h
+/// \brief Defines the TagView class.
+//
+// Author: Derek Barnett
+
+#ifndef TAGVIEW_H
+#define TAGVIEW_H
+
+#include "pbbam/Config.h"
+#include "pbbam/Tag.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace PacBio {
+namespace BAM {
+
+/// \brief The TagView class provides read-only, non-owning access to a tag
+///        value, directly over a record's raw tag data.
+///
+/// Unlike Tag, which copies the value out of the record, a TagView only
+/// stores the value's type, element count, and location. Fetching a view is
+/// therefore cheap for array ('B') and string ('Z'/'H') tags, regardless of
+/// their length.
+///
+/// A TagView is valid only as long as the record it was obtained from is
+/// alive and unmodified. Any edit to the record (e.g. AddTag, EditTag,
+/// RemoveTag, SetSequenceAndQualities) may invalidate it.
+///
+/// \note Tag data in %BAM records is not aligned. Multi-byte elements should be
+///       read via Element or CopyTo, rather than by casting RawData().
+///
+/// \sa BamRecordImpl::TagValueView
+///
+class PBBAM_EXPORT TagView
+{
+public:
+    /// \name Constructors & Related Methods
+    /// \{
+
+    /// \brief Creates an empty, null view.
+    TagView(void);
+
+    /// \brief Creates a view over raw tag data.
+    ///
+    /// \param[in] type         data type of the value (array types for 'B'
+    ///                         tags, STRING for 'Z' & 'H' tags)
+    /// \param[in] modifier     additional type info (e.g. HEX_STRING)
+    /// \param[in] data         start of the value's (first element's) bytes
+    /// \param[in] numElements  number of elements (characters for strings,
+    ///                         1 for scalars)
+    ///
+    TagView(const TagDataType type,
+            const TagModifier modifier,
+            const uint8_t* data,
+            const size_t numElements);
+
+    TagView(const TagView& other) = default;
+    TagView& operator=(const TagView& other) = default;
+    ~TagView(void) = default;
+
+    /// \}
+
+public:
+    /// \name Type Information
+    /// \{
+
+    /// \returns data type of the viewed value
+    TagDataType Type(void) const;
+
+    /// \returns modifier of the viewed value
+    TagModifier Modifier(void) const;
+
+    /// \returns true if the view does not refer to any tag data
+    bool IsNull(void) const;
+
+    /// \returns true if the viewed value is a ('B') array
+    bool IsArray(void) const;
+
+    /// \returns true if the viewed value is a ('Z' or 'H') string
+    bool IsString(void) const;
+
+    /// \returns size, in bytes, of a single element of the viewed value
+    size_t ElementSize(void) const;
+
+    /// \}
+
+public:
+    /// \name Data Access
+    /// \{
+
+    /// \returns number of elements (characters, for strings)
+    size_t Size(void) const;
+
+    /// \returns true if view contains no elements
+    bool IsEmpty(void) const;
+
+    /// \returns pointer to the first byte of the value's elements
+    const uint8_t* RawData(void) const;
+
+    /// \returns string data as a char pointer (not null-terminated at Size())
+    const char* Chars(void) const;
+
+    /// \brief Reads a single element.
+    ///
+    /// \param[in] i  element index (not bounds-checked)
+    /// \returns element value, interpreted as T
+    ///
+    /// \note T's size must match ElementSize(). This is not checked.
+    ///
+    template<typename T>
+    T Element(const size_t i) const;
+
+    /// \brief Copies all elements into a caller-provided buffer.
+    ///
+    /// \param[out] dest  destination, with room for at least Size() elements
+    ///
+    /// \throws std::runtime_error if T's size does not match ElementSize()
+    ///
+    template<typename T>
+    void CopyTo(T* dest) const;
+
+    /// \returns copy of all elements as a std::vector
+    ///
+    /// \throws std::runtime_error if T's size does not match ElementSize()
+    ///
+    template<typename T>
+    std::vector<T> ToVector(void) const;
+
+    /// \returns copy of string data
+    std::string ToString(void) const;
+
+    /// \returns full, owning Tag object with the same value
+    Tag ToTag(void) const;
+
+    /// \}
+
+private:
+    TagDataType type_;
+    TagModifier modifier_;
+    const uint8_t* data_;
+    size_t numElements_;
+};
+
+} // namespace BAM
+} // namespace PacBio
+
+#include "pbbam/internal/TagView.inl"
+
+#endif // TAGVIEW_H
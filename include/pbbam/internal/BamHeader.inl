@@ -40,13 +40,31 @@
 // Author: Derek Barnett
 
 #include "pbbam/BamHeader.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 namespace PacBio {
 namespace BAM {
 namespace internal {
 
+class ReadGroupTable;
+
 class BamHeaderPrivate
 {
+public:
+    BamHeaderPrivate(void)
+        : readGroupTable_(nullptr)
+    { }
+
+    // must be called whenever readGroups_ changes
+    void InvalidateReadGroupTable(void)
+    {
+        std::lock_guard<std::mutex> lock(readGroupTableMutex_);
+        readGroupTable_ = nullptr;
+        readGroupTableData_.reset();
+    }
+
 public:
     std::string version_;
     std::string pacbioBamVersion_;
@@ -60,6 +78,11 @@ public:
     // we need to preserve insertion order, use lookup for access by name
     std::vector<SequenceInfo> sequences_;
     std::map<std::string, int32_t> sequenceIdLookup_;
+
+    // read group lookup, built on first request (see BamHeader::ReadGroupLookupTable)
+    mutable std::mutex readGroupTableMutex_;
+    mutable std::atomic<const ReadGroupTable*> readGroupTable_;
+    mutable std::shared_ptr<const ReadGroupTable> readGroupTableData_;
 };
 
 } // namespace internal
@@ -72,14 +95,14 @@ inline BamHeader::BamHeader(const BamHeader& other)
     : d_(other.d_)
 { }
 
-inline BamHeader::BamHeader(BamHeader&& other)
+inline BamHeader::BamHeader(BamHeader&& other) noexcept
     : d_(std::move(other.d_))
 { }
 
 inline BamHeader& BamHeader::operator=(const BamHeader& other)
 { d_ = other.d_; return *this; }
 
-inline BamHeader& BamHeader::operator=(BamHeader&& other)
+inline BamHeader& BamHeader::operator=(BamHeader&& other) noexcept
 { d_ = std::move(other.d_); return *this; }
 
 inline BamHeader::~BamHeader(void) { }
@@ -94,7 +117,11 @@ inline BamHeader& BamHeader::AddProgram(const ProgramInfo& pg)
 { d_->programs_[pg.Id()] = pg; return *this; }
 
 inline BamHeader& BamHeader::AddReadGroup(const ReadGroupInfo& readGroup)
-{ d_->readGroups_[readGroup.Id()] = readGroup; return *this; }
+{
+    d_->readGroups_[readGroup.Id()] = readGroup;
+    d_->InvalidateReadGroupTable();
+    return *this;
+}
 
 inline BamHeader& BamHeader::ClearComments(void)
 { d_->comments_.clear(); return* this; }
@@ -103,7 +130,11 @@ inline BamHeader& BamHeader::ClearPrograms(void)
 { d_->programs_.clear(); return *this; }
 
 inline BamHeader& BamHeader::ClearReadGroups(void)
-{ d_->readGroups_.clear(); return *this; }
+{
+    d_->readGroups_.clear();
+    d_->InvalidateReadGroupTable();
+    return *this;
+}
 
 inline std::vector<std::string> BamHeader::Comments(void) const
 { return d_->comments_; }
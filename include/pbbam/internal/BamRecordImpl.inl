@@ -44,59 +44,71 @@
 namespace PacBio {
 namespace BAM {
 
+inline void BamRecordImpl::DetachData(void)
+{
+    // use_count() is a relaxed load. If we hold the last reference, make sure
+    // other threads' reads (before they dropped theirs) happen before our
+    // in-place modification.
+    if (d_.use_count() > 1)
+        DuplicateData();
+    else
+        std::atomic_thread_fence(std::memory_order_acquire);
+}
+
 inline uint32_t BamRecordImpl::Bin(void) const
 { return d_->core.bin; }
 
 inline BamRecordImpl& BamRecordImpl::Bin(uint32_t bin)
-{ d_->core.bin = bin; return *this; }
+{ DetachData(); d_->core.bin = bin; return *this; }
 
 inline uint32_t BamRecordImpl::Flag(void) const
 { return d_->core.flag; }
 
 inline BamRecordImpl& BamRecordImpl::Flag(uint32_t flag)
-{ d_->core.flag = flag; return *this; }
+{ DetachData(); d_->core.flag = flag; return *this; }
 
 inline int32_t BamRecordImpl::InsertSize(void) const
 { return d_->core.isize; }
 
 inline BamRecordImpl& BamRecordImpl::InsertSize(int32_t iSize)
-{ d_->core.isize = iSize; return *this; }
+{ DetachData(); d_->core.isize = iSize; return *this; }
 
 inline uint8_t BamRecordImpl::MapQuality(void) const
 { return d_->core.qual; }
 
 inline BamRecordImpl& BamRecordImpl::MapQuality(uint8_t mapQual)
-{ d_->core.qual = mapQual; return *this; }
+{ DetachData(); d_->core.qual = mapQual; return *this; }
 
 inline PacBio::BAM::Position BamRecordImpl::MatePosition(void) const
 { return d_->core.mpos; }
 
 inline BamRecordImpl& BamRecordImpl::MatePosition(PacBio::BAM::Position pos)
-{ d_->core.mpos = pos; return *this; }
+{ DetachData(); d_->core.mpos = pos; return *this; }
 
 inline int32_t BamRecordImpl::MateReferenceId(void) const
 { return d_->core.mtid; }
 
 inline BamRecordImpl& BamRecordImpl::MateReferenceId(int32_t id)
-{ d_->core.mtid = id; return *this; }
+{ DetachData(); d_->core.mtid = id; return *this; }
 
 inline PacBio::BAM::Position BamRecordImpl::Position(void) const
 { return d_->core.pos; }
 
 inline BamRecordImpl& BamRecordImpl::Position(PacBio::BAM::Position pos)
-{ d_->core.pos = pos; return *this; }
+{ DetachData(); d_->core.pos = pos; return *this; }
 
 inline int32_t BamRecordImpl::ReferenceId(void) const
 { return d_->core.tid; }
 
 inline BamRecordImpl& BamRecordImpl::ReferenceId(int32_t id)
-{ d_->core.tid = id; return *this; }
+{ DetachData(); d_->core.tid = id; return *this; }
 
 inline bool BamRecordImpl::IsDuplicate(void) const
 { return (d_->core.flag & BamRecordImpl::DUPLICATE) != 0; }
 
 inline BamRecordImpl& BamRecordImpl::SetDuplicate(bool ok)
 {
+    DetachData();
     if (ok) d_->core.flag |=  BamRecordImpl::DUPLICATE;
     else    d_->core.flag &= ~BamRecordImpl::DUPLICATE;
     return *this;
@@ -107,6 +119,7 @@ inline bool BamRecordImpl::IsFailedQC(void) const
 
 inline BamRecordImpl& BamRecordImpl::SetFailedQC(bool ok)
 {
+    DetachData();
     if (ok) d_->core.flag |=  BamRecordImpl::FAILED_QC;
     else    d_->core.flag &= ~BamRecordImpl::FAILED_QC;
     return *this;
@@ -117,6 +130,7 @@ inline bool BamRecordImpl::IsFirstMate(void) const
 
 inline BamRecordImpl& BamRecordImpl::SetFirstMate(bool ok)
 {
+    DetachData();
     if (ok) d_->core.flag |=  BamRecordImpl::MATE_1;
     else    d_->core.flag &= ~BamRecordImpl::MATE_1;
     return *this;
@@ -127,6 +141,7 @@ inline bool BamRecordImpl::IsMapped(void) const
 
 inline BamRecordImpl& BamRecordImpl::SetMapped(bool ok)
 {
+    DetachData();
     if (ok) d_->core.flag &= ~BamRecordImpl::UNMAPPED;
     else    d_->core.flag |=  BamRecordImpl::UNMAPPED;
     return *this;
@@ -137,6 +152,7 @@ inline bool BamRecordImpl::IsMateMapped(void) const
 
 inline BamRecordImpl& BamRecordImpl::SetMateMapped(bool ok)
 {
+    DetachData();
     if (ok) d_->core.flag &= ~BamRecordImpl::MATE_UNMAPPED;
     else    d_->core.flag |=  BamRecordImpl::MATE_UNMAPPED;
     return *this;
@@ -147,6 +163,7 @@ inline bool BamRecordImpl::IsMateReverseStrand(void) const
 
 inline BamRecordImpl& BamRecordImpl::SetMateReverseStrand(bool ok)
 {
+    DetachData();
     if (ok) d_->core.flag |=  BamRecordImpl::MATE_REVERSE_STRAND;
     else    d_->core.flag &= ~BamRecordImpl::MATE_REVERSE_STRAND;
     return *this;
@@ -157,6 +174,7 @@ inline bool BamRecordImpl::IsPaired(void) const
 
 inline BamRecordImpl& BamRecordImpl::SetPaired(bool ok)
 {
+    DetachData();
     if (ok) d_->core.flag |=  BamRecordImpl::PAIRED;
     else    d_->core.flag &= ~BamRecordImpl::PAIRED;
     return *this;
@@ -167,6 +185,7 @@ inline bool BamRecordImpl::IsPrimaryAlignment(void) const
 
 inline BamRecordImpl& BamRecordImpl::SetPrimaryAlignment(bool ok)
 {
+    DetachData();
     if (ok) d_->core.flag &= ~BamRecordImpl::SECONDARY;
     else    d_->core.flag |=  BamRecordImpl::SECONDARY;
     return *this;
@@ -177,6 +196,7 @@ inline bool BamRecordImpl::IsProperPair(void) const
 
 inline BamRecordImpl& BamRecordImpl::SetProperPair(bool ok)
 {
+    DetachData();
     if (ok) d_->core.flag |=  BamRecordImpl::PROPER_PAIR;
     else    d_->core.flag &= ~BamRecordImpl::PROPER_PAIR;
     return *this;
@@ -187,6 +207,7 @@ inline bool BamRecordImpl::IsReverseStrand(void) const
 
 inline BamRecordImpl& BamRecordImpl::SetReverseStrand(bool ok)
 {
+    DetachData();
     if (ok) d_->core.flag |=  BamRecordImpl::REVERSE_STRAND;
     else    d_->core.flag &= ~BamRecordImpl::REVERSE_STRAND;
     return *this;
@@ -197,6 +218,7 @@ inline bool BamRecordImpl::IsSecondMate(void) const
 
 inline BamRecordImpl& BamRecordImpl::SetSecondMate(bool ok)
 {
+    DetachData();
     if (ok) d_->core.flag |=  BamRecordImpl::MATE_2;
     else    d_->core.flag &= ~BamRecordImpl::MATE_2;
     return *this;
@@ -207,6 +229,7 @@ inline bool BamRecordImpl::IsSupplementaryAlignment(void) const
 
 inline BamRecordImpl& BamRecordImpl::SetSupplementaryAlignment(bool ok)
 {
+    DetachData();
     if (ok) d_->core.flag |=  BamRecordImpl::SUPPLEMENTARY;
     else    d_->core.flag &= ~BamRecordImpl::SUPPLEMENTARY;
     return *this;
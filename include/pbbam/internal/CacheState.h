@@ -0,0 +1,100 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+
+// File Description
+/// \file CacheState.h
+/// \brief Defines the CacheState class.
+//
+// Author: Derek Barnett
+
+#ifndef CACHESTATE_H
+#define CACHESTATE_H
+
+#include <atomic>
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// The CacheState class tracks whether a lazily computed value (cached in
+// mutable members & filled from const methods) is up-to-date, so that
+// concurrent const access is safe.
+//
+// The first thread to find the value missing computes it, while any others
+// wait for it to be published. Once valid, checking the state is a single
+// (acquire) atomic load.
+//
+// Invalidate() is meant for modifying methods, and, like any other
+// modification, must not race with readers of the same object.
+//
+class CacheState
+{
+public:
+    CacheState(void);
+
+    // Not copyable: an owner being copied should copy its cached value only if
+    // the source's IsValid(), then call SetValid() on its own state.
+    CacheState(const CacheState&) = delete;
+    CacheState& operator=(const CacheState&) = delete;
+
+public:
+    // Runs compute() unless the value is already valid, then marks it valid.
+    // compute() is called at most once per invalidation, even with multiple
+    // concurrent callers.
+    template<typename Compute>
+    void EnsureValid(Compute compute) const;
+
+    // Returns true if the cached value is valid (and safe to read/copy).
+    bool IsValid(void) const;
+
+    // Marks the cached value as needing (re-)computation.
+    void Invalidate(void) const;
+
+    // Marks the cached value as valid, after the owner has filled it directly.
+    void SetValid(void) const;
+
+private:
+    enum State { INVALID = 0, COMPUTING, VALID };
+    mutable std::atomic<int> state_;
+};
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+#include "pbbam/internal/CacheState.inl"
+
+#endif // CACHESTATE_H
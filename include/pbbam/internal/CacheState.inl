@@ -0,0 +1,96 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+
+// File Description
+/// \file CacheState.inl
+/// \brief Inline implementations for the CacheState class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/internal/CacheState.h"
+#include <thread>
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+inline CacheState::CacheState(void)
+    : state_(INVALID)
+{ }
+
+template<typename Compute>
+inline void CacheState::EnsureValid(Compute compute) const
+{
+    int state = state_.load(std::memory_order_acquire);
+    while (state != VALID) {
+
+        // claim computation
+        if (state == INVALID) {
+            if (state_.compare_exchange_weak(state, COMPUTING,
+                                             std::memory_order_acquire,
+                                             std::memory_order_acquire))
+            {
+                try {
+                    compute();
+                } catch (...) {
+                    state_.store(INVALID, std::memory_order_release);
+                    throw;
+                }
+                state_.store(VALID, std::memory_order_release);
+                return;
+            }
+        }
+
+        // another thread is computing, wait for it
+        else {
+            std::this_thread::yield();
+            state = state_.load(std::memory_order_acquire);
+        }
+    }
+}
+
+inline void CacheState::Invalidate(void) const
+{ state_.store(INVALID, std::memory_order_release); }
+
+inline bool CacheState::IsValid(void) const
+{ return state_.load(std::memory_order_acquire) == VALID; }
+
+inline void CacheState::SetValid(void) const
+{ state_.store(VALID, std::memory_order_release); }
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
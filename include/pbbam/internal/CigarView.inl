@@ -0,0 +1,130 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file CigarView.inl
+/// \brief Inline implementations for the CigarView class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/CigarView.h"
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// CigarOperation's (type, length) constructors reject 'M', which is only
+// wanted when building new CIGAR data - a view reports what is stored
+inline CigarOperation UnpackCigarOperation(const uint32_t op)
+{
+    CigarOperation result;
+    result.Type(static_cast<CigarOperationType>(op & 0xf));
+    result.Length(op >> 4);
+    return result;
+}
+
+} // namespace internal
+
+// ----------------------------
+// CigarView::const_iterator
+// ----------------------------
+
+inline CigarView::const_iterator::const_iterator(void)
+    : op_(nullptr)
+{ }
+
+inline CigarView::const_iterator::const_iterator(const uint32_t* op)
+    : op_(op)
+{ }
+
+inline CigarOperation CigarView::const_iterator::operator*(void) const
+{ return internal::UnpackCigarOperation(*op_); }
+
+inline CigarView::const_iterator& CigarView::const_iterator::operator++(void)
+{ ++op_; return *this; }
+
+inline CigarView::const_iterator CigarView::const_iterator::operator++(int)
+{
+    const_iterator result(*this);
+    ++op_;
+    return result;
+}
+
+inline bool CigarView::const_iterator::operator==(const const_iterator& other) const
+{ return op_ == other.op_; }
+
+inline bool CigarView::const_iterator::operator!=(const const_iterator& other) const
+{ return !(*this == other); }
+
+// ----------------------------
+// CigarView
+// ----------------------------
+
+inline CigarView::CigarView(void)
+    : data_(nullptr)
+    , numOps_(0)
+{ }
+
+inline CigarView::CigarView(const uint32_t* data, const size_t numOps)
+    : data_(data)
+    , numOps_(numOps)
+{ }
+
+inline CigarView::const_iterator CigarView::begin(void) const
+{ return const_iterator(data_); }
+
+inline CigarView::const_iterator CigarView::end(void) const
+{ return const_iterator(data_ + numOps_); }
+
+inline bool CigarView::IsEmpty(void) const
+{ return numOps_ == 0; }
+
+inline uint32_t CigarView::Length(const size_t i) const
+{ return data_[i] >> 4; }
+
+inline CigarOperation CigarView::operator[](const size_t i) const
+{ return internal::UnpackCigarOperation(data_[i]); }
+
+inline const uint32_t* CigarView::RawData(void) const
+{ return data_; }
+
+inline size_t CigarView::Size(void) const
+{ return numOps_; }
+
+inline CigarOperationType CigarView::Type(const size_t i) const
+{ return static_cast<CigarOperationType>(data_[i] & 0xf); }
+
+} // namespace BAM
+} // namespace PacBio
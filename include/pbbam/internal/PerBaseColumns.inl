@@ -0,0 +1,99 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file PerBaseColumns.inl
+/// \brief Inline implementations for the PerBaseColumns class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/PerBaseColumns.h"
+#include <stdexcept>
+
+namespace PacBio {
+namespace BAM {
+
+inline void PerBaseColumns::Append(const std::vector<BamRecord>& records)
+{ Append(records.data(), records.size()); }
+
+template<typename QueryType>
+inline size_t PerBaseColumns::AppendQuery(QueryType& query, const size_t batchSize)
+{
+    // copies share each record's data (copy-on-write), so batching is cheap
+    std::vector<BamRecord> batch;
+    batch.reserve(batchSize);
+    size_t numAppended = 0;
+    for (const BamRecord& record : query) {
+        batch.push_back(record);
+        if (batch.size() == batchSize) {
+            Append(batch);
+            numAppended += batch.size();
+            batch.clear();
+        }
+    }
+    if (!batch.empty()) {
+        Append(batch);
+        numAppended += batch.size();
+    }
+    return numAppended;
+}
+
+inline const std::vector<PerBaseField>& PerBaseColumns::Fields(void) const
+{ return fields_; }
+
+inline const std::vector<uint16_t>& PerBaseColumns::FrameData(const PerBaseField field) const
+{
+    const Column& column = ColumnFor(field);
+    if (!column.isFrames)
+        throw std::runtime_error("PerBaseColumns: requested field does not contain frame data");
+    return column.frames;
+}
+
+inline size_t PerBaseColumns::NumRecords(void) const
+{ return columns_.front().offsets.size() - 1; }
+
+inline const std::vector<size_t>& PerBaseColumns::Offsets(const PerBaseField field) const
+{ return ColumnFor(field).offsets; }
+
+inline const std::vector<uint8_t>& PerBaseColumns::QualityData(const PerBaseField field) const
+{
+    const Column& column = ColumnFor(field);
+    if (column.isFrames)
+        throw std::runtime_error("PerBaseColumns: requested field does not contain QV data");
+    return column.quals;
+}
+
+} // namespace BAM
+} // namespace PacBio
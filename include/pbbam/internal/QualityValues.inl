@@ -45,28 +45,24 @@
 namespace PacBio {
 namespace BAM {
 
+static_assert(sizeof(QualityValue) == sizeof(uint8_t),
+              "QualityValues relies on QualityValue being stored as a single byte");
+
 inline QualityValues::QualityValues(void)
     : std::vector<QualityValue>()
 { }
 
 inline QualityValues::QualityValues(const std::string& fastqString)
-    : std::vector<QualityValue>()
-{
-    resize(fastqString.size());
-    std::transform(fastqString.cbegin(), fastqString.cend(),
-                   begin(), QualityValue::FromFastq);
-}
+    : QualityValues(FromFastq(fastqString.data(), fastqString.size()))
+{ }
 
 inline QualityValues::QualityValues(const std::vector<QualityValue>& quals)
     : std::vector<QualityValue>(quals)
 { }
 
 inline QualityValues::QualityValues(const std::vector<uint8_t>& quals)
-    : std::vector<QualityValue>()
-{
-    resize(quals.size());
-    std::copy(quals.cbegin(), quals.cend(), begin());
-}
+    : QualityValues(quals.data(), quals.size())
+{ }
 
 inline QualityValues::QualityValues(const std::vector<uint8_t>::const_iterator first,
                                     const std::vector<uint8_t>::const_iterator last)
@@ -125,18 +121,13 @@ inline std::vector<QualityValue>::iterator QualityValues::end(void)
 { return std::vector<QualityValue>::end(); }
 
 inline QualityValues QualityValues::FromFastq(const std::string& fastq)
-{ return QualityValues(fastq); }
+{ return FromFastq(fastq.data(), fastq.size()); }
 
-inline std::string QualityValues::Fastq(void) const
-{
-    std::string result;
-    result.reserve(size());
-    auto iter = cbegin();
-    const auto end = cend();
-    for (; iter != end; ++iter)
-        result.push_back((*iter).Fastq());
-    return result;
-}
+inline const uint8_t* QualityValues::RawData(void) const
+{ return reinterpret_cast<const uint8_t*>(data()); }
+
+inline uint8_t* QualityValues::RawData(void)
+{ return reinterpret_cast<uint8_t*>(data()); }
 
 inline bool QualityValues::operator==(const std::string& fastq) const
 { return *this == QualityValues(fastq); }
@@ -52,10 +52,26 @@ namespace internal {
 template<typename T>
 class QueryBase;
 
+// Query iterators hold a single value (record_), which each increment refills
+// in place via QueryBase::GetNext(). No per-step copy is made, so a group
+// query's records flow straight from the reader into the group buffer.
+//
+// Callers may take ownership of the current value through a non-const
+// iterator (e.g. std::move(*it) or std::swap), as long as what is left behind
+// is valid for the next GetNext(): a moved-from vector is fine for group
+// queries, while single-record queries need a live BamRecord (swap with a
+// fresh one). Note that postfix operator++ returns a copy of the iterator,
+// including its current value; prefer the prefix form. Iterators themselves
+// are movable, so assigning from begin() does not copy the first value.
+//
 template<typename T>
 class QueryIteratorBase
 {
 public:
+    QueryIteratorBase(const QueryIteratorBase<T>&) = default;
+    QueryIteratorBase(QueryIteratorBase<T>&&) = default;
+    QueryIteratorBase<T>& operator=(const QueryIteratorBase<T>&) = default;
+    QueryIteratorBase<T>& operator=(QueryIteratorBase<T>&&) = default;
     virtual ~QueryIteratorBase(void);
 
     bool operator==(const QueryIteratorBase<T>& other) const;
@@ -0,0 +1,79 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file TagBatch.inl
+/// \brief Inline implementations for the TagBatch class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/TagBatch.h"
+
+namespace PacBio {
+namespace BAM {
+
+inline TagBatch::TagBatch(void) { }
+
+inline bool TagBatch::Changes(const uint16_t tagCode) const
+{
+    for (const auto& entry : setTags_) {
+        if (entry.first == tagCode)
+            return true;
+    }
+    for (const uint16_t code : removedTags_) {
+        if (code == tagCode)
+            return true;
+    }
+    return false;
+}
+
+inline void TagBatch::Clear(void)
+{
+    data_.clear();
+    setTags_.clear();
+    removedTags_.clear();
+}
+
+inline bool TagBatch::IsEmpty(void) const
+{ return setTags_.empty() && removedTags_.empty(); }
+
+inline size_t TagBatch::NumRemovedTags(void) const
+{ return removedTags_.size(); }
+
+inline size_t TagBatch::NumSetTags(void) const
+{ return setTags_.size(); }
+
+} // namespace BAM
+} // namespace PacBio
@@ -0,0 +1,122 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file TagView.inl
+/// \brief Inline implementations for the TagView class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/TagView.h"
+#include <stdexcept>
+#include <cstring>
+
+namespace PacBio {
+namespace BAM {
+
+inline TagView::TagView(void)
+    : type_(TagDataType::INVALID)
+    , modifier_(TagModifier::NONE)
+    , data_(nullptr)
+    , numElements_(0)
+{ }
+
+inline TagView::TagView(const TagDataType type,
+                        const TagModifier modifier,
+                        const uint8_t* data,
+                        const size_t numElements)
+    : type_(type)
+    , modifier_(modifier)
+    , data_(data)
+    , numElements_(numElements)
+{ }
+
+inline const char* TagView::Chars(void) const
+{ return reinterpret_cast<const char*>(data_); }
+
+template<typename T>
+inline void TagView::CopyTo(T* dest) const
+{
+    if (sizeof(T) != ElementSize())
+        throw std::runtime_error("TagView: requested type does not match tag element size");
+    if (numElements_ > 0)
+        memcpy(dest, data_, numElements_ * sizeof(T));
+}
+
+template<typename T>
+inline T TagView::Element(const size_t i) const
+{
+    T result;
+    memcpy(&result, data_ + i*sizeof(T), sizeof(T));
+    return result;
+}
+
+inline bool TagView::IsArray(void) const
+{ return type_ >= TagDataType::INT8_ARRAY; }
+
+inline bool TagView::IsEmpty(void) const
+{ return numElements_ == 0; }
+
+inline bool TagView::IsNull(void) const
+{ return type_ == TagDataType::INVALID; }
+
+inline bool TagView::IsString(void) const
+{ return type_ == TagDataType::STRING; }
+
+inline TagModifier TagView::Modifier(void) const
+{ return modifier_; }
+
+inline const uint8_t* TagView::RawData(void) const
+{ return data_; }
+
+inline size_t TagView::Size(void) const
+{ return numElements_; }
+
+inline std::string TagView::ToString(void) const
+{ return std::string(Chars(), numElements_); }
+
+template<typename T>
+inline std::vector<T> TagView::ToVector(void) const
+{
+    std::vector<T> result(numElements_);
+    CopyTo(result.data());
+    return result;
+}
+
+inline TagDataType TagView::Type(void) const
+{ return type_; }
+
+} // namespace BAM
+} // namespace PacBio
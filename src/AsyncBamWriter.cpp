@@ -0,0 +1,270 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file AsyncBamWriter.cpp
+/// \brief Implements the AsyncBamWriter class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/AsyncBamWriter.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+class AsyncBamWriterPrivate
+{
+public:
+    AsyncBamWriterPrivate(const string& filename,
+                          const BamHeader& header,
+                          const size_t maxQueueSize,
+                          const BamWriter::CompressionLevel compressionLevel,
+                          const size_t numThreads,
+                          const BamWriter::BinCalculationMode binCalculationMode,
+                          const BamWriter::IndexTypes indexTypes);
+
+public:
+    void Close(void);
+    void Flush(void);
+    void Write(BamRecord&& record);
+
+private:
+    void Run(void);
+    void Stop(void);
+
+    // requires lock held
+    void ThrowIfClosed(void) const;
+
+private:
+    unique_ptr<BamWriter> writer_;
+    size_t maxQueueSize_;
+
+    // guarded by mutex_
+    mutex mutex_;
+    condition_variable hasData_;    // signals background thread
+    condition_variable hasSpace_;   // signals waiting Write/Flush calls
+    deque<BamRecord> queue_;
+    size_t numInFlight_;            // taken by background thread, not yet written
+    bool isClosing_;
+    bool isClosed_;
+    exception_ptr error_;
+
+    thread worker_;
+};
+
+AsyncBamWriterPrivate::AsyncBamWriterPrivate(const string& filename,
+                                             const BamHeader& header,
+                                             const size_t maxQueueSize,
+                                             const BamWriter::CompressionLevel compressionLevel,
+                                             const size_t numThreads,
+                                             const BamWriter::BinCalculationMode binCalculationMode,
+                                             const BamWriter::IndexTypes indexTypes)
+    : writer_(new BamWriter(filename,
+                            header,
+                            compressionLevel,
+                            numThreads,
+                            binCalculationMode,
+                            indexTypes))
+    , maxQueueSize_(maxQueueSize == 0 ? 1 : maxQueueSize)
+    , numInFlight_(0)
+    , isClosing_(false)
+    , isClosed_(false)
+{
+    // start background thread only after file & header are ready, so that
+    // any errors there are thrown directly to the caller
+    worker_ = thread(&AsyncBamWriterPrivate::Run, this);
+}
+
+void AsyncBamWriterPrivate::Close(void)
+{
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (isClosed_)
+            return;
+        isClosed_ = true;
+    }
+    Stop();
+
+    // If the background thread failed, destroy the writer while the error is
+    // 'live'. This way the incomplete file is not renamed to the requested
+    // filename & no index files are written.
+    if (error_) {
+        try {
+            rethrow_exception(error_);
+        } catch (...) {
+            writer_.reset();
+            throw;
+        }
+    }
+    writer_.reset();
+}
+
+void AsyncBamWriterPrivate::Flush(void)
+{
+    unique_lock<mutex> lock(mutex_);
+    ThrowIfClosed();
+    hasSpace_.wait(lock, [this]{ return (queue_.empty() && numInFlight_ == 0) || error_; });
+    if (error_)
+        rethrow_exception(error_);
+
+    // background thread is idle & cannot take new records while we hold the lock
+    writer_->TryFlush();
+}
+
+void AsyncBamWriterPrivate::Run(void)
+{
+    deque<BamRecord> batch;
+    while (true) {
+
+        // take all currently queued records at once, rather than locking per record
+        {
+            unique_lock<mutex> lock(mutex_);
+            hasData_.wait(lock, [this]{ return !queue_.empty() || isClosing_; });
+            if (queue_.empty())
+                return; // closing & fully drained
+            batch.swap(queue_);
+            numInFlight_ = batch.size();
+        }
+        hasSpace_.notify_all();
+
+        // write outside of lock
+        try {
+            for (const BamRecord& record : batch)
+                writer_->Write(record);
+            batch.clear();
+        } catch (...) {
+            lock_guard<mutex> lock(mutex_);
+            error_ = current_exception();
+            numInFlight_ = 0;
+            queue_.clear();
+            hasSpace_.notify_all();
+            return;
+        }
+
+        {
+            lock_guard<mutex> lock(mutex_);
+            numInFlight_ = 0;
+        }
+        hasSpace_.notify_all();
+    }
+}
+
+void AsyncBamWriterPrivate::Stop(void)
+{
+    {
+        lock_guard<mutex> lock(mutex_);
+        isClosing_ = true;
+    }
+    hasData_.notify_one();
+    if (worker_.joinable())
+        worker_.join();
+}
+
+void AsyncBamWriterPrivate::ThrowIfClosed(void) const
+{
+    if (isClosed_)
+        throw std::runtime_error("AsyncBamWriter: cannot use writer after Close()");
+}
+
+void AsyncBamWriterPrivate::Write(BamRecord&& record)
+{
+    {
+        unique_lock<mutex> lock(mutex_);
+        ThrowIfClosed();
+
+        // backpressure: wait for background thread to catch up
+        hasSpace_.wait(lock, [this]{ return queue_.size() < maxQueueSize_ || error_; });
+        if (error_)
+            rethrow_exception(error_);
+
+        queue_.push_back(std::move(record));
+    }
+    hasData_.notify_one();
+}
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+// ---------------------------------
+// AsyncBamWriter implementation
+// ---------------------------------
+
+AsyncBamWriter::AsyncBamWriter(const std::string& filename,
+                               const BamHeader& header,
+                               const size_t maxQueueSize,
+                               const BamWriter::CompressionLevel compressionLevel,
+                               const size_t numThreads,
+                               const BamWriter::BinCalculationMode binCalculationMode,
+                               const BamWriter::IndexTypes indexTypes)
+    : d_(new internal::AsyncBamWriterPrivate(filename,
+                                             header,
+                                             maxQueueSize,
+                                             compressionLevel,
+                                             numThreads,
+                                             binCalculationMode,
+                                             indexTypes))
+{ }
+
+AsyncBamWriter::~AsyncBamWriter(void)
+{
+    try {
+        d_->Close();
+    } catch (std::exception&) {
+        // swallow, destructor cannot throw. Call Close() to observe errors.
+    }
+}
+
+void AsyncBamWriter::Close(void)
+{ d_->Close(); }
+
+void AsyncBamWriter::Flush(void)
+{ d_->Flush(); }
+
+void AsyncBamWriter::Write(const BamRecord& record)
+{ d_->Write(BamRecord(record)); }
+
+void AsyncBamWriter::Write(BamRecord&& record)
+{ d_->Write(std::move(record)); }
@@ -0,0 +1,143 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file BaiBuilder.cpp
+/// \brief Implements the BaiBuilder class.
+//
+// Author: Derek Barnett
+
+#include "BaiBuilder.h"
+#include "pbbam/BamRecord.h"
+#include <htslib/sam.h>
+#include <stdexcept>
+#include <cstdio>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace PacBio::BAM::internal;
+using namespace std;
+
+// min_shift=14 & n_lvls=5 are BAI "magic numbers"
+static const int BaiMinShift = 14;
+static const int BaiNumLevels = 5;
+
+// hts_idx_save() appends ".bai" to the filename provided, so we write to
+// "<bam>.tmp.bai" and let FileProducer rename it to "<bam>.bai"
+BaiBuilder::BaiBuilder(const string& bamFilename,
+                       const size_t numReferenceSequences,
+                       const int64_t headerEndOffset)
+    : FileProducer(bamFilename + ".bai", bamFilename + ".tmp.bai")
+    , index_(nullptr)
+    , hasPending_(false)
+    , failed_(false)
+{
+    if (bamFilename == "-")
+        throw std::runtime_error("cannot build BAI index for BAM written to stdout");
+
+    index_.reset(hts_idx_init(numReferenceSequences,
+                              HTS_FMT_BAI,
+                              headerEndOffset,
+                              BaiMinShift,
+                              BaiNumLevels));
+    if (!index_)
+        throw std::runtime_error("could not initialize BAI index");
+}
+
+void BaiBuilder::AddRecord(const BamRecord& record, const int64_t endOffset)
+{
+    if (failed_)
+        return;
+
+    if (hasPending_)
+        PushPending();
+
+    const auto rawRecord = BamRecordMemory::GetRawData(record);
+    pending_.tId_       = rawRecord->core.tid;
+    pending_.start_     = rawRecord->core.pos;
+    pending_.end_       = bam_endpos(rawRecord.get());
+    pending_.endOffset_ = endOffset;
+    pending_.isMapped_  = ((rawRecord->core.flag & BAM_FUNMAP) == 0);
+    hasPending_ = true;
+}
+
+void BaiBuilder::AmendLastOffset(const int64_t offset)
+{
+    if (hasPending_)
+        pending_.endOffset_ = offset;
+}
+
+void BaiBuilder::PushPending(void)
+{
+    // clear pending state before (possibly) throwing, so the same record is
+    // never pushed twice
+    hasPending_ = false;
+    const int ret = hts_idx_push(index_.get(),
+                                 pending_.tId_,
+                                 pending_.start_,
+                                 pending_.end_,
+                                 pending_.endOffset_,
+                                 pending_.isMapped_ ? 1 : 0);
+    if (ret < 0) {
+        failed_ = true;
+        throw std::runtime_error("could not build BAI index: records are not coordinate-sorted");
+    }
+}
+
+void BaiBuilder::Save(const int64_t eofOffset)
+{
+    // index abandoned after an earlier error
+    if (failed_)
+        return;
+
+    // last record ends where the EOF marker block starts
+    if (hasPending_) {
+        AmendLastOffset(eofOffset);
+        PushPending();
+    }
+
+    // hts_idx_finish() & hts_idx_save() do not report errors in the htslib
+    // versions we support, so check the result by loading it back in
+    hts_idx_finish(index_.get(), eofOffset);
+
+    const string& tempFilename = TempFilename();
+    const string tempStem = tempFilename.substr(0, tempFilename.size() - 4); // strip ".bai"
+    hts_idx_save(index_.get(), tempStem.c_str(), HTS_FMT_BAI);
+
+    std::unique_ptr<hts_idx_t, HtslibIndexDeleter> saved(hts_idx_load(tempStem.c_str(), HTS_FMT_BAI));
+    if (!saved) {
+        std::remove(tempFilename.c_str());
+        throw std::runtime_error("could not write BAI index file: " + TargetFilename());
+    }
+}
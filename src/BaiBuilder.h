@@ -0,0 +1,123 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file BaiBuilder.h
+/// \brief Defines the BaiBuilder class.
+//
+// Author: Derek Barnett
+
+#ifndef BAIBUILDER_H
+#define BAIBUILDER_H
+
+#include "FileProducer.h"
+#include "MemoryUtils.h"
+#include <htslib/hts.h>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+namespace PacBio {
+namespace BAM {
+
+class BamRecord;
+
+namespace internal {
+
+// The BaiBuilder class builds a standard BAI index from records & their
+// virtual offsets, as they are written (or read), instead of re-reading the
+// entire BAM file afterward (e.g. bam_index_build).
+//
+// Like htslib, AddRecord() expects the virtual offset just past the *end* of
+// each record (i.e. bgzf_tell() after it is written or read). The index is
+// initialized with the offset at the end of the header.
+//
+// A writer that starts a new BGZF block before the next record should call
+// AmendLastOffset() with the new block's offset, so the previous record ends
+// where a reader would see it end. This mirrors htslib's hts_idx_amend_last(),
+// and is why each record is pushed to the index one step behind.
+//
+// Records must be provided in coordinate-sorted order. Once a record is
+// rejected, the index is abandoned: further records are ignored & Save() does
+// not write an index file.
+//
+class BaiBuilder : public FileProducer
+{
+public:
+    BaiBuilder(const std::string& bamFilename,
+               const size_t numReferenceSequences,
+               const int64_t headerEndOffset);
+
+public:
+    // Since records are pushed one step behind, an out-of-order record is
+    // reported by the following AddRecord() or by Save(). Both throw in that
+    // case.
+    void AddRecord(const BamRecord& record, const int64_t endOffset);
+
+    // offset: virtual offset of a new BGZF block, started immediately after
+    // the last record added
+    void AmendLastOffset(const int64_t offset);
+
+    // eofOffset: virtual offset just past the last record (i.e. the start of
+    // the BGZF EOF marker block)
+    //
+    // Throws if the index could not be finished or written. No index file is
+    // left behind in that case.
+    void Save(const int64_t eofOffset);
+
+private:
+    void PushPending(void);
+
+private:
+    struct PendingRecord
+    {
+        int32_t tId_;
+        int32_t start_;
+        int32_t end_;
+        int64_t endOffset_;
+        bool isMapped_;
+    };
+
+    std::unique_ptr<hts_idx_t, HtslibIndexDeleter> index_;
+    PendingRecord pending_;
+    bool hasPending_;
+    bool failed_;
+};
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+#endif // BAIBUILDER_H
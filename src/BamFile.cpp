@@ -40,7 +40,10 @@
 // Author: Derek Barnett
 
 #include "pbbam/BamFile.h"
+#include "pbbam/BamReader.h"
+#include "pbbam/PbiBuilder.h"
 #include "pbbam/PbiFile.h"
+#include "BaiBuilder.h"
 #include "FileUtils.h"
 #include "MemoryUtils.h"
 #include <htslib/sam.h>
@@ -164,6 +167,31 @@ BamFile& BamFile::operator=(BamFile&& other)
 
 BamFile::~BamFile(void) { }
 
+void BamFile::CreateIndexes(const size_t numThreads) const
+{
+    const size_t numReferences = d_->header_.Sequences().size();
+    BamReader reader(*this);
+    int64_t offset = reader.VirtualTell();
+
+    internal::BaiBuilder baiBuilder(d_->filename_, numReferences, offset);
+    PbiBuilder pbiBuilder(PacBioIndexFilename(),
+                          numReferences,
+                          PbiBuilder::DefaultCompression,
+                          numThreads);
+
+    // feed both builders from the same record offsets: the PBI wants each
+    // record's start, the BAI its end
+    BamRecord b;
+    while (reader.GetNext(b)) {
+        pbiBuilder.AddRecord(b, offset);
+        offset = reader.VirtualTell();
+        baiBuilder.AddRecord(b, offset);
+    }
+
+    // offset now at start of EOF marker
+    baiBuilder.Save(offset);
+}
+
 void BamFile::CreatePacBioIndex(void) const
 {
     PbiFile::CreateFrom(*this);
@@ -0,0 +1,423 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file BamFileConcatenator.cpp
+/// \brief Implements the BamFileConcatenator class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/BamFileConcatenator.h"
+#include "pbbam/BamHeader.h"
+#include "pbbam/PbiRawData.h"
+#include "FileProducer.h"
+#include "FileUtils.h"
+#include "MemoryUtils.h"
+#include "PbiIndexIO.h"
+#include <htslib/bgzf.h>
+#include <htslib/hfile.h>
+#include <htslib/sam.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <cassert>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// length of the empty BGZF block marking end-of-file
+static const int64_t BgzfEofLength = 28;
+
+// raw copy buffer size
+static const size_t CopyBufferSize = 0x400000;
+
+// ---------------------------------
+// ConcatenatedInput implementation
+// ---------------------------------
+
+// Describes where an input file's data landed in the concatenated output, and
+// rebases the input's virtual file offsets accordingly.
+//
+// Input data is laid out in 2 parts:
+//  - (optional) the remainder of the block containing the end of the input's
+//    header. These bytes are re-compressed into 1 or 2 new output blocks.
+//  - all subsequent blocks, which are copied verbatim.
+//
+struct ConcatenatedInput
+{
+public:
+    ConcatenatedInput(void)
+        : firstBlockAddress_(0)
+        , firstBlockOffset_(0)
+        , rawInputStart_(0)
+        , rawOutputStart_(0)
+    { }
+
+    int64_t Rebase(const int64_t vOffset) const
+    {
+        const int64_t address = vOffset >> 16;
+        const int64_t offset  = vOffset & 0xFFFF;
+
+        // record is in re-compressed remainder of first block
+        if (address < rawInputStart_) {
+            assert(address == firstBlockAddress_);
+            int64_t delta = offset - firstBlockOffset_;
+            for (const auto& block : rewrittenBlocks_) {
+                if (delta < block.second)
+                    return (block.first << 16) | delta;
+                delta -= block.second;
+            }
+            return (rawOutputStart_ << 16) | delta;
+        }
+
+        // record is in verbatim-copied block
+        return ((address - rawInputStart_ + rawOutputStart_) << 16) | offset;
+    }
+
+public:
+    int64_t firstBlockAddress_;
+    int64_t firstBlockOffset_;
+    vector<pair<int64_t, int64_t> > rewrittenBlocks_; // (output address, data length)
+    int64_t rawInputStart_;
+    int64_t rawOutputStart_;
+};
+
+// -------------------------------------------
+// BamFileConcatenatorPrivate implementation
+// -------------------------------------------
+
+class BamFileConcatenatorPrivate : public internal::FileProducer
+{
+public:
+    BamFileConcatenatorPrivate(const string& filename,
+                               const BamHeader& header);
+
+public:
+    ConcatenatedInput Append(const BamFile& file);
+
+private:
+    unique_ptr<BGZF, HtslibBgzfDeleter> bgzf_;
+    vector<char> buffer_;
+};
+
+BamFileConcatenatorPrivate::BamFileConcatenatorPrivate(const string& filename,
+                                                       const BamHeader& header)
+    : internal::FileProducer(filename)
+    , bgzf_(nullptr)
+    , buffer_(CopyBufferSize)
+{
+    const string& usingFilename = TempFilename();
+    bgzf_.reset(bgzf_open(usingFilename.c_str(), "wb"));
+    if (!bgzf_)
+        throw std::runtime_error("could not open file for writing");
+
+    // write header, flushing so that appended data starts on a block boundary
+    const auto rawHeader = BamHeaderMemory::MakeRawHeader(header);
+    if (bam_hdr_write(bgzf_.get(), rawHeader.get()) != 0 || bgzf_flush(bgzf_.get()) != 0)
+        throw std::runtime_error("could not write header");
+}
+
+ConcatenatedInput BamFileConcatenatorPrivate::Append(const BamFile& file)
+{
+    const string& fn = file.Filename();
+    if (fn == "-")
+        throw std::runtime_error("cannot concatenate streamed input");
+
+    unique_ptr<BGZF, HtslibBgzfDeleter> input(bgzf_open(fn.c_str(), "rb"));
+    if (!input)
+        throw std::runtime_error(string("could not open BAM file: ") + fn);
+    BGZF* in  = input.get();
+    BGZF* out = bgzf_.get();
+
+    ConcatenatedInput result;
+    const int64_t firstOffset = file.FirstAlignmentOffset();
+    result.firstBlockAddress_ = firstOffset >> 16;
+    result.firstBlockOffset_  = firstOffset & 0xFFFF;
+    result.rawInputStart_     = result.firstBlockAddress_;
+
+    // if the header's last block also holds record data, re-compress that
+    // remainder (BGZF_BLOCK_SIZE bytes at a time, like bgzf_write)
+    if (result.firstBlockOffset_ > 0) {
+        if (bgzf_seek(in, result.firstBlockAddress_ << 16, SEEK_SET) < 0 ||
+            bgzf_read_block(in) != 0)
+        {
+            throw std::runtime_error(string("could not read BAM file: ") + fn);
+        }
+
+        const char* data = static_cast<const char*>(in->uncompressed_block) + result.firstBlockOffset_;
+        int64_t remaining = in->block_length - result.firstBlockOffset_;
+        while (remaining > 0) {
+            const int64_t length = std::min(remaining, static_cast<int64_t>(BGZF_BLOCK_SIZE));
+            const int64_t address = htell(out->fp);
+            if (bgzf_write(out, data, length) != length || bgzf_flush(out) != 0)
+                throw std::runtime_error("could not write record data");
+            result.rewrittenBlocks_.push_back(make_pair(address, length));
+            data += length;
+            remaining -= length;
+        }
+        result.rawInputStart_ = htell(in->fp);
+    }
+
+    // copy remaining blocks verbatim, skipping the input's EOF marker
+    int64_t rawInputEnd = internal::FileUtils::Size(fn);
+    if (file.HasEOF())
+        rawInputEnd -= BgzfEofLength;
+
+    result.rawOutputStart_ = htell(out->fp);
+    if (hseek(in->fp, result.rawInputStart_, SEEK_SET) < 0)
+        throw std::runtime_error(string("could not read BAM file: ") + fn);
+
+    int64_t remaining = rawInputEnd - result.rawInputStart_;
+    while (remaining > 0) {
+        const size_t length = static_cast<size_t>(std::min(remaining, static_cast<int64_t>(buffer_.size())));
+        if (bgzf_raw_read(in, &buffer_[0], length) != static_cast<ssize_t>(length))
+            throw std::runtime_error(string("could not read BAM file: ") + fn);
+        if (bgzf_raw_write(out, &buffer_[0], length) != static_cast<ssize_t>(length))
+            throw std::runtime_error("could not write record data");
+        remaining -= length;
+    }
+    return result;
+}
+
+// -------------------------
+// PBI concatenation helpers
+// -------------------------
+
+template<typename T>
+static inline void Append(vector<T>& dest, const vector<T>& src)
+{ dest.insert(dest.end(), src.cbegin(), src.cend()); }
+
+// Merges reference entries of (individually sorted) inputs. Returns false if
+// the result would not be coordinate-sorted, in which case the output PBI
+// should not include reference data.
+static bool MergeReferenceData(const vector<PbiRawData>& indices,
+                               PbiRawReferenceData& result)
+{
+    map<uint32_t, PbiReferenceEntry> entries;
+    PbiReferenceEntry::Row rowOffset = 0;
+    const PbiRawData* previous = nullptr;
+    for (const auto& index : indices) {
+        const uint32_t numReads = index.NumReads();
+        if (numReads == 0)
+            continue;
+
+        // compare last record of previous input with first record of this one
+        if (previous) {
+            const auto& prevMapped = previous->MappedData();
+            const auto& mapped = index.MappedData();
+            const size_t lastRow = previous->NumReads() - 1;
+            const uint32_t prevTId = static_cast<uint32_t>(prevMapped.tId_.at(lastRow));
+            const uint32_t tId     = static_cast<uint32_t>(mapped.tId_.at(0));
+            if (prevTId > tId)
+                return false;
+            if (prevTId == tId &&
+                tId != PbiReferenceEntry::UNMAPPED_ID &&
+                prevMapped.tStart_.at(lastRow) > mapped.tStart_.at(0))
+            {
+                return false;
+            }
+        }
+
+        // update (or add) entry row ranges
+        for (const auto& entry : index.ReferenceData().entries_) {
+            auto iter = entries.find(entry.tId_);
+            if (iter == entries.end())
+                iter = entries.insert(make_pair(entry.tId_, PbiReferenceEntry(entry.tId_))).first;
+            if (entry.beginRow_ == PbiReferenceEntry::UNSET_ROW)
+                continue;
+
+            PbiReferenceEntry& merged = iter->second;
+            if (merged.beginRow_ == PbiReferenceEntry::UNSET_ROW)
+                merged.beginRow_ = entry.beginRow_ + rowOffset;
+            else if (merged.endRow_ != entry.beginRow_ + rowOffset)
+                return false;
+            merged.endRow_ = entry.endRow_ + rowOffset;
+        }
+
+        rowOffset += numReads;
+        previous = &index;
+    }
+
+    // store entries, sorted on tId (unmapped last)
+    result.entries_.clear();
+    result.entries_.reserve(entries.size());
+    for (const auto& e : entries)
+        result.entries_.push_back(e.second);
+    return true;
+}
+
+static PbiRawData ConcatenateIndices(const vector<PbiRawData>& indices,
+                                     const vector<ConcatenatedInput>& layouts)
+{
+    assert(indices.size() == layouts.size());
+
+    // only keep optional sections present in all (non-empty) inputs
+    uint32_t numReads = 0;
+    bool hasMappedData = true;
+    bool hasBarcodeData = true;
+    bool hasReferenceData = true;
+    for (const auto& index : indices) {
+        if (index.NumReads() == 0)
+            continue;
+        numReads += index.NumReads();
+        hasMappedData    &= index.HasMappedData();
+        hasBarcodeData   &= index.HasBarcodeData();
+        hasReferenceData &= index.HasReferenceData();
+    }
+
+    PbiRawData result;
+    result.NumReads(numReads);
+    PbiRawBasicData& basicData = result.BasicData();
+    PbiRawMappedData& mappedData = result.MappedData();
+    PbiRawBarcodeData& barcodeData = result.BarcodeData();
+
+    for (size_t i = 0; i < indices.size(); ++i) {
+        const PbiRawData& index = indices.at(i);
+        if (index.NumReads() == 0)
+            continue;
+
+        const PbiRawBasicData& basic = index.BasicData();
+        Append(basicData.rgId_,       basic.rgId_);
+        Append(basicData.qStart_,     basic.qStart_);
+        Append(basicData.qEnd_,       basic.qEnd_);
+        Append(basicData.holeNumber_, basic.holeNumber_);
+        Append(basicData.readQual_,   basic.readQual_);
+        Append(basicData.ctxtFlag_,   basic.ctxtFlag_);
+
+        const ConcatenatedInput& layout = layouts.at(i);
+        basicData.fileOffset_.reserve(basicData.fileOffset_.size() + basic.fileOffset_.size());
+        for (const int64_t offset : basic.fileOffset_)
+            basicData.fileOffset_.push_back(layout.Rebase(offset));
+
+        if (hasMappedData) {
+            const PbiRawMappedData& mapped = index.MappedData();
+            Append(mappedData.tId_,       mapped.tId_);
+            Append(mappedData.tStart_,    mapped.tStart_);
+            Append(mappedData.tEnd_,      mapped.tEnd_);
+            Append(mappedData.aStart_,    mapped.aStart_);
+            Append(mappedData.aEnd_,      mapped.aEnd_);
+            Append(mappedData.revStrand_, mapped.revStrand_);
+            Append(mappedData.nM_,        mapped.nM_);
+            Append(mappedData.nMM_,       mapped.nMM_);
+            Append(mappedData.mapQV_,     mapped.mapQV_);
+        }
+
+        if (hasBarcodeData) {
+            const PbiRawBarcodeData& barcode = index.BarcodeData();
+            Append(barcodeData.bcForward_, barcode.bcForward_);
+            Append(barcodeData.bcReverse_, barcode.bcReverse_);
+            Append(barcodeData.bcQual_,    barcode.bcQual_);
+        }
+    }
+
+    if (hasMappedData && hasReferenceData)
+        hasReferenceData = MergeReferenceData(indices, result.ReferenceData());
+    else
+        hasReferenceData = false;
+
+    // determine flags
+    PbiFile::Sections sections = PbiFile::BASIC;
+    if (numReads > 0) {
+        if (hasMappedData)    sections |= PbiFile::MAPPED;
+        if (hasBarcodeData)   sections |= PbiFile::BARCODE;
+        if (hasReferenceData) sections |= PbiFile::REFERENCE;
+    }
+    result.FileSections(sections);
+    return result;
+}
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+// ------------------------------------
+// BamFileConcatenator implementation
+// ------------------------------------
+
+void BamFileConcatenator::Concatenate(const vector<BamFile>& inputFiles,
+                                      const string& outputFilename,
+                                      const ProgramInfo& program,
+                                      bool createPbi)
+{
+    if (inputFiles.empty())
+        throw std::runtime_error("no input files provided to BamFileConcatenator");
+
+    if (outputFilename.empty())
+        throw std::runtime_error("no output filename provided to BamFileConcatenator");
+
+    // merge headers, records are copied verbatim so reference IDs must agree
+    BamHeader mergedHeader = inputFiles.front().Header().DeepCopy();
+    for (size_t i = 1; i < inputFiles.size(); ++i) {
+        const BamHeader& header = inputFiles.at(i).Header();
+        if (header.Sequences() != mergedHeader.Sequences())
+            throw std::runtime_error("BAM file sequence lists (@SQ entries) do not match, aborting concatenation");
+        mergedHeader += header;
+    }
+    if (program.IsValid())
+        mergedHeader.AddProgram(program);
+
+    // load input indices up front, so we fail before writing anything
+    const bool usingPbi = createPbi && (outputFilename != "-");
+    vector<PbiRawData> indices;
+    if (usingPbi) {
+        indices.reserve(inputFiles.size());
+        for (const auto& file : inputFiles) {
+            if (!file.PacBioIndexExists())
+                throw std::runtime_error("missing PBI file for input: " + file.Filename());
+            indices.emplace_back(file.PacBioIndexFilename());
+        }
+    }
+
+    // write BAM (closed & renamed at end of scope)
+    vector<internal::ConcatenatedInput> layouts;
+    layouts.reserve(inputFiles.size());
+    {
+        internal::BamFileConcatenatorPrivate writer(outputFilename, mergedHeader);
+        for (const auto& file : inputFiles)
+            layouts.push_back(writer.Append(file));
+    }
+
+    // write PBI
+    if (usingPbi) {
+        const PbiRawData index = internal::ConcatenateIndices(indices, layouts);
+        internal::PbiIndexIO::Save(index, outputFilename + ".pbi");
+    }
+}
@@ -0,0 +1,347 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file BamFileCopier.cpp
+/// \brief Implements the BamFileCopier class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/BamFileCopier.h"
+#include "pbbam/BamHeader.h"
+#include "pbbam/PbiBuilder.h"
+#include "pbbam/PbiRawData.h"
+#include "FileProducer.h"
+#include "FileUtils.h"
+#include "MemoryUtils.h"
+#include <htslib/bgzf.h>
+#include <htslib/hfile.h>
+#include <htslib/sam.h>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <cassert>
+#include <cstdint>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// length of the empty BGZF block marking end-of-file
+static const int64_t BgzfEofLength = 28;
+
+// BGZF block header layout
+static const size_t BgzfHeaderLength = 18;
+static const size_t BgzfBlockSizeOffset = 16;
+
+// accepted record's position in the output, for building its PBI
+struct CopiedRow
+{
+    size_t inputIndex_;
+    uint32_t row_;
+    int64_t vOffset_;
+};
+
+// ---------------------------------
+// BamFileCopierPrivate implementation
+// ---------------------------------
+
+class BamFileCopierPrivate : public internal::FileProducer
+{
+public:
+    BamFileCopierPrivate(const string& filename,
+                         const BamHeader& header);
+
+public:
+    // Appends accepted records of file, according to its index. Fills
+    // newOffsets (per input row) with the output virtual offset of each
+    // accepted record, or -1 if not accepted.
+    void Append(const BamFile& file,
+                const PbiRawData& index,
+                const vector<bool>& accepted,
+                vector<int64_t>& newOffsets);
+
+private:
+    int64_t ReadBlockLength(BGZF* in, const int64_t address, const string& fn);
+    void CopyBlock(BGZF* in, const int64_t address, const int64_t length, const string& fn);
+
+private:
+    unique_ptr<BGZF, HtslibBgzfDeleter> bgzf_;
+    vector<char> buffer_;
+};
+
+BamFileCopierPrivate::BamFileCopierPrivate(const string& filename,
+                                           const BamHeader& header)
+    : internal::FileProducer(filename)
+    , bgzf_(nullptr)
+    , buffer_(BGZF_MAX_BLOCK_SIZE)
+{
+    const string& usingFilename = TempFilename();
+    bgzf_.reset(bgzf_open(usingFilename.c_str(), "wb"));
+    if (!bgzf_)
+        throw std::runtime_error("could not open file for writing");
+
+    const auto rawHeader = BamHeaderMemory::MakeRawHeader(header);
+    if (bam_hdr_write(bgzf_.get(), rawHeader.get()) != 0)
+        throw std::runtime_error("could not write header");
+}
+
+void BamFileCopierPrivate::Append(const BamFile& file,
+                                  const PbiRawData& index,
+                                  const vector<bool>& accepted,
+                                  vector<int64_t>& newOffsets)
+{
+    const string& fn = file.Filename();
+    if (fn == "-")
+        throw std::runtime_error("cannot copy streamed input");
+
+    unique_ptr<BGZF, HtslibBgzfDeleter> input(bgzf_open(fn.c_str(), "rb"));
+    if (!input)
+        throw std::runtime_error(string("could not open BAM file: ") + fn);
+    BGZF* in  = input.get();
+    BGZF* out = bgzf_.get();
+
+    const vector<int64_t>& starts = index.BasicData().fileOffset_;
+    const size_t numRecords = starts.size();
+    newOffsets.assign(numRecords, -1);
+    if (numRecords == 0)
+        return;
+
+    // record data ends at EOF marker (or end of file)
+    int64_t rawEnd = internal::FileUtils::Size(fn);
+    if (file.HasEOF())
+        rawEnd -= BgzfEofLength;
+    const int64_t dataEnd = rawEnd << 16;
+
+    // each record ends where the next one starts
+    auto recordEnd = [&](const size_t i) -> int64_t
+    { return (i + 1 < numRecords) ? starts.at(i+1) : dataEnd; };
+
+    const int64_t firstOffset  = file.FirstAlignmentOffset();
+    const int64_t firstAddress = firstOffset >> 16;
+
+    size_t first = 0; // first record not yet fully consumed
+    int64_t address = firstAddress;
+    while (address < rawEnd) {
+        const int64_t blockLength = ReadBlockLength(in, address, fn);
+        const int64_t blockStart = address << 16;
+        const int64_t blockEnd   = (address + blockLength) << 16;
+
+        // find records overlapping this block
+        while (first < numRecords && recordEnd(first) <= blockStart)
+            ++first;
+        size_t last = first;
+        bool allAccepted = true;
+        while (last < numRecords && starts.at(last) < blockEnd) {
+            allAccepted &= accepted.at(last);
+            ++last;
+        }
+
+        // block holds only header (or no) data
+        if (first == last) {
+            address += blockLength;
+            continue;
+        }
+
+        // block holds only accepted record data, copy as-is
+        const bool hasHeaderData = (address == firstAddress && (firstOffset & 0xFFFF) > 0);
+        if (allAccepted && !hasHeaderData) {
+
+            // end current output block, so this one starts on a boundary
+            if (bgzf_flush(out) != 0)
+                throw std::runtime_error("could not write record data");
+            const int64_t outputAddress = htell(out->fp);
+
+            // records whose first bytes land here (usually, those starting here)
+            for (size_t i = first; i < last; ++i) {
+                if (newOffsets.at(i) != -1)
+                    continue;
+                const int64_t start = starts.at(i);
+                const int64_t localStart = ((start >> 16) == address) ? (start & 0xFFFF) : 0;
+                newOffsets.at(i) = (outputAddress << 16) | localStart;
+            }
+            CopyBlock(in, address, blockLength, fn);
+        }
+
+        // otherwise, re-compress only the accepted byte ranges
+        else {
+            if (bgzf_seek(in, blockStart, SEEK_SET) < 0 || bgzf_read_block(in) != 0)
+                throw std::runtime_error(string("could not read BAM file: ") + fn);
+            const char* data = static_cast<const char*>(in->uncompressed_block);
+
+            for (size_t i = first; i < last; ++i) {
+                if (!accepted.at(i))
+                    continue;
+                const int64_t start = starts.at(i);
+                const int64_t end   = recordEnd(i);
+                const int64_t localStart = ((start >> 16) == address) ? (start & 0xFFFF) : 0;
+                const int64_t localEnd   = ((end >> 16) == address) ? (end & 0xFFFF) : in->block_length;
+                if (localEnd <= localStart)
+                    continue;
+
+                if (newOffsets.at(i) == -1)
+                    newOffsets.at(i) = bgzf_tell(out);
+                const int64_t length = localEnd - localStart;
+                if (bgzf_write(out, data + localStart, length) != length)
+                    throw std::runtime_error("could not write record data");
+            }
+        }
+
+        address += blockLength;
+    }
+}
+
+void BamFileCopierPrivate::CopyBlock(BGZF* in,
+                                     const int64_t address,
+                                     const int64_t length,
+                                     const string& fn)
+{
+    BGZF* out = bgzf_.get();
+    if (hseek(in->fp, address, SEEK_SET) < 0 ||
+        bgzf_raw_read(in, &buffer_[0], length) != length)
+    {
+        throw std::runtime_error(string("could not read BAM file: ") + fn);
+    }
+    if (bgzf_raw_write(out, &buffer_[0], length) != length)
+        throw std::runtime_error("could not write record data");
+
+    // raw writes bypass BGZF's bookkeeping, keep bgzf_tell() correct
+    out->block_address = htell(out->fp);
+}
+
+int64_t BamFileCopierPrivate::ReadBlockLength(BGZF* in,
+                                              const int64_t address,
+                                              const string& fn)
+{
+    uint8_t header[BgzfHeaderLength];
+    if (hseek(in->fp, address, SEEK_SET) < 0 ||
+        bgzf_raw_read(in, header, BgzfHeaderLength) != static_cast<ssize_t>(BgzfHeaderLength))
+    {
+        throw std::runtime_error(string("could not read BAM file: ") + fn);
+    }
+
+    // gzip magic & 'BC' extra subfield
+    if (header[0] != 31 || header[1] != 139 || header[12] != 'B' || header[13] != 'C')
+        throw std::runtime_error(string("invalid BGZF block in BAM file: ") + fn);
+
+    const int64_t blockSize = header[BgzfBlockSizeOffset] | (header[BgzfBlockSizeOffset+1] << 8);
+    return blockSize + 1;
+}
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+// ------------------------------
+// BamFileCopier implementation
+// ------------------------------
+
+void BamFileCopier::Copy(const vector<BamFile>& inputFiles,
+                         const PbiFilter& filter,
+                         const string& outputFilename,
+                         const ProgramInfo& program,
+                         bool createPbi)
+{
+    if (inputFiles.empty())
+        throw std::runtime_error("no input files provided to BamFileCopier");
+
+    if (outputFilename.empty())
+        throw std::runtime_error("no output filename provided to BamFileCopier");
+
+    // merge headers, records are copied verbatim so reference IDs must agree
+    BamHeader mergedHeader = inputFiles.front().Header().DeepCopy();
+    for (size_t i = 1; i < inputFiles.size(); ++i) {
+        const BamHeader& header = inputFiles.at(i).Header();
+        if (header.Sequences() != mergedHeader.Sequences())
+            throw std::runtime_error("BAM file sequence lists (@SQ entries) do not match, aborting copy");
+        mergedHeader += header;
+    }
+    if (program.IsValid())
+        mergedHeader.AddProgram(program);
+
+    // load input indices & apply filter up front, so we fail before writing anything
+    vector<PbiRawData> indices;
+    vector<vector<bool> > accepted;
+    indices.reserve(inputFiles.size());
+    accepted.reserve(inputFiles.size());
+    for (const auto& file : inputFiles) {
+        if (!file.PacBioIndexExists())
+            throw std::runtime_error("missing PBI file for input: " + file.Filename());
+        indices.emplace_back(file.PacBioIndexFilename());
+
+        const PbiRawData& index = indices.back();
+        const uint32_t numReads = index.NumReads();
+        vector<bool> passes(numReads, false);
+        for (uint32_t row = 0; row < numReads; ++row)
+            passes[row] = filter.Accepts(index, row);
+        accepted.push_back(std::move(passes));
+    }
+
+    // write BAM (closed & renamed at end of scope)
+    vector<internal::CopiedRow> copiedRows;
+    {
+        internal::BamFileCopierPrivate writer(outputFilename, mergedHeader);
+        vector<int64_t> newOffsets;
+        for (size_t i = 0; i < inputFiles.size(); ++i) {
+            writer.Append(inputFiles.at(i), indices.at(i), accepted.at(i), newOffsets);
+            for (uint32_t row = 0; row < newOffsets.size(); ++row) {
+                if (newOffsets.at(row) != -1)
+                    copiedRows.push_back(internal::CopiedRow{ i, row, newOffsets.at(row) });
+            }
+        }
+    }
+
+    // write PBI, from input rows
+    if (createPbi && outputFilename != "-") {
+        PbiBuilder builder(outputFilename + ".pbi", mergedHeader.NumSequences());
+        for (const auto& copied : copiedRows)
+            builder.AddRow(indices.at(copied.inputIndex_), copied.row_, copied.vOffset_);
+    }
+}
+
+void BamFileCopier::Copy(const DataSet& dataset,
+                         const string& outputFilename,
+                         const ProgramInfo& program,
+                         bool createPbi)
+{
+    Copy(dataset.BamFiles(),
+         PbiFilter::FromDataSet(dataset),
+         outputFilename,
+         program,
+         createPbi);
+}
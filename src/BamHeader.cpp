@@ -40,6 +40,7 @@
 // Author: Derek Barnett
 
 #include "pbbam/BamHeader.h"
+#include "ReadGroupTable.h"
 #include "StringUtils.h"
 #include "Version.h"
 #include <htslib/hts.h>
@@ -292,11 +293,26 @@ vector<ReadGroupInfo> BamHeader::ReadGroups(void) const
     return result;
 }
 
+const internal::ReadGroupTable& BamHeader::ReadGroupLookupTable(void) const
+{
+    const internal::ReadGroupTable* table = d_->readGroupTable_.load(std::memory_order_acquire);
+    if (table)
+        return *table;
+
+    std::lock_guard<std::mutex> lock(d_->readGroupTableMutex_);
+    if (!d_->readGroupTableData_) {
+        d_->readGroupTableData_ = std::make_shared<internal::ReadGroupTable>(d_->readGroups_);
+        d_->readGroupTable_.store(d_->readGroupTableData_.get(), std::memory_order_release);
+    }
+    return *d_->readGroupTableData_;
+}
+
 BamHeader& BamHeader::ReadGroups(const vector<ReadGroupInfo>& readGroups)
 {
     d_->readGroups_.clear();
     for (const ReadGroupInfo& rg : readGroups)
         d_->readGroups_[rg.Id()] = rg;
+    d_->InvalidateReadGroupTable();
     return *this;
 }
 
@@ -139,9 +139,10 @@ const BamHeader& BamReader::Header(void) const
 bool BamReader::GetNext(BamRecord& record)
 {
     assert(Bgzf());
-    assert(internal::BamRecordMemory::GetRawData(record).get());
+    bam1_t* rawData = internal::BamRecordMemory::GetRawDataForOverwrite(record);
+    assert(rawData);
 
-    auto result = ReadRawData(Bgzf(), internal::BamRecordMemory::GetRawData(record).get());
+    auto result = ReadRawData(Bgzf(), rawData);
 
     // success
     if (result >= 0) {
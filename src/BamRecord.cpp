@@ -43,12 +43,16 @@
 #include "pbbam/virtual/VirtualRegionTypeMap.h"
 #include "pbbam/ZmwTypeMap.h"
 #include "AssertUtils.h"
+#include "BamRecordTags.h"
 #include "MemoryUtils.h"
+#include "ReadGroupTable.h"
 #include "SequenceUtils.h"
 #include <boost/numeric/conversion/cast.hpp>
 #include <htslib/sam.h>
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
+#include <cstring>
 
 using namespace PacBio;
 using namespace PacBio::BAM;
@@ -58,52 +62,33 @@ namespace PacBio {
 namespace BAM {
 namespace internal {
 
-// BAM record tag names
-static const string tagName_alternative_labelQV     = "pv";
-static const string tagName_alternative_labelTag    = "pt";
-static const string tagName_barcodes                = "bc";
-static const string tagName_barcode_quality         = "bq";
-static const string tagName_contextFlags            = "cx";
-static const string tagName_holeNumber              = "zm";
-static const string tagName_deletionQV              = "dq";
-static const string tagName_deletionTag             = "dt";
-static const string tagName_insertionQV             = "iq";
-static const string tagName_ipd                     = "ip";
-static const string tagName_labelQV                 = "pq";
-static const string tagName_mergeQV                 = "mq";
-static const string tagName_numPasses               = "np";
-static const string tagName_pkmean                  = "pa";
-static const string tagName_pkmid                   = "pm";
-static const string tagName_pkmean2                 = "ps";
-static const string tagName_pkmid2                  = "pi";
-static const string tagName_pre_pulse_frames        = "pd";
-static const string tagName_pulse_call              = "pc";
-static const string tagName_pulse_call_width        = "px";
-static const string tagName_pulseMergeQV            = "pg";
-static const string tagName_pulseWidth              = "pw";
-static const string tagName_queryStart              = "qs";
-static const string tagName_queryEnd                = "qe";
-static const string tagName_readAccuracy            = "rq";
-static const string tagName_readGroup               = "RG";
-static const string tagName_scrap_region_type       = "sc";
-static const string tagName_scrap_zmw_type          = "sz";
-static const string tagName_snr                     = "sn";
-static const string tagName_startFrame              = "sf";
-static const string tagName_substitutionQV          = "sq";
-static const string tagName_substitutionTag         = "st";
-
-// faux (helper) tag names
-static const string tagName_QUAL = "QUAL";
-static const string tagName_SEQ  = "SEQ";
-
-// record type names
-static const string recordTypeName_ZMW        = "ZMW";
-static const string recordTypeName_Polymerase = "POLYMERASE";
-static const string recordTypeName_HqRegion   = "HQREGION";
-static const string recordTypeName_Subread    = "SUBREAD";
-static const string recordTypeName_CCS        = "CCS";
-static const string recordTypeName_Scrap      = "SCRAP";
-static const string recordTypeName_Unknown    = "UNKNOWN";
+// Looks up the record's read group (by its RG tag) in the header's
+// pre-parsed table. Returns nullptr if the tag or read group is missing.
+static
+const ReadGroupTableEntry* FindReadGroup(const BamRecordImpl& impl,
+                                         const BamHeader& header)
+{
+    const TagView rgTag = impl.TagValueView(tagName_readGroup);
+    if (!rgTag.IsString())
+        return nullptr;
+    return header.ReadGroupLookupTable().Find(rgTag.Chars(), rgTag.Size());
+}
+
+// Determines record type from its read group, without throwing. If the read
+// group is missing, peeks at the record name to see if we're CCS.
+static
+RecordType LookupRecordType(const BamRecordImpl& impl,
+                            const BamHeader& header)
+{
+    const auto* rg = FindReadGroup(impl, header);
+    if (rg != nullptr)
+        return rg->type_;
+
+    const bam1_t* b = BamRecordMemory::GetRawData(impl).get();
+    if (b->core.l_qname > 0 && strstr(bam_get_qname(b), "ccs") != nullptr)
+        return RecordType::CCS;
+    return RecordType::UNKNOWN;
+}
 
 static
 int32_t HoleNumberFromName(const string& fullName)
@@ -126,6 +111,43 @@ Position QueryEndFromName(const string& fullName)
     return stoi(queryTokens.at(1));
 }
 
+// Reads frame data directly from the record's tag data, into an existing
+// Frames object. Lossless (uint16) values are copied as-is. Lossy (uint8) codes
+// are decoded, or just widened when 'decodeCodes' is false (for the *Raw()
+// accessors).
+static
+void FramesFromTagView(const TagView& view, const bool decodeCodes, Frames* frames)
+{
+    assert(frames);
+    vector<uint16_t>& data = frames->DataRaw();
+    if (view.IsNull()) {
+        data.clear();
+        return;
+    }
+
+    // lossy frame codes
+    if (view.Type() == TagDataType::UINT8_ARRAY) {
+        if (decodeCodes)
+            Frames::Decode(view.RawData(), view.Size(), frames);
+        else
+            data.assign(view.RawData(), view.RawData() + view.Size());
+        return;
+    }
+
+    // lossless frame data
+    assert(view.Type() == TagDataType::UINT16_ARRAY);
+    data.resize(view.Size());
+    view.CopyTo(data.data());
+}
+
+static
+Frames FramesFromTagView(const TagView& view, const bool decodeCodes)
+{
+    Frames frames;
+    FramesFromTagView(view, decodeCodes, &frames);
+    return frames;
+}
+
 static
 Position QueryStartFromName(const string& fullName)
 {
@@ -138,8 +160,39 @@ Position QueryStartFromName(const string& fullName)
     return stoi(queryTokens.at(0));
 }
 
+// tags holding one value per base, clipped along with SEQ & QUAL (pulse tags
+// are per-pulse & are left as-is, see bug 31633)
+static
+const vector<TagId>& PerBaseTags(void)
+{
+    static const vector<TagId> tags = {
+        tagName_deletionQV,
+        tagName_deletionTag,
+        tagName_insertionQV,
+        tagName_mergeQV,
+        tagName_substitutionQV,
+        tagName_substitutionTag,
+        tagName_ipd,
+        tagName_pulseWidth
+    };
+    return tags;
+}
+
+// SEQ & QUAL are stored in aligned orientation, per-base tags in native. So
+// on the reverse strand, a native clip window starts from SEQ's other end.
 static
-BamRecordImpl* CreateOrEdit(const string& tagName,
+size_t SequenceClipStart(const BamRecord& record,
+                         const size_t clipFrom,
+                         const size_t clipLength)
+{
+    if (record.AlignedStrand() == Strand::FORWARD)
+        return clipFrom;
+    const size_t seqLength = record.Impl().SequenceLength();
+    return seqLength - std::min(seqLength, clipFrom + clipLength);
+}
+
+static
+BamRecordImpl* CreateOrEdit(const TagId& tagName,
                             const Tag& value,
                             BamRecordImpl* impl)
 {
@@ -208,165 +261,93 @@ T Clip(const T& input, const size_t pos, const size_t len)
               input.cbegin() + pos + len };
 }
 
-static
-void ClipAndGapifyBases(const BamRecordImpl& impl,
-                        const bool aligned,
-                        const bool exciseSoftClips,
-                        string* seq)
-{
-    assert(seq);
-    if (impl.IsMapped() && (aligned || exciseSoftClips)) {
-
-        size_t seqIndex = 0;
-        const auto cigar = impl.CigarData();
-        auto cigarIter = cigar.cbegin();
-        auto cigarEnd  = cigar.cend();
-        for (; cigarIter != cigarEnd; ++cigarIter) {
-            const auto op = (*cigarIter);
-            const auto type = op.Type();
-
-            // do nothing for hard clips
-            if (type != CigarOperationType::HARD_CLIP) {
-                const auto opLength = op.Length();
-
-                // maybe remove soft clips
-                if (type == CigarOperationType::SOFT_CLIP && exciseSoftClips)
-                    seq->erase(seqIndex, opLength);
-
-                // for non-clipping operations
-                else {
-
-                    // maybe add gaps/padding
-                    if (aligned) {
-                        if (type == CigarOperationType::DELETION) {
-                            seq->reserve(seq->size() + opLength);
-                            seq->insert(seqIndex, opLength, '-');
-                        }
-                        else if (type == CigarOperationType::PADDING) {
-                            seq->reserve(seq->size() + opLength);
-                            seq->insert(seqIndex, opLength, '*');
-                        }
-                    }
-
-                    // update index
-                    seqIndex += opLength;
-                }
-            }
-        }
-    }
-}
-
-static
-void ClipAndGapifyFrames(const BamRecordImpl& impl,
-                         const bool aligned,
-                         const bool exciseSoftClips,
-                         Frames* frames)
+// Removes soft-clipped positions and/or inserts gaps & padding, per CIGAR,
+// into per-base data already in genomic orientation. Works in place, in linear
+// time: a forward walk over the CIGAR drops soft clips (shifting the remaining
+// data down), then a backward walk opens up the gaps, so each value moves at
+// most twice regardless of the number of indels.
+//
+// As before, data need not match the CIGAR's query length exactly: any CIGAR
+// operations past the end of the data are truncated, and any data past the
+// end of the CIGAR is kept as-is.
+//
+template<typename Container>
+void ClipAndGapify(const BamRecordImpl& impl,
+                   const bool aligned,
+                   const bool exciseSoftClips,
+                   const typename Container::value_type deletionValue,
+                   const typename Container::value_type paddingValue,
+                   Container* data)
 {
-    assert(frames);
-
-    if (impl.IsMapped() && (aligned || exciseSoftClips)) {
-
-        auto data = std::move(frames->Data()); // we're going to put it back
-        size_t frameIndex = 0;
-        const auto cigar = impl.CigarData();
-        auto cigarIter = cigar.cbegin();
-        auto cigarEnd  = cigar.cend();
-        for (; cigarIter != cigarEnd; ++cigarIter) {
-            const auto op = (*cigarIter);
-            const auto type = op.Type();
-
-            // do nothing for hard clips
-            if (type != CigarOperationType::HARD_CLIP) {
-                const auto opLength = op.Length();
-
-                // maybe remove soft clips
-                if (type == CigarOperationType::SOFT_CLIP && exciseSoftClips) {
-                    data.erase(data.begin() + frameIndex,
-                               data.begin() + frameIndex + opLength);
-                }
+    assert(data);
+    if (!impl.IsMapped() || !(aligned || exciseSoftClips) || data->empty())
+        return;
 
-                // for non-clipping operations
-                else {
-
-                    // maybe add gaps/padding
-                    if (aligned) {
-                        if (type == CigarOperationType::DELETION ||
-                            type == CigarOperationType::PADDING)
-                        {
-                            data.reserve(data.size() + opLength);
-                            data.insert(data.begin() + frameIndex, opLength, 0);
-                        }
-                    }
-
-                    // update index
-                    frameIndex += opLength;
-                }
-            }
+    const PBBAM_SHARED_PTR<bam1_t> b = internal::BamRecordMemory::GetRawData(impl);
+    const uint32_t* cigar = bam_get_cigar(b.get());
+    const size_t numCigarOps = b->core.n_cigar;
+    const size_t dataLength = data->size();
+
+    // drop soft clips, count gap positions
+    auto first = data->begin();
+    size_t readIndex = 0;
+    size_t writeIndex = 0;
+    size_t queryLength = 0; // kept query positions, per CIGAR
+    size_t numGaps = 0;
+    for (size_t i = 0; i < numCigarOps; ++i) {
+        const int type = bam_cigar_op(cigar[i]);
+        const size_t opLength = bam_cigar_oplen(cigar[i]);
+        if (type == BAM_CSOFT_CLIP && exciseSoftClips)
+            readIndex = std::min(readIndex + opLength, dataLength);
+        else if (bam_cigar_type(type) & 0x1) { // consumes query
+            const size_t numKept = std::min(opLength, dataLength - readIndex);
+            if (writeIndex != readIndex)
+                std::copy(first + readIndex, first + readIndex + numKept, first + writeIndex);
+            readIndex  += numKept;
+            writeIndex += numKept;
+            queryLength += opLength;
         }
-        frames->Data(data);
+        else if (aligned && (type == BAM_CDEL || type == BAM_CPAD))
+            numGaps += opLength;
     }
-}
+    const size_t numCovered = writeIndex;
 
+    // keep any data past the end of the CIGAR
+    const size_t numTrailing = dataLength - readIndex;
+    if (numTrailing > 0 && writeIndex != readIndex)
+        std::copy(first + readIndex, first + dataLength, first + writeIndex);
+    writeIndex += numTrailing;
 
-static
-void ClipAndGapifyQualities(const BamRecordImpl& impl,
-                            const bool aligned,
-                            const bool exciseSoftClips,
-                            QualityValues* quals)
-{
-    assert(quals);
+    const size_t newLength = writeIndex + numGaps;
+    data->resize(newLength);
+    if (numGaps == 0)
+        return;
 
-    if (impl.IsMapped() && (aligned || exciseSoftClips)) {
-
-        size_t qualIndex = 0;
-        const auto cigar = impl.CigarData();
-        auto cigarIter = cigar.cbegin();
-        auto cigarEnd  = cigar.cend();
-        for (; cigarIter != cigarEnd; ++cigarIter) {
-            const auto op = (*cigarIter);
-            const auto type = op.Type();
-
-            // do nothing for hard clips
-            if (type != CigarOperationType::HARD_CLIP) {
-                const auto opLength = op.Length();
-
-                // maybe remove soft clips
-                if (type == CigarOperationType::SOFT_CLIP && exciseSoftClips)
-                    quals->erase(quals->begin() + qualIndex, quals->begin() + qualIndex + opLength);
-
-                // for non-clipping operations
-                else {
-
-                    // maybe add gaps/padding
-                    if (aligned) {
-                        if (type == CigarOperationType::DELETION || type == CigarOperationType::PADDING) {
-                            quals->reserve(quals->size() + opLength);
-                            quals->insert(quals->begin() + qualIndex, opLength, QualityValue(0));
-                        }
-                    }
-
-                    // update index
-                    qualIndex += opLength;
-                }
-            }
+    // open up gaps, back to front
+    first = data->begin();
+    std::copy_backward(first + numCovered, first + numCovered + numTrailing, first + newLength);
+    writeIndex = newLength - numTrailing;
+    size_t queryEnd = queryLength;
+    for (size_t i = numCigarOps; i > 0; --i) {
+        const int type = bam_cigar_op(cigar[i-1]);
+        const size_t opLength = bam_cigar_oplen(cigar[i-1]);
+        if (type == BAM_CSOFT_CLIP && exciseSoftClips)
+            continue;
+        else if (bam_cigar_type(type) & 0x1) { // consumes query
+            const size_t queryBegin = queryEnd - opLength;
+            const size_t copyBegin = std::min(queryBegin, numCovered);
+            const size_t copyEnd   = std::min(queryEnd, numCovered);
+            std::copy_backward(first + copyBegin, first + copyEnd, first + writeIndex);
+            writeIndex -= (copyEnd - copyBegin);
+            queryEnd = queryBegin;
+        }
+        else if (aligned && (type == BAM_CDEL || type == BAM_CPAD)) {
+            const auto gapValue = (type == BAM_CDEL ? deletionValue : paddingValue);
+            std::fill(first + writeIndex - opLength, first + writeIndex, gapValue);
+            writeIndex -= opLength;
         }
     }
-}
-
-static
-RecordType NameToType(const string& name)
-{
-    if (name == recordTypeName_Subread)
-        return RecordType::SUBREAD;
-    if (name == recordTypeName_ZMW || name == recordTypeName_Polymerase)
-        return RecordType::ZMW;
-    if (name == recordTypeName_HqRegion)
-        return RecordType::HQREGION;
-    if (name == recordTypeName_CCS)
-        return RecordType::CCS;
-    if (name == recordTypeName_Scrap)
-        return RecordType::SCRAP;
-    return RecordType::UNKNOWN;
+    assert(writeIndex == 0);
 }
 
 static
@@ -396,6 +377,17 @@ void OrientTagDataAsRequested(Container* data,
         std::reverse(data->begin(), data->end());
 }
 
+static inline
+void OrientTagDataAsRequested(QualityValues* quals,
+                              Orientation current,
+                              Orientation requested,
+                              bool isReverseStrand)
+{
+    assert(quals);
+    if (current != requested && isReverseStrand)
+        quals->Reverse();
+}
+
 static inline
 bool ConsumesQuery(const CigarOperationType type)
 { return (bam_cigar_type(static_cast<int>(type)) & 0x1) != 0; }
@@ -413,55 +405,71 @@ const float BamRecord::photonFactor = 10.0;
 BamRecord::BamRecord(void)
     : alignedStart_(PacBio::BAM::UnmappedPosition)
     , alignedEnd_(PacBio::BAM::UnmappedPosition)
+    , recordType_(RecordType::UNKNOWN)
 { }
 
 BamRecord::BamRecord(const BamHeader& header)
     : header_(header)
     , alignedStart_(PacBio::BAM::UnmappedPosition)
     , alignedEnd_(PacBio::BAM::UnmappedPosition)
+    , recordType_(RecordType::UNKNOWN)
 { }
 
 BamRecord::BamRecord(const BamRecordImpl& impl)
     : impl_(impl)
     , alignedStart_(PacBio::BAM::UnmappedPosition)
     , alignedEnd_(PacBio::BAM::UnmappedPosition)
+    , recordType_(RecordType::UNKNOWN)
 { }
 
 BamRecord::BamRecord(BamRecordImpl&& impl)
     : impl_(std::move(impl))
     , alignedStart_(PacBio::BAM::UnmappedPosition)
     , alignedEnd_(PacBio::BAM::UnmappedPosition)
+    , recordType_(RecordType::UNKNOWN)
 { }
 
 BamRecord::BamRecord(const BamRecord& other)
     : impl_(other.impl_)
     , header_(other.header_)
-    , alignedStart_(other.alignedStart_)
-    , alignedEnd_(other.alignedEnd_)
-{ }
+    , alignedStart_(PacBio::BAM::UnmappedPosition)
+    , alignedEnd_(PacBio::BAM::UnmappedPosition)
+    , recordType_(RecordType::UNKNOWN)
+{
+    CopyCachedValues(other);
+}
 
-BamRecord::BamRecord(BamRecord&& other)
+BamRecord::BamRecord(BamRecord&& other) noexcept
     : impl_(std::move(other.impl_))
     , header_(std::move(other.header_))
-    , alignedStart_(std::move(other.alignedStart_))
-    , alignedEnd_(std::move(other.alignedEnd_))
-{ }
+    , alignedStart_(PacBio::BAM::UnmappedPosition)
+    , alignedEnd_(PacBio::BAM::UnmappedPosition)
+    , recordType_(RecordType::UNKNOWN)
+{
+    CopyCachedValues(other);
+    other.ResetCachedPositions();
+    other.recordTypeState_.Invalidate();
+}
 
 BamRecord& BamRecord::operator=(const BamRecord& other)
 {
-    impl_ = other.impl_;
-    header_ = other.header_;
-    alignedStart_ = other.alignedStart_;
-    alignedEnd_ = other.alignedEnd_;
+    if (this != &other) {
+        impl_ = other.impl_;
+        header_ = other.header_;
+        CopyCachedValues(other);
+    }
     return *this;
 }
 
-BamRecord& BamRecord::operator=(BamRecord&& other)
+BamRecord& BamRecord::operator=(BamRecord&& other) noexcept
 {
-    impl_ = std::move(other.impl_);
-    header_ = std::move(other.header_);
-    alignedStart_ = std::move(other.alignedStart_);
-    alignedEnd_ = std::move(other.alignedEnd_);
+    if (this != &other) {
+        impl_ = std::move(other.impl_);
+        header_ = std::move(other.header_);
+        CopyCachedValues(other);
+        other.ResetCachedPositions();
+        other.recordTypeState_.Invalidate();
+    }
     return *this;
 }
 
@@ -469,15 +477,13 @@ BamRecord::~BamRecord(void) { }
 
 Position BamRecord::AlignedEnd(void) const
 {
-    if (alignedEnd_ == PacBio::BAM::UnmappedPosition)
-        CalculateAlignedPositions();
+    alignedPositionsState_.EnsureValid([this]() { CalculateAlignedPositions(); });
     return alignedEnd_;
 }
 
 Position BamRecord::AlignedStart(void) const
 {
-    if (alignedStart_ == PacBio::BAM::UnmappedPosition)
-        CalculateAlignedPositions();
+    alignedPositionsState_.EnsureValid([this]() { CalculateAlignedPositions(); });
     return alignedStart_;
 }
 
@@ -561,8 +567,9 @@ BamRecord& BamRecord::Barcodes(const std::pair<int16_t,int16_t>& barcodeIds)
 
 void BamRecord::CalculateAlignedPositions(void) const
 {
-    // reset
-    ResetCachedPositions();
+    // reset (only the values, state is managed by caller)
+    alignedEnd_   = PacBio::BAM::UnmappedPosition;
+    alignedStart_ = PacBio::BAM::UnmappedPosition;
 
     // skip if unmapped, or has no queryStart/End
     if (!impl_.IsMapped())
@@ -578,9 +585,9 @@ void BamRecord::CalculateAlignedPositions(void) const
         return;
 
     // determine clipped end ranges
-    const std::pair<int32_t, int32_t> alignedOffsets = internal::AlignedOffsets(*this, seqLength);
-    const int32_t startOffset = alignedOffsets.first;
-    const int32_t endOffset = alignedOffsets.second;
+    alignmentStatsState_.EnsureValid([this]() { CalculateAlignmentStats(); });
+    const int32_t startOffset = alignmentStats_.startOffset;
+    const int32_t endOffset = alignmentStats_.endOffset;
     if (endOffset == -1 || startOffset == -1)
         return; // TODO: handle error more??
 
@@ -595,6 +602,39 @@ void BamRecord::CalculateAlignedPositions(void) const
     }
 }
 
+void BamRecord::CalculateAlignmentStats(void) const
+{
+    // one pass over the CIGAR for all counts & spans
+    size_t numMatches = 0;
+    size_t numMismatches = 0;
+    size_t alignedSpan = 0;
+    size_t referenceSpan = 0;
+    for (const CigarOperation& op : impl_.CigarDataView()) {
+        const CigarOperationType type = op.Type();
+        const size_t length = op.Length();
+        if (type == CigarOperationType::SEQUENCE_MATCH)
+            numMatches += length;
+        else if (type == CigarOperationType::SEQUENCE_MISMATCH)
+            numMismatches += length;
+        if (internal::ConsumesReference(type))
+            referenceSpan += length;
+        if (internal::ConsumesQuery(type) && type != CigarOperationType::SOFT_CLIP)
+            alignedSpan += length;
+    }
+
+    alignmentStats_.numMatches       = numMatches;
+    alignmentStats_.numMismatches    = numMismatches;
+    alignmentStats_.numInsertedBases = alignedSpan - numMatches - numMismatches;
+    alignmentStats_.numDeletedBases  = referenceSpan - numMatches - numMismatches;
+    alignmentStats_.referenceSpan    = referenceSpan;
+
+    // clipping only touches the ends of the CIGAR
+    const std::pair<int32_t, int32_t> alignedOffsets =
+            internal::AlignedOffsets(*this, impl_.SequenceLength());
+    alignmentStats_.startOffset = alignedOffsets.first;
+    alignmentStats_.endOffset   = alignedOffsets.second;
+}
+
 Cigar BamRecord::CigarData(bool exciseAllClips) const
 {
     auto isClippingOp = [](const CigarOperation& op)
@@ -631,63 +671,16 @@ BamRecord& BamRecord::Clip(const ClipType clipType,
 void BamRecord::ClipFields(const size_t clipFrom,
                            const size_t clipLength)
 {
-    const bool isForwardStrand = (AlignedStrand() == Strand::FORWARD);
+    const size_t seqClipFrom = internal::SequenceClipStart(*this, clipFrom, clipLength);
+    impl_.ClipSequenceAndTags(seqClipFrom, clipFrom, clipLength, internal::PerBaseTags());
+}
 
-    // clip seq, quals
-    string sequence = internal::Clip(Sequence(Orientation::NATIVE), clipFrom, clipLength);
-    QualityValues qualities = internal::Clip(Qualities(Orientation::NATIVE), clipFrom, clipLength);
-    if (!isForwardStrand) {
-        internal::ReverseComplement(sequence);
-        internal::Reverse(qualities);
-    }
-    impl_.SetSequenceAndQualities(sequence, qualities.Fastq());
-
-    // update BAM tags
-    TagCollection tags = impl_.Tags();
-    if (HasDeletionQV())
-        tags[internal::tagName_deletionQV]          = internal::Clip(DeletionQV(Orientation::NATIVE), clipFrom, clipLength).Fastq();
-    if (HasInsertionQV())
-        tags[internal::tagName_insertionQV]         = internal::Clip(InsertionQV(Orientation::NATIVE), clipFrom, clipLength).Fastq();
-    if (HasMergeQV())
-        tags[internal::tagName_mergeQV]             = internal::Clip(MergeQV(Orientation::NATIVE), clipFrom, clipLength).Fastq();
-    if (HasSubstitutionQV())
-        tags[internal::tagName_substitutionQV]      = internal::Clip(SubstitutionQV(Orientation::NATIVE), clipFrom, clipLength).Fastq();
-    if (HasIPD())
-        tags[internal::tagName_ipd]                 = internal::Clip(IPD(Orientation::NATIVE).Data(), clipFrom, clipLength);
-    if (HasPulseWidth())
-        tags[internal::tagName_pulseWidth]          = internal::Clip(PulseWidth(Orientation::NATIVE).Data(), clipFrom, clipLength);
-    if (HasDeletionTag())
-        tags[internal::tagName_deletionTag]         = internal::Clip(DeletionTag(Orientation::NATIVE), clipFrom, clipLength);
-    if (HasSubstitutionTag())
-        tags[internal::tagName_substitutionTag]     = internal::Clip(SubstitutionTag(Orientation::NATIVE), clipFrom, clipLength);
-
-    // need to implement clipping on pulse tags etc (bug 31633)
-    if (HasAltLabelQV())
-        tags[internal::tagName_alternative_labelQV] = AltLabelQV(Orientation::NATIVE).Fastq();
-    if (HasLabelQV())
-        tags[internal::tagName_labelQV]             = LabelQV(Orientation::NATIVE).Fastq();
-    if (HasPulseMergeQV())
-        tags[internal::tagName_pulseMergeQV]        = PulseMergeQV(Orientation::NATIVE).Fastq();
-    if (HasAltLabelTag())
-        tags[internal::tagName_alternative_labelTag]= AltLabelTag(Orientation::NATIVE);
-    if (HasPulseCall())
-        tags[internal::tagName_pulse_call]          = PulseCall(Orientation::NATIVE);
-    if (HasPkmean())
-        tags[internal::tagName_pkmean]              = EncodePhotons(Pkmean(Orientation::NATIVE));
-    if (HasPkmid())
-        tags[internal::tagName_pkmid]               = EncodePhotons(Pkmid(Orientation::NATIVE));
-    if (HasPkmean2())
-        tags[internal::tagName_pkmean2]             = EncodePhotons(Pkmean2(Orientation::NATIVE));
-    if (HasPkmid2())
-        tags[internal::tagName_pkmid2]              = EncodePhotons(Pkmid2(Orientation::NATIVE));
-    if (HasPrePulseFrames())
-        tags[internal::tagName_pre_pulse_frames]    = PrePulseFrames(Orientation::NATIVE).Data();
-    if (HasPulseCallWidth())
-        tags[internal::tagName_pulse_call_width]    = PulseCallWidth(Orientation::NATIVE).Data();
-    if (HasStartFrame())
-        tags[internal::tagName_startFrame]          = StartFrame(Orientation::NATIVE);
-
-    impl_.Tags(tags);
+void BamRecord::ClipFields(const Cigar& cigar,
+                           const size_t clipFrom,
+                           const size_t clipLength)
+{
+    const size_t seqClipFrom = internal::SequenceClipStart(*this, clipFrom, clipLength);
+    impl_.ClipSequenceAndTags(cigar, seqClipFrom, clipFrom, clipLength, internal::PerBaseTags());
 }
 
 BamRecord& BamRecord::ClipToQuery(const Position start,
@@ -763,16 +756,15 @@ BamRecord& BamRecord::ClipToQuery(const Position start,
             }
         }
 
-        // update CIGAR & position
-        impl_.CigarData(cigar);
+        // update position, then CIGAR, SEQ, QUAL, & tags in one pass
         const Position origPosition = impl_.Position();
         impl_.Position(origPosition + referencePositionOffset);
+        ClipFields(cigar, startOffset, (end - start));
     }
 
     // clip SEQ, QUAL, & tags
-    const size_t clipFrom   = startOffset;
-    const size_t clipLength = (end - start);
-    ClipFields(clipFrom, clipLength);
+    else
+        ClipFields(startOffset, (end - start));
 
     // update query start/end
     // TODO: update name to reflect new QS/QE ???
@@ -908,16 +900,15 @@ BamRecord& BamRecord::ClipToReferenceForward(const PacBio::BAM::Position start,
         }
     }
 
-    // update CIGAR and position
-    impl_.CigarData(cigar);
+    // update position
     impl_.Position(newTStart);
 
-    // clip SEQ, QUAL, tags
+    // clip CIGAR, SEQ, QUAL, tags
     const Position qStart = origQStart + queryPosRemovedFront;
     const Position qEnd   = origQEnd   - queryPosRemovedBack;
     const size_t clipFrom = queryPosRemovedFront;
     const size_t clipLength = qEnd - qStart;
-    ClipFields(clipFrom, clipLength);
+    ClipFields(cigar, clipFrom, clipLength);
 
     // update query start/end
     internal::CreateOrEdit(internal::tagName_queryStart, qStart, &impl_);
@@ -1031,17 +1022,16 @@ BamRecord& BamRecord::ClipToReferenceReverse(const PacBio::BAM::Position start,
             }
         }
     }
-    impl_.CigarData(cigar);
 
     // update aligned reference position
     impl_.Position(newTStart);
 
-    // clip SEQ, QUAL, tags
+    // clip CIGAR, SEQ, QUAL, tags
     const Position qStart = origQStart + queryPosRemovedFront;
     const Position qEnd   = origQEnd   - queryPosRemovedBack;
     const size_t clipFrom = queryPosRemovedFront;
     const size_t clipLength = qEnd - qStart;
-    ClipFields(clipFrom, clipLength);
+    ClipFields(cigar, clipFrom, clipLength);
 
     // update query start/end
     internal::CreateOrEdit(internal::tagName_queryStart, qStart, &impl_);
@@ -1053,6 +1043,28 @@ BamRecord& BamRecord::ClipToReferenceReverse(const PacBio::BAM::Position start,
     return *this;
 }
 
+void BamRecord::CopyCachedValues(const BamRecord& other)
+{
+    if (other.alignedPositionsState_.IsValid()) {
+        alignedStart_ = other.alignedStart_;
+        alignedEnd_   = other.alignedEnd_;
+        alignedPositionsState_.SetValid();
+    } else
+        alignedPositionsState_.Invalidate();
+
+    if (other.recordTypeState_.IsValid()) {
+        recordType_ = other.recordType_;
+        recordTypeState_.SetValid();
+    } else
+        recordTypeState_.Invalidate();
+
+    if (other.alignmentStatsState_.IsValid()) {
+        alignmentStats_ = other.alignmentStats_;
+        alignmentStatsState_.SetValid();
+    } else
+        alignmentStatsState_.Invalidate();
+}
+
 QualityValues BamRecord::DeletionQV(Orientation orientation,
                                     bool aligned,
                                     bool exciseSoftClips) const
@@ -1063,6 +1075,18 @@ QualityValues BamRecord::DeletionQV(Orientation orientation,
                           exciseSoftClips);
 }
 
+void BamRecord::DeletionQV(QualityValues* qualities,
+                           Orientation orientation,
+                           bool aligned,
+                           bool exciseSoftClips) const
+{
+    FetchQualities(internal::tagName_deletionQV,
+                   qualities,
+                   orientation,
+                   aligned,
+                   exciseSoftClips);
+}
+
 BamRecord& BamRecord::DeletionQV(const QualityValues& deletionQVs)
 {
     internal::CreateOrEdit(internal::tagName_deletionQV, deletionQVs.Fastq(), &impl_);
@@ -1080,6 +1104,18 @@ string BamRecord::DeletionTag(Orientation orientation,
                       exciseSoftClips);
 }
 
+void BamRecord::DeletionTag(std::string* tags,
+                            Orientation orientation,
+                            bool aligned,
+                            bool exciseSoftClips) const
+{
+    FetchBases(internal::tagName_deletionTag,
+               tags,
+               orientation,
+               aligned,
+               exciseSoftClips);
+}
+
 BamRecord& BamRecord::DeletionTag(const std::string& tags)
 {
     internal::CreateOrEdit(internal::tagName_deletionTag, tags, &impl_);
@@ -1096,33 +1132,61 @@ BamRecord::EncodePhotons(const std::vector<float>& data)
     return encoded;
 }
 
-string BamRecord::FetchBasesRaw(const string& tagName) const
+string BamRecord::FetchBasesRaw(const TagId& tagName) const
+{
+    string bases;
+    FetchBasesRaw(tagName, &bases);
+    return bases;
+}
+
+void BamRecord::FetchBasesRaw(const TagId& tagName, string* bases) const
 {
-    const Tag& seqTag = impl_.TagValue(tagName);
-    return seqTag.ToString();
+    assert(bases);
+    const TagView seqTag = impl_.TagValueView(tagName);
+    if (seqTag.IsNull())
+        throw std::runtime_error("bases tag " + tagName.ToString() + " was requested but is missing");
+    if (!seqTag.IsString())
+        throw std::runtime_error("bases are not a string, tag " + tagName.ToString());
+    bases->assign(seqTag.Chars(), seqTag.Size());
 }
 
-string BamRecord::FetchBases(const string& tagName,
+string BamRecord::FetchBases(const TagId& tagName,
                              const Orientation orientation) const
 { return FetchBases(tagName, orientation, false, false); }
 
-string BamRecord::FetchBases(const string& tagName,
+string BamRecord::FetchBases(const TagId& tagName,
                              const Orientation orientation,
                              const bool aligned,
                              const bool exciseSoftClips) const
 {
+    string bases;
+    FetchBases(tagName, &bases, orientation, aligned, exciseSoftClips);
+    return bases;
+}
+
+void BamRecord::FetchBases(const TagId& tagName,
+                           string* bases,
+                           const Orientation orientation,
+                           const bool aligned,
+                           const bool exciseSoftClips) const
+{
+    assert(bases);
+
     // requested data info
     const bool isBamSeq = (tagName == internal::tagName_SEQ);
     const bool isPulse = (tagName == internal::tagName_pulse_call);
 
     // fetch raw
-    string bases;
     Orientation current;
     if (isBamSeq) { // SEQ stored in genomic orientation
-        bases = impl_.Sequence();
+        const PBBAM_SHARED_PTR<bam1_t> b = internal::BamRecordMemory::GetRawData(impl_);
+        const size_t seqLength = b->core.l_qseq;
+        bases->resize(seqLength);
+        if (seqLength > 0)
+            internal::DecodeSequence(bam_get_seq(b.get()), seqLength, &(*bases)[0]);
         current = Orientation::GENOMIC;
     } else { // all tags stored in native orientation
-        bases = FetchBasesRaw(tagName);
+        FetchBasesRaw(tagName, bases);
         current = Orientation::NATIVE;
     }
 
@@ -1130,7 +1194,7 @@ string BamRecord::FetchBases(const string& tagName,
     if (aligned || exciseSoftClips) {
 
         // force into genomic orientation
-        internal::OrientBasesAsRequested(&bases,
+        internal::OrientBasesAsRequested(bases,
                                          current,
                                          Orientation::GENOMIC,
                                          impl_.IsReverseStrand(),
@@ -1138,131 +1202,165 @@ string BamRecord::FetchBases(const string& tagName,
         current = Orientation::GENOMIC;
 
         // clip & gapify as requested
-        internal::ClipAndGapifyBases(impl_,
-                                     aligned,
-                                     exciseSoftClips,
-                                     &bases);
+        internal::ClipAndGapify(impl_,
+                                aligned,
+                                exciseSoftClips,
+                                '-',
+                                '*',
+                                bases);
     }
 
     // return in the orientation requested
-    internal::OrientBasesAsRequested(&bases,
+    internal::OrientBasesAsRequested(bases,
                                      current,
                                      orientation,
                                      impl_.IsReverseStrand(),
                                      isPulse);
-    return bases;
 }
 
-Frames BamRecord::FetchFramesRaw(const string& tagName) const
-{
-    Frames frames;
-    const Tag& frameTag = impl_.TagValue(tagName);
-    if (frameTag.IsNull())
-        return frames;  // throw ?
-
-    // lossy frame codes
-    if (frameTag.IsUInt8Array()) {
-        const vector<uint8_t> codes = frameTag.ToUInt8Array();
-        frames = Frames::Decode(codes);
-    }
+Frames BamRecord::FetchFramesRaw(const TagId& tagName) const
+{ return internal::FramesFromTagView(impl_.TagValueView(tagName), true); }
 
-    // lossless frame data
-    else {
-        assert(frameTag.IsUInt16Array());
-        frames.Data(frameTag.ToUInt16Array());
-    }
-
-    return frames;
-}
-
-Frames BamRecord::FetchFrames(const string& tagName,
+Frames BamRecord::FetchFrames(const TagId& tagName,
                               const Orientation orientation) const
 { return FetchFrames(tagName, orientation, false, false); }
 
-Frames BamRecord::FetchFrames(const string& tagName,
+Frames BamRecord::FetchFrames(const TagId& tagName,
                               const Orientation orientation,
                               const bool aligned,
                               const bool exciseSoftClips) const
 {
+    Frames frames;
+    FetchFrames(tagName, &frames, orientation, aligned, exciseSoftClips);
+    return frames;
+}
+
+void BamRecord::FetchFrames(const TagId& tagName,
+                            Frames* frames,
+                            const Orientation orientation,
+                            const bool aligned,
+                            const bool exciseSoftClips) const
+{
+    assert(frames);
+
     // fetch raw
-    Frames frames = FetchFramesRaw(tagName);
+    internal::FramesFromTagView(impl_.TagValueView(tagName), true, frames);
     Orientation current = Orientation::NATIVE;
 
     if (aligned || exciseSoftClips) {
 
         // force into genomic orientation
-        internal::OrientTagDataAsRequested(&frames,
+        internal::OrientTagDataAsRequested(frames,
                                            current,
                                            Orientation::GENOMIC,
                                            impl_.IsReverseStrand());
         current = Orientation::GENOMIC;
 
         // clip & gapify as requested
-        internal::ClipAndGapifyFrames(impl_,
-                                      aligned,
-                                      exciseSoftClips,
-                                      &frames);
+        internal::ClipAndGapify(impl_,
+                                aligned,
+                                exciseSoftClips,
+                                0,
+                                0,
+                                &frames->DataRaw());
     }
 
     // return in the orientation requested
-    internal::OrientTagDataAsRequested(&frames,
+    internal::OrientTagDataAsRequested(frames,
                                        current,
                                        orientation,
                                        impl_.IsReverseStrand());
-    return frames;
 }
 
-vector<float> BamRecord::FetchPhotons(const string& tagName,
+vector<float> BamRecord::FetchPhotons(const TagId& tagName,
                                       const Orientation orientation) const
 {
-    // fetch tag data
-    const Tag& frameTag = impl_.TagValue(tagName);
-    if (frameTag.IsNull())
-        return vector<float>();
-    if(!frameTag.IsUInt16Array())
-        throw std::runtime_error("Photons are not a uint16_t array, tag " + tagName);
-    vector<uint16_t> data = frameTag.ToUInt16Array();
-
-    // put in requested orientation
-    internal::OrientTagDataAsRequested(&data,
-                                       Orientation::NATIVE,     // current
-                                       orientation,             // requested
-                                       impl_.IsReverseStrand());
-
-    // store & return result
     vector<float> photons;
-    photons.reserve(data.size());
-    for (const auto& d : data)
-        photons.emplace_back(d / photonFactor);
+    FetchPhotons(tagName, &photons, orientation);
     return photons;
 }
 
-QualityValues BamRecord::FetchQualitiesRaw(const string& tagName) const
+void BamRecord::FetchPhotons(const TagId& tagName,
+                             vector<float>* photons,
+                             const Orientation orientation) const
+{
+    assert(photons);
+
+    // fetch tag data
+    const TagView frameTag = impl_.TagValueView(tagName);
+    if (frameTag.IsNull()) {
+        photons->clear();
+        return;
+    }
+    if (frameTag.Type() != TagDataType::UINT16_ARRAY)
+        throw std::runtime_error("Photons are not a uint16_t array, tag " + tagName.ToString());
+
+    // convert, directly into requested orientation
+    const size_t numPhotons = frameTag.Size();
+    const bool reverse = (orientation != Orientation::NATIVE) && impl_.IsReverseStrand();
+    photons->resize(numPhotons);
+    float* out = photons->data();
+    for (size_t i = 0; i < numPhotons; ++i) {
+        const size_t j = (reverse ? numPhotons - 1 - i : i);
+        out[j] = frameTag.Element<uint16_t>(i) / photonFactor;
+    }
+}
+
+QualityValues BamRecord::FetchQualitiesRaw(const TagId& tagName) const
 {
-    const Tag& qvsTag = impl_.TagValue(tagName);
-    return QualityValues::FromFastq(qvsTag.ToString());
+    QualityValues quals;
+    FetchQualitiesRaw(tagName, &quals);
+    return quals;
+}
+
+void BamRecord::FetchQualitiesRaw(const TagId& tagName, QualityValues* quals) const
+{
+    assert(quals);
+    const TagView qvsTag = impl_.TagValueView(tagName);
+    if (qvsTag.IsNull())
+        throw std::runtime_error("qualities tag " + tagName.ToString() + " was requested but is missing");
+    if (!qvsTag.IsString())
+        throw std::runtime_error("qualities are not a string, tag " + tagName.ToString());
+
+    QualityValues::FromFastq(qvsTag.Chars(), qvsTag.Size(), quals);
 }
 
-QualityValues BamRecord::FetchQualities(const string& tagName,
+QualityValues BamRecord::FetchQualities(const TagId& tagName,
                                         const Orientation orientation) const
 { return FetchQualities(tagName, orientation, false, false); }
 
-QualityValues BamRecord::FetchQualities(const string& tagName,
+QualityValues BamRecord::FetchQualities(const TagId& tagName,
                                         const Orientation orientation,
                                         const bool aligned,
                                         const bool exciseSoftClips) const
 {
+    QualityValues quals;
+    FetchQualities(tagName, &quals, orientation, aligned, exciseSoftClips);
+    return quals;
+}
+
+void BamRecord::FetchQualities(const TagId& tagName,
+                               QualityValues* quals,
+                               const Orientation orientation,
+                               const bool aligned,
+                               const bool exciseSoftClips) const
+{
+    assert(quals);
+
     // requested data info
     const bool isBamQual = (tagName == internal::tagName_QUAL);
 
     // fetch raw
-    QualityValues quals;
     Orientation current;
     if (isBamQual) { // QUAL stored in genomic orientation
-        quals = impl_.Qualities();
+        const TagView qualView = impl_.QualitiesView();
+        if (qualView.IsNull())
+            quals->clear();
+        else
+            QualityValues::FromRawData(qualView.RawData(), qualView.Size(), quals);
         current = Orientation::GENOMIC;
     } else {        // all tags stored in native orientation
-        quals = FetchQualitiesRaw(tagName);
+        FetchQualitiesRaw(tagName, quals);
         current = Orientation::NATIVE;
     }
 
@@ -1270,25 +1368,26 @@ QualityValues BamRecord::FetchQualities(const string& tagName,
     if (aligned || exciseSoftClips) {
 
         // force into genomic orientation
-        internal::OrientTagDataAsRequested(&quals,
+        internal::OrientTagDataAsRequested(quals,
                                           current,
                                           Orientation::GENOMIC,
                                           impl_.IsReverseStrand());
         current = Orientation::GENOMIC;
 
         // clip & gapify as requested
-        internal::ClipAndGapifyQualities(impl_,
-                                         aligned,
-                                         exciseSoftClips,
-                                         &quals);
+        internal::ClipAndGapify(impl_,
+                                aligned,
+                                exciseSoftClips,
+                                QualityValue(0),
+                                QualityValue(0),
+                                quals);
     }
 
     // return in the orientation requested
-    internal::OrientTagDataAsRequested(&quals,
+    internal::OrientTagDataAsRequested(quals,
                                        current,
                                        orientation,
                                        impl_.IsReverseStrand());
-    return quals;
 }
 
 string BamRecord::FullName(void) const
@@ -1422,7 +1521,13 @@ BamRecord& BamRecord::HoleNumber(const int32_t holeNumber)
 }
 
 BamRecordImpl& BamRecord::Impl(void)
-{ return impl_; }
+{
+    // caller may edit tags/name/mapping directly
+    recordTypeState_.Invalidate();
+    alignedPositionsState_.Invalidate();
+    alignmentStatsState_.Invalidate();
+    return impl_;
+}
 
 const BamRecordImpl& BamRecord::Impl(void) const
 { return impl_; }
@@ -1437,6 +1542,18 @@ QualityValues BamRecord::InsertionQV(Orientation orientation,
                           exciseSoftClips);
 }
 
+void BamRecord::InsertionQV(QualityValues* qualities,
+                            Orientation orientation,
+                            bool aligned,
+                            bool exciseSoftClips) const
+{
+    FetchQualities(internal::tagName_insertionQV,
+                   qualities,
+                   orientation,
+                   aligned,
+                   exciseSoftClips);
+}
+
 BamRecord& BamRecord::InsertionQV(const QualityValues& insertionQVs)
 {
     internal::CreateOrEdit(internal::tagName_insertionQV, insertionQVs.Fastq(), &impl_);
@@ -1453,6 +1570,18 @@ Frames BamRecord::IPD(Orientation orientation,
                        exciseSoftClips);
 }
 
+void BamRecord::IPD(Frames* frames,
+                    Orientation orientation,
+                    bool aligned,
+                    bool exciseSoftClips) const
+{
+    FetchFrames(internal::tagName_ipd,
+                frames,
+                orientation,
+                aligned,
+                exciseSoftClips);
+}
+
 BamRecord& BamRecord::IPD(const Frames& frames,
                           const FrameEncodingType encoding)
 {
@@ -1465,22 +1594,14 @@ BamRecord& BamRecord::IPD(const Frames& frames,
 
 size_t BamRecord::NumDeletedBases(void) const
 {
-    auto tEnd = ReferenceEnd();
-    auto tStart = ReferenceStart();
-    auto numMatchesAndMismatches = NumMatchesAndMismatches();
-    auto nM = numMatchesAndMismatches.first;
-    auto nMM = numMatchesAndMismatches.second;
-    return (tEnd - tStart - nM - nMM);
+    alignmentStatsState_.EnsureValid([this]() { CalculateAlignmentStats(); });
+    return alignmentStats_.numDeletedBases;
 }
 
 size_t BamRecord::NumInsertedBases(void) const
 {
-    auto aEnd = AlignedEnd();
-    auto aStart = AlignedStart();
-    auto numMatchesAndMismatches = NumMatchesAndMismatches();
-    auto nM = numMatchesAndMismatches.first;
-    auto nMM = numMatchesAndMismatches.second;
-    return (aEnd - aStart - nM - nMM);
+    alignmentStatsState_.EnsureValid([this]() { CalculateAlignmentStats(); });
+    return alignmentStats_.numInsertedBases;
 }
 
 size_t BamRecord::NumMatches(void) const
@@ -1488,17 +1609,8 @@ size_t BamRecord::NumMatches(void) const
 
 pair<size_t, size_t> BamRecord::NumMatchesAndMismatches(void) const
 {
-    pair<size_t, size_t> result = make_pair(0,0);
-    PBBAM_SHARED_PTR<bam1_t> b = internal::BamRecordMemory::GetRawData(this);
-    uint32_t* cigarData = bam_get_cigar(b.get());
-    for (uint32_t i = 0; i < b->core.n_cigar; ++i) {
-        const CigarOperationType type = static_cast<CigarOperationType>(bam_cigar_op(cigarData[i]));
-        if (type == CigarOperationType::SEQUENCE_MATCH)
-            result.first += bam_cigar_oplen(cigarData[i]);
-        else if (type == CigarOperationType::SEQUENCE_MISMATCH)
-            result.second += bam_cigar_oplen(cigarData[i]);
-    }
-    return result;
+    alignmentStatsState_.EnsureValid([this]() { CalculateAlignmentStats(); });
+    return make_pair(alignmentStats_.numMatches, alignmentStats_.numMismatches);
 }
 
 size_t BamRecord::NumMismatches(void) const
@@ -1509,6 +1621,12 @@ Frames BamRecord::PreBaseFrames(Orientation orientation,
                                 bool exciseSoftClips) const
 { return IPD(orientation, aligned, exciseSoftClips); }
 
+void BamRecord::PreBaseFrames(Frames* frames,
+                              Orientation orientation,
+                              bool aligned,
+                              bool exciseSoftClips) const
+{ IPD(frames, orientation, aligned, exciseSoftClips); }
+
 BamRecord& BamRecord::PreBaseFrames(const Frames& frames,
                                     const FrameEncodingType encoding)
 { return IPD(frames, encoding); }
@@ -1517,24 +1635,10 @@ Frames BamRecord::IPDRaw(Orientation orientation) const
 {
     const auto tagName = internal::tagName_ipd;
 
-    Frames frames;
-    const Tag& frameTag = impl_.TagValue(tagName);
-    if (frameTag.IsNull())
+    Frames frames = internal::FramesFromTagView(impl_.TagValueView(tagName), false);
+    if (frames.empty())
         return frames;
 
-    // lossy frame codes
-    if (frameTag.IsUInt8Array()) {
-        const vector<uint8_t> codes = frameTag.ToUInt8Array();
-        const vector<uint16_t> codes16(codes.begin(), codes.end());
-        frames.Data(std::move(codes16));
-    }
-
-    // lossless frame data
-    else {
-        assert(frameTag.IsUInt16Array());
-        frames.Data(frameTag.ToUInt16Array());
-    }
-
     // return in requested orientation
     internal::OrientTagDataAsRequested(&frames,
                                        Orientation::NATIVE,     // current
@@ -1547,24 +1651,10 @@ Frames BamRecord::PulseWidthRaw(Orientation orientation) const
 {
     const auto tagName = internal::tagName_pulseWidth;
 
-    Frames frames;
-    const Tag& frameTag = impl_.TagValue(tagName);
-    if (frameTag.IsNull())
+    Frames frames = internal::FramesFromTagView(impl_.TagValueView(tagName), false);
+    if (frames.empty())
         return frames;
 
-    // lossy frame codes
-    if (frameTag.IsUInt8Array()) {
-        const vector<uint8_t> codes = frameTag.ToUInt8Array();
-        const vector<uint16_t> codes16(codes.begin(), codes.end());
-        frames.Data(std::move(codes16));
-    }
-
-    // lossless frame data
-    else {
-        assert(frameTag.IsUInt16Array());
-        frames.Data(frameTag.ToUInt16Array());
-    }
-
     // return in requested orientation
     internal::OrientTagDataAsRequested(&frames,
                                        Orientation::NATIVE,  // current
@@ -1623,14 +1713,13 @@ BamRecord& BamRecord::Map(const int32_t referenceId,
         QualityValues qualities = impl_.Qualities();
 
         internal::ReverseComplement(sequence);
-        internal::Reverse(qualities);
+        qualities.Reverse();
 
         impl_.SetSequenceAndQualities(sequence, qualities.Fastq());
     }
 
     // reset any cached aligned start/end
-    alignedStart_ = PacBio::BAM::UnmappedPosition;
-    alignedEnd_ = PacBio::BAM::UnmappedPosition;
+    ResetCachedPositions();
 
     return *this;
 }
@@ -1648,6 +1737,18 @@ QualityValues BamRecord::MergeQV(Orientation orientation,
                           exciseSoftClips);
 }
 
+void BamRecord::MergeQV(QualityValues* qualities,
+                        Orientation orientation,
+                        bool aligned,
+                        bool exciseSoftClips) const
+{
+    FetchQualities(internal::tagName_mergeQV,
+                   qualities,
+                   orientation,
+                   aligned,
+                   exciseSoftClips);
+}
+
 BamRecord& BamRecord::MergeQV(const QualityValues& mergeQVs)
 {
     internal::CreateOrEdit(internal::tagName_mergeQV, mergeQVs.Fastq(), &impl_);
@@ -1663,8 +1764,13 @@ BamRecord& BamRecord::PulseMergeQV(const QualityValues& mergeQVs)
     return *this;
 }
 
-string BamRecord::MovieName(void) const
-{ return ReadGroup().MovieName(); }
+const string& BamRecord::MovieName(void) const
+{
+    const auto* rg = internal::FindReadGroup(impl_, header_);
+    if (rg == nullptr)
+        throw std::runtime_error("read group ID not found");
+    return rg->movieName_;
+}
 
 int32_t BamRecord::NumPasses(void) const
 {
@@ -1681,6 +1787,10 @@ BamRecord& BamRecord::NumPasses(const int32_t numPasses)
 std::vector<float> BamRecord::Pkmean(Orientation orientation) const
 { return FetchPhotons(internal::tagName_pkmean, orientation); }
 
+void BamRecord::Pkmean(std::vector<float>* photons,
+                       Orientation orientation) const
+{ FetchPhotons(internal::tagName_pkmean, photons, orientation); }
+
 BamRecord& BamRecord::Pkmean(const std::vector<float>& photons)
 {
     Pkmean(EncodePhotons(photons));
@@ -1696,6 +1806,10 @@ BamRecord& BamRecord::Pkmean(const std::vector<uint16_t>& encodedPhotons)
 std::vector<float> BamRecord::Pkmid(Orientation orientation) const
 { return FetchPhotons(internal::tagName_pkmid, orientation); }
 
+void BamRecord::Pkmid(std::vector<float>* photons,
+                      Orientation orientation) const
+{ FetchPhotons(internal::tagName_pkmid, photons, orientation); }
+
 BamRecord& BamRecord::Pkmid(const std::vector<float>& photons)
 {
     Pkmid(EncodePhotons(photons));
@@ -1711,6 +1825,10 @@ BamRecord& BamRecord::Pkmid(const std::vector<uint16_t>& encodedPhotons)
 std::vector<float> BamRecord::Pkmean2(Orientation orientation) const
 { return FetchPhotons(internal::tagName_pkmean2, orientation); }
 
+void BamRecord::Pkmean2(std::vector<float>* photons,
+                        Orientation orientation) const
+{ FetchPhotons(internal::tagName_pkmean2, photons, orientation); }
+
 BamRecord& BamRecord::Pkmean2(const std::vector<float>& photons)
 {
     Pkmean2(EncodePhotons(photons));
@@ -1726,6 +1844,10 @@ BamRecord& BamRecord::Pkmean2(const std::vector<uint16_t>& encodedPhotons)
 std::vector<float> BamRecord::Pkmid2(Orientation orientation) const
 { return FetchPhotons(internal::tagName_pkmid2, orientation); }
 
+void BamRecord::Pkmid2(std::vector<float>* photons,
+                       Orientation orientation) const
+{ FetchPhotons(internal::tagName_pkmid2, photons, orientation); }
+
 BamRecord& BamRecord::Pkmid2(const std::vector<float>& photons)
 {
     Pkmid2(EncodePhotons(photons));
@@ -1783,6 +1905,18 @@ Frames BamRecord::PulseWidth(Orientation orientation,
                        exciseSoftClips);
 }
 
+void BamRecord::PulseWidth(Frames* frames,
+                           Orientation orientation,
+                           bool aligned,
+                           bool exciseSoftClips) const
+{
+    FetchFrames(internal::tagName_pulseWidth,
+                frames,
+                orientation,
+                aligned,
+                exciseSoftClips);
+}
+
 BamRecord& BamRecord::PulseWidth(const Frames& frames,
                                  const FrameEncodingType encoding)
 {
@@ -1797,12 +1931,24 @@ QualityValues BamRecord::Qualities(Orientation orientation,
                                    bool aligned,
                                    bool exciseSoftClips) const
 {
-    return FetchQualities("QUAL",
+    return FetchQualities(internal::tagName_QUAL,
                           orientation,
                           aligned,
                           exciseSoftClips);
 }
 
+void BamRecord::Qualities(QualityValues* qualities,
+                          Orientation orientation,
+                          bool aligned,
+                          bool exciseSoftClips) const
+{
+    FetchQualities(internal::tagName_QUAL,
+                   qualities,
+                   orientation,
+                   aligned,
+                   exciseSoftClips);
+}
+
 Position BamRecord::QueryEnd(void) const
 {
     // try 'qe' tag
@@ -1887,8 +2033,13 @@ BamRecord& BamRecord::ReadAccuracy(const Accuracy& accuracy)
     return *this;
 }
 
-ReadGroupInfo BamRecord::ReadGroup(void) const
-{ return header_.ReadGroup(ReadGroupId()); }
+const ReadGroupInfo& BamRecord::ReadGroup(void) const
+{
+    const auto* rg = internal::FindReadGroup(impl_, header_);
+    if (rg == nullptr)
+        throw std::runtime_error("read group ID not found");
+    return rg->readGroup_;
+}
 
 BamRecord& BamRecord::ReadGroup(const ReadGroupInfo& rg)
 {
@@ -1924,7 +2075,12 @@ Position BamRecord::ReferenceEnd(void) const
     PBBAM_SHARED_PTR<bam1_t> htsData = internal::BamRecordMemory::GetRawData(impl_);
     if (!htsData)
         return PacBio::BAM::UnmappedPosition;
-    return bam_endpos(htsData.get());
+
+    // as bam_endpos(): a mapped record without CIGAR data covers 1 position
+    if (htsData->core.n_cigar == 0)
+        return impl_.Position() + 1;
+    alignmentStatsState_.EnsureValid([this]() { CalculateAlignmentStats(); });
+    return impl_.Position() + alignmentStats_.referenceSpan;
 }
 
 int32_t BamRecord::ReferenceId(void) const
@@ -1943,14 +2099,14 @@ Position BamRecord::ReferenceStart(void) const
 
 void BamRecord::ResetCachedPositions(void) const
 {
-    alignedEnd_   = PacBio::BAM::UnmappedPosition;
-    alignedStart_ = PacBio::BAM::UnmappedPosition;
+    alignedPositionsState_.Invalidate();
+    alignmentStatsState_.Invalidate();
 }
 
 void BamRecord::ResetCachedPositions(void)
 {
-    alignedEnd_   = PacBio::BAM::UnmappedPosition;
-    alignedStart_ = PacBio::BAM::UnmappedPosition;
+    alignedPositionsState_.Invalidate();
+    alignmentStatsState_.Invalidate();
 }
 
 VirtualRegionType BamRecord::ScrapRegionType(void) const
@@ -1995,12 +2151,24 @@ std::string BamRecord::Sequence(const Orientation orientation,
                                 bool aligned,
                                 bool exciseSoftClips) const
 {
-    return FetchBases("SEQ",
+    return FetchBases(internal::tagName_SEQ,
                       orientation,
                       aligned,
                       exciseSoftClips);
 }
 
+void BamRecord::Sequence(std::string* sequence,
+                         Orientation orientation,
+                         bool aligned,
+                         bool exciseSoftClips) const
+{
+    FetchBases(internal::tagName_SEQ,
+               sequence,
+               orientation,
+               aligned,
+               exciseSoftClips);
+}
+
 vector<float> BamRecord::SignalToNoise(void) const
 {
     const Tag& snTag = impl_.TagValue(internal::tagName_snr);
@@ -2035,6 +2203,18 @@ QualityValues BamRecord::SubstitutionQV(Orientation orientation,
                           exciseSoftClips);
 }
 
+void BamRecord::SubstitutionQV(QualityValues* qualities,
+                               Orientation orientation,
+                               bool aligned,
+                               bool exciseSoftClips) const
+{
+    FetchQualities(internal::tagName_substitutionQV,
+                   qualities,
+                   orientation,
+                   aligned,
+                   exciseSoftClips);
+}
+
 BamRecord& BamRecord::SubstitutionQV(const QualityValues& substitutionQVs)
 {
     internal::CreateOrEdit(internal::tagName_substitutionQV, substitutionQVs.Fastq(), &impl_);
@@ -2051,6 +2231,18 @@ std::string BamRecord::SubstitutionTag(Orientation orientation,
                       exciseSoftClips);
 }
 
+void BamRecord::SubstitutionTag(std::string* tags,
+                                Orientation orientation,
+                                bool aligned,
+                                bool exciseSoftClips) const
+{
+    FetchBases(internal::tagName_substitutionTag,
+               tags,
+               orientation,
+               aligned,
+               exciseSoftClips);
+}
+
 BamRecord& BamRecord::SubstitutionTag(const std::string& tags)
 {
     internal::CreateOrEdit(internal::tagName_substitutionTag, tags, &impl_);
@@ -2059,24 +2251,19 @@ BamRecord& BamRecord::SubstitutionTag(const std::string& tags)
 
 RecordType BamRecord::Type(void) const
 {
-    try {
-        const string& typeName = ReadGroup().ReadType();
-        return internal::NameToType(typeName);
-    } catch (std::exception&) {
-
-        // read group not found
-        // peek at name to see if we're CCS
-        if (FullName().find("ccs") != string::npos)
-            return RecordType::CCS;
-
-        // otherwise unknown
-        else
-            return RecordType::UNKNOWN;
-    }
+    recordTypeState_.EnsureValid([this]() {
+        recordType_ = internal::LookupRecordType(impl_, header_);
+    });
+    return recordType_;
 }
 
 void BamRecord::UpdateName()
 {
+    // read group and/or name changing, re-check type (and query start/end
+    // used for aligned positions) on next request
+    recordTypeState_.Invalidate();
+    alignedPositionsState_.Invalidate();
+
     std::string newName;
     newName.reserve(100);
 
@@ -39,6 +39,7 @@
 #include "pbbam/BamTagCodec.h"
 #include "AssertUtils.h"
 #include "MemoryUtils.h"
+#include "SequenceKernels.h"
 #include <htslib/sam.h>
 #include <cstring>
 #include <memory>
@@ -129,23 +130,25 @@ BamRecord BamRecordBuilder::Build(void) const
 bool BamRecordBuilder::BuildInPlace(BamRecord& record) const
 {
     // initialize with basic 'core data'
-    PBBAM_SHARED_PTR<bam1_t> recordRawData = internal::BamRecordMemory::GetRawData(record); /*   record.impl_.RawData().get();*/
+    bam1_t* recordRawData = internal::BamRecordMemory::GetRawDataForOverwrite(record);
     PB_ASSERT_OR_RETURN_VALUE(recordRawData, false);
     PB_ASSERT_OR_RETURN_VALUE(recordRawData->data, false);
     recordRawData->core = core_;
 
-    // setup variable length data
-    const vector<uint8_t> encodedTags = BamTagCodec::Encode(tags_);
-
+    // compute exact size of variable length data, up front
     const size_t nameLength  = name_.size() + 1;
     const size_t numCigarOps = cigar_.size();
     const size_t cigarLength = numCigarOps * sizeof(uint32_t);
     const size_t seqLength   = sequence_.size();
+    const size_t encodedSeqLength = (seqLength + 1) / 2;
     const size_t qualLength  = seqLength;
-    const size_t tagLength   = encodedTags.size();
-    const size_t dataLength  = nameLength + cigarLength + seqLength + qualLength + tagLength;
+    const size_t tagLength   = BamTagCodec::EncodedSize(tags_);
+    const size_t dataLength  = nameLength + cigarLength + encodedSeqLength + qualLength + tagLength;
+
+    PB_ASSERT_OR_RETURN_VALUE(qualities_.empty() || qualities_.size() == seqLength, false);
 
-    // realloc if necessary
+    // realloc only if necessary, so a record re-built from a Reset() builder
+    // keeps its existing buffer
     uint8_t* varLengthDataBlock = recordRawData->data;
     PB_ASSERT_OR_RETURN_VALUE(varLengthDataBlock, false);
     size_t allocatedDataLength = recordRawData->m_data;
@@ -153,6 +156,7 @@ bool BamRecordBuilder::BuildInPlace(BamRecord& record) const
         allocatedDataLength = dataLength;
         kroundup32(allocatedDataLength);
         varLengthDataBlock = (uint8_t*)realloc(varLengthDataBlock, allocatedDataLength);
+        PB_ASSERT_OR_RETURN_VALUE(varLengthDataBlock, false);
     }
     recordRawData->data = varLengthDataBlock;
     recordRawData->l_data = dataLength;
@@ -166,49 +170,51 @@ bool BamRecordBuilder::BuildInPlace(BamRecord& record) const
 
     // cigar
     if (cigarLength > 0) {
-        vector<uint32_t> encodedCigar(numCigarOps);
+        uint32_t referenceLength = 0;
         for (size_t i = 0; i < numCigarOps; ++i) {
-            const CigarOperation& op = cigar_.at(i);
-            encodedCigar[i] = op.Length() << BAM_CIGAR_SHIFT;
+            const CigarOperation& op = cigar_[i];
             const uint8_t type = static_cast<uint8_t>(op.Type());
-            PB_ASSERT_OR_RETURN_VALUE(type >= 0 && type < 8, false);
-            encodedCigar[i] |= type;
+            PB_ASSERT_OR_RETURN_VALUE(type < 9, false);
+            const uint32_t encodedOp = (op.Length() << BAM_CIGAR_SHIFT) | type;
+            memcpy(&varLengthDataBlock[index], &encodedOp, sizeof(uint32_t));
+            index += sizeof(uint32_t);
+            if (bam_cigar_type(type) & 2)
+                referenceLength += op.Length();
         }
-        memcpy(&varLengthDataBlock[index], &encodedCigar[0], cigarLength);
-        index += cigarLength;
 
         // update bin after we've calculated cigar info
-        const int32_t endPosition = bam_cigar2rlen(recordRawData->core.n_cigar, &encodedCigar[0]);
+        const int32_t endPosition = core_.pos + (referenceLength > 0 ? referenceLength : 1);
         recordRawData->core.bin = hts_reg2bin(core_.pos, endPosition, 14, 5);
     }
 
     // seq & qual
     if (seqLength > 0) {
 
-        uint8_t* s = &varLengthDataBlock[index];
-        for (size_t i = 0; i < seqLength; ++i)
-            s[i>>1] |= ( seq_nt16_table[static_cast<int>(sequence_.at(i))] << ((~i&1)<<2) );
-        index += seqLength;
+        internal::EncodeSequence(sequence_.data(), seqLength, &varLengthDataBlock[index]);
+        index += encodedSeqLength;
 
         uint8_t* q = &varLengthDataBlock[index];
-        if (!qualities_.empty())
+        if (qualities_.empty())
             memset(q, 0xFF, seqLength);
         else {
             for (size_t i = 0; i < seqLength; ++i)
-                q[i] = qualities_.at(i) - 33;
+                q[i] = qualities_[i] - 33;
         }
-        index += seqLength;
+        index += qualLength;
     }
 
-    // tags
+    // tags, encoded directly into the record
     if (tagLength > 0) {
-        PB_ASSERT_OR_RETURN_VALUE(!encodedTags.empty(), false);
-        memcpy(&varLengthDataBlock[index], &encodedTags[0], tagLength);
+        const size_t numTagBytes = BamTagCodec::Encode(tags_, &varLengthDataBlock[index]);
+        PB_ASSERT_OR_RETURN_VALUE(numTagBytes == tagLength, false);
         index += tagLength;
     }
 
     // sanity check
     PB_ASSERT_OR_RETURN_VALUE(index == dataLength, false);
+
+    // tag data replaced, drop any cached offsets
+    internal::BamRecordMemory::UpdateRecordTags(record);
     return true;
 }
 
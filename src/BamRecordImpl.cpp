@@ -39,6 +39,7 @@
 #include "pbbam/BamTagCodec.h"
 #include "AssertUtils.h"
 #include "MemoryUtils.h"
+#include "SequenceKernels.h"
 #include <algorithm>
 #include <iostream>
 #include <utility>
@@ -48,6 +49,33 @@ using namespace PacBio;
 using namespace PacBio::BAM;
 using namespace std;
 
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// Returns the size of a 'B' (array) tag element, or 0 for an unknown subtype.
+static
+size_t ArrayElementSize(const char subType)
+{
+    switch (subType) {
+        case 'c' :
+        case 'C' : return 1;
+        case 's' :
+        case 'S' : return 2;
+        case 'i' :
+        case 'I' :
+        case 'f' : return 4;
+        default:
+            return 0;
+    }
+}
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+std::atomic<uint64_t> BamRecordImpl::numDeepCopies_(0);
+
 BamRecordImpl::BamRecordImpl(void)
     : d_(nullptr)
 {
@@ -55,36 +83,53 @@ BamRecordImpl::BamRecordImpl(void)
 }
 
 BamRecordImpl::BamRecordImpl(const BamRecordImpl& other)
-    : d_(bam_dup1(other.d_.get()), internal::HtslibRecordDeleter())
-    , tagOffsets_(other.tagOffsets_)
-{ }
+    : d_(other.d_)
+{
+    // 'other' may be in concurrent (const) use, only copy completed offsets
+    if (other.tagMapState_.IsValid()) {
+        tagOffsets_ = other.tagOffsets_;
+        tagMapState_.SetValid();
+    }
+}
 
-BamRecordImpl::BamRecordImpl(BamRecordImpl&& other)
+BamRecordImpl::BamRecordImpl(BamRecordImpl&& other) noexcept
     : d_(nullptr)
-    , tagOffsets_(std::move(other.tagOffsets_))
 {
     d_.swap(other.d_);
     other.d_.reset();
+
+    if (other.tagMapState_.IsValid()) {
+        tagOffsets_ = std::move(other.tagOffsets_);
+        tagMapState_.SetValid();
+        other.tagMapState_.Invalidate();
+    }
 }
 
 BamRecordImpl& BamRecordImpl::operator=(const BamRecordImpl& other)
 {
     if (this != & other) {
-        if (d_ == nullptr)
-            InitializeData();
-        bam_copy1(d_.get(), other.d_.get());
-        tagOffsets_ = other.tagOffsets_;
+        d_ = other.d_;
+        if (other.tagMapState_.IsValid()) {
+            tagOffsets_ = other.tagOffsets_;
+            tagMapState_.SetValid();
+        } else
+            tagMapState_.Invalidate();
     }
     return *this;
 }
 
-BamRecordImpl& BamRecordImpl::operator=(BamRecordImpl&& other)
+BamRecordImpl& BamRecordImpl::operator=(BamRecordImpl&& other) noexcept
 {
     if (this != & other) {
         d_.swap(other.d_);
         other.d_.reset();
 
-        tagOffsets_ = std::move(other.tagOffsets_);
+        if (other.tagMapState_.IsValid()) {
+            tagOffsets_ = std::move(other.tagOffsets_);
+            tagMapState_.SetValid();
+            other.tagMapState_.Invalidate();
+        } else
+            tagMapState_.Invalidate();
     }
     return *this;
 }
@@ -101,15 +146,24 @@ bool BamRecordImpl::AddTag(const string& tagName,
                            const Tag& value,
                            const TagModifier additionalModifier)
 {
-    if (tagName.size() != 2 || HasTag(tagName))
+    if (tagName.size() != 2)
+        return false;
+    return AddTag(TagId(tagName[0], tagName[1]), value, additionalModifier);
+}
+
+bool BamRecordImpl::AddTag(const TagId& tagId,
+                           const Tag& value,
+                           const TagModifier additionalModifier)
+{
+    if (HasTag(tagId))
         return false;
-    const bool added = AddTagImpl(tagName, value, additionalModifier);
+    const bool added = AddTagImpl(tagId, value, additionalModifier);
     if (added)
-        UpdateTagMap();
+        InvalidateTagMap();
     return added;
 }
 
-bool BamRecordImpl::AddTagImpl(const string& tagName,
+bool BamRecordImpl::AddTagImpl(const TagId& tagId,
                                const Tag& value,
                                const TagModifier additionalModifier)
 {
@@ -117,8 +171,12 @@ bool BamRecordImpl::AddTagImpl(const string& tagName,
     if (rawData.empty())
         return false;
 
+    DetachData();
+
+    const char tagName[2] = { static_cast<char>(tagId.Code() >> 8),
+                              static_cast<char>(tagId.Code() & 0xFF) };
     bam_aux_append(d_.get(),
-                   tagName.c_str(),
+                   tagName,
                    BamTagCodec::TagTypeCode(value, additionalModifier),
                    rawData.size(),
                    const_cast<uint8_t*>(rawData.data()));
@@ -126,21 +184,12 @@ bool BamRecordImpl::AddTagImpl(const string& tagName,
 }
 
 Cigar BamRecordImpl::CigarData(void) const
-{
-    Cigar result;
-    result.reserve(d_->core.n_cigar);
-    uint32_t* cigarData = bam_get_cigar(d_);
-    for (uint32_t i = 0; i < d_->core.n_cigar; ++i) {
-        const uint32_t length = bam_cigar_oplen(cigarData[i]);
-        const CigarOperationType type = static_cast<CigarOperationType>(bam_cigar_op(cigarData[i]));
-        result.push_back(CigarOperation(type, length));
-    }
-
-    return result;
-}
+{ return CigarDataView().ToCigar(); }
 
 BamRecordImpl& BamRecordImpl::CigarData(const Cigar& cigar)
 {
+    DetachData();
+
     // determine change in memory needed
     // diffNumBytes: pos -> growing, neg -> shrinking
     const size_t numCigarOps = cigar.size();
@@ -172,6 +221,205 @@ BamRecordImpl& BamRecordImpl::CigarData(const std::string& cigarString)
     return CigarData(Cigar::FromStdString(cigarString));
 }
 
+CigarView BamRecordImpl::CigarDataView(void) const
+{ return CigarView(bam_get_cigar(d_), d_->core.n_cigar); }
+
+BamRecordImpl& BamRecordImpl::ClipSequenceAndTags(const size_t seqPosition,
+                                                  const size_t tagPosition,
+                                                  const size_t length,
+                                                  const std::vector<TagId>& perBaseTags)
+{
+    return ClipSequenceAndTagsImpl(nullptr, seqPosition, tagPosition, length, perBaseTags);
+}
+
+BamRecordImpl& BamRecordImpl::ClipSequenceAndTags(const Cigar& cigar,
+                                                  const size_t seqPosition,
+                                                  const size_t tagPosition,
+                                                  const size_t length,
+                                                  const std::vector<TagId>& perBaseTags)
+{
+    // a growing CIGAR can't be written in the same (compacting) pass
+    if (cigar.size() > d_->core.n_cigar) {
+        CigarData(cigar);
+        return ClipSequenceAndTagsImpl(nullptr, seqPosition, tagPosition, length, perBaseTags);
+    }
+    return ClipSequenceAndTagsImpl(&cigar, seqPosition, tagPosition, length, perBaseTags);
+}
+
+BamRecordImpl& BamRecordImpl::ClipSequenceAndTagsImpl(const Cigar* cigar,
+                                                      const size_t seqPosition,
+                                                      const size_t tagPosition,
+                                                      const size_t length,
+                                                      const std::vector<TagId>& perBaseTags)
+{
+    DetachData();
+
+    // current layout (tag offsets point at each tag's type code)
+    tagMapState_.EnsureValid([this]() { BuildTagMap(); });
+    uint8_t* data = d_->data;
+    const size_t oldSeqLength  = d_->core.l_qseq;
+    const size_t oldSeqOffset  = bam_get_seq(d_) - data;
+    const size_t oldQualOffset = bam_get_qual(d_) - data;
+    const size_t oldTagOffset  = bam_get_aux(d_) - data;
+    const size_t oldNumTagBytes = d_->l_data - oldTagOffset;
+    const size_t numTags = tagOffsets_.size();
+
+    // Check every tag's layout before changing anything, so a malformed
+    // record is left untouched rather than half-compacted.
+    const uint8_t* oldTags = data + oldTagOffset;
+    for (size_t i = 0; i < numTags; ++i) {
+        const size_t begin = tagOffsets_[i].second - 2;
+        const size_t end = (i+1 < numTags) ? tagOffsets_[i+1].second - 2
+                                           : oldNumTagBytes;
+        PB_ASSERT_OR_RETURN_VALUE(begin + 3 <= end && end <= oldNumTagBytes, *this);
+
+        bool isPerBaseTag = false;
+        for (const TagId& tagId : perBaseTags) {
+            if (tagId.Code() == tagOffsets_[i].first) {
+                isPerBaseTag = true;
+                break;
+            }
+        }
+        if (!isPerBaseTag)
+            continue;
+
+        const uint8_t* src = oldTags + begin;
+        const char tagType = static_cast<char>(src[2]);
+        if (tagType == 'Z' || tagType == 'H') {
+            PB_ASSERT_OR_RETURN_VALUE(end - begin >= 4 && src[end - begin - 1] == '\0', *this);
+        }
+        else if (tagType == 'B') {
+            PB_ASSERT_OR_RETURN_VALUE(end - begin >= 8, *this);
+            const size_t elementSize = internal::ArrayElementSize(static_cast<char>(src[3]));
+            PB_ASSERT_OR_RETURN_VALUE(elementSize != 0, *this);
+            uint32_t numElements = 0;
+            memcpy(&numElements, src + 4, sizeof(uint32_t));
+            PB_ASSERT_OR_RETURN_VALUE(8 + static_cast<size_t>(numElements)*elementSize <= end - begin, *this);
+        }
+    }
+    if (cigar) {
+        PB_ASSERT_OR_RETURN_VALUE(cigar->size() <= d_->core.n_cigar, *this);
+    }
+
+    // Everything below only shrinks, so each section is written at or before
+    // its old location & data can be shifted down front-to-back, in place.
+
+    // CIGAR
+    if (cigar) {
+        const size_t numCigarOps = cigar->size();
+        uint32_t* cigarData = bam_get_cigar(d_);
+        for (size_t i = 0; i < numCigarOps; ++i) {
+            const CigarOperation& cigarOp = (*cigar)[i];
+            cigarData[i] = bam_cigar_gen(cigarOp.Length(), static_cast<int>(cigarOp.Type()));
+        }
+        d_->core.n_cigar = numCigarOps;
+    }
+    size_t index = bam_get_seq(d_) - data;
+
+    // SEQ - 2 bases per byte, so an odd start shifts every base by a nibble
+    const size_t seqBegin = std::min(seqPosition, oldSeqLength);
+    const size_t seqEnd   = std::min(seqPosition + length, oldSeqLength);
+    const size_t newSeqLength = seqEnd - seqBegin;
+    const size_t newEncodedSeqLength = (newSeqLength + 1) / 2;
+    const uint8_t* oldSeq = data + oldSeqOffset;
+    uint8_t* newSeq = data + index;
+    if (seqBegin % 2 == 0) {
+        memmove(newSeq, oldSeq + seqBegin/2, newEncodedSeqLength);
+        if (newSeqLength % 2 == 1)
+            newSeq[newEncodedSeqLength-1] &= 0xF0;
+    } else {
+        for (size_t i = 0; i < newEncodedSeqLength; ++i) {
+            const size_t pos = seqBegin + 2*i;
+            const uint8_t high = oldSeq[pos/2] & 0x0F;
+            const uint8_t low  = (pos+1 < seqEnd) ? (oldSeq[(pos+1)/2] >> 4) : 0;
+            newSeq[i] = (high << 4) | low;
+        }
+    }
+    index += newEncodedSeqLength;
+
+    // QUAL
+    memmove(data + index, data + oldQualOffset + seqBegin, newSeqLength);
+    index += newSeqLength;
+    d_->core.l_qseq = newSeqLength;
+
+    // tags - slice listed string & array tags, shift the rest down as-is,
+    // updating offsets as we go
+    uint8_t* newTags = data + index;
+    size_t numTagBytes = 0;
+    for (size_t i = 0; i < numTags; ++i) {
+        const uint16_t tagCode = tagOffsets_[i].first;
+        const size_t begin = tagOffsets_[i].second - 2;
+        const size_t end = (i+1 < numTags) ? tagOffsets_[i+1].second - 2
+                                           : oldNumTagBytes;
+        tagOffsets_[i].second = static_cast<int>(numTagBytes + 2);
+
+        bool isPerBaseTag = false;
+        for (const TagId& tagId : perBaseTags) {
+            if (tagId.Code() == tagCode) {
+                isPerBaseTag = true;
+                break;
+            }
+        }
+
+        const uint8_t* src = oldTags + begin;
+        uint8_t* dst = newTags + numTagBytes;
+        const char tagType = static_cast<char>(src[2]);
+
+        // "<TAG><TYPE><STRING>\0"
+        if (isPerBaseTag && (tagType == 'Z' || tagType == 'H')) {
+            const size_t numChars = (end - begin) - 4;
+            const size_t clipBegin = std::min(tagPosition, numChars);
+            const size_t clipEnd   = std::min(tagPosition + length, numChars);
+            const size_t numCharsKept = clipEnd - clipBegin;
+            memmove(dst, src, 3);
+            memmove(dst + 3, src + 3 + clipBegin, numCharsKept);
+            dst[3 + numCharsKept] = '\0';
+            numTagBytes += 4 + numCharsKept;
+        }
+
+        // "<TAG>B<SUBTYPE><COUNT><ELEMENTS>"
+        else if (isPerBaseTag && tagType == 'B') {
+            const size_t elementSize = internal::ArrayElementSize(static_cast<char>(src[3]));
+            uint32_t numElements = 0;
+            memcpy(&numElements, src + 4, sizeof(uint32_t));
+            const size_t clipBegin = std::min(tagPosition, static_cast<size_t>(numElements));
+            const size_t clipEnd   = std::min(tagPosition + length, static_cast<size_t>(numElements));
+            const uint32_t numElementsKept = clipEnd - clipBegin;
+            memmove(dst, src, 4);
+            memcpy(dst + 4, &numElementsKept, sizeof(uint32_t));
+            memmove(dst + 8, src + 8 + clipBegin*elementSize, numElementsKept*elementSize);
+            numTagBytes += 8 + numElementsKept*elementSize;
+        }
+
+        // everything else
+        else {
+            if (dst != src)
+                memmove(dst, src, end - begin);
+            numTagBytes += (end - begin);
+        }
+    }
+    d_->l_data = index + numTagBytes;
+
+    // offsets already updated, no need to re-scan
+    tagMapState_.SetValid();
+    return *this;
+}
+
+void BamRecordImpl::DetachDataForOverwrite(void)
+{
+    if (d_.use_count() > 1) {
+        InitializeData();
+        InvalidateTagMap();
+    } else
+        std::atomic_thread_fence(std::memory_order_acquire); // see DetachData()
+}
+
+void BamRecordImpl::DuplicateData(void)
+{
+    d_.reset(bam_dup1(d_.get()), internal::HtslibRecordDeleter());
+    ++numDeepCopies_;
+}
+
 bool BamRecordImpl::EditTag(const string& tagName,
                             const Tag& newValue)
 {
@@ -181,19 +429,75 @@ bool BamRecordImpl::EditTag(const string& tagName,
 bool BamRecordImpl::EditTag(const string& tagName,
                             const Tag& newValue,
                             const TagModifier additionalModifier)
+{
+    if (tagName.size() != 2)
+        return false;
+    return EditTag(TagId(tagName[0], tagName[1]), newValue, additionalModifier);
+}
+
+bool BamRecordImpl::EditTag(const TagId& tagId,
+                            const Tag& newValue,
+                            const TagModifier additionalModifier)
 {
     // try remove old value (with delayed tag map update)
-    const bool removed = RemoveTagImpl(tagName);
+    const bool removed = RemoveTagImpl(tagId);
     if (!removed)
         return false;
 
-    // if old value removed, add new value
-    const bool added = AddTagImpl(tagName, newValue, additionalModifier);
-    if (added)
-        UpdateTagMap();
+    // if old value removed, add new value (data already detached by removal)
+    const bool added = AddTagImpl(tagId, newValue, additionalModifier);
+    InvalidateTagMap();
     return added;
 }
 
+BamRecordImpl& BamRecordImpl::EditTags(const TagBatch& batch)
+{
+    if (batch.IsEmpty())
+        return *this;
+
+    DetachData();
+
+    // current tag layout (offsets point at each tag's type code)
+    tagMapState_.EnsureValid([this]() { BuildTagMap(); });
+    uint8_t* tagStart = bam_get_aux(d_);
+    const size_t oldNumBytes = d_->l_data - (tagStart - d_->data);
+
+    // shift kept tags down over any replaced/removed ones, updating their
+    // offsets as we go
+    size_t numBytesKept = 0;
+    size_t numTagsKept = 0;
+    const size_t numTags = tagOffsets_.size();
+    for (size_t i = 0; i < numTags; ++i) {
+        const uint16_t tagCode = tagOffsets_[i].first;
+        const size_t begin = tagOffsets_[i].second - 2;
+        const size_t end = (i+1 < numTags) ? tagOffsets_[i+1].second - 2
+                                           : oldNumBytes;
+        if (batch.Changes(tagCode))
+            continue;
+        if (begin != numBytesKept)
+            memmove(tagStart + numBytesKept, tagStart + begin, end - begin);
+        tagOffsets_[numTagsKept++] = std::make_pair(tagCode, static_cast<int>(numBytesKept + 2));
+        numBytesKept += (end - begin);
+    }
+    tagOffsets_.resize(numTagsKept);
+
+    // resize once, then append new values
+    const size_t numBytesAdded = batch.data_.size();
+    d_->l_data = (tagStart - d_->data) + numBytesKept + numBytesAdded;
+    MaybeReallocData();
+    tagStart = bam_get_aux(d_);
+    if (numBytesAdded > 0)
+        memcpy(tagStart + numBytesKept, batch.data_.data(), numBytesAdded);
+
+    // offsets of new values are known, no need to re-scan
+    for (const auto& entry : batch.setTags_) {
+        const int offset = static_cast<int>(numBytesKept + entry.second + 2);
+        tagOffsets_.push_back(std::make_pair(entry.first, offset));
+    }
+    tagMapState_.SetValid();
+    return *this;
+}
+
 BamRecordImpl BamRecordImpl::FromRawData(const PBBAM_SHARED_PTR<bam1_t>& rawData)
 {
     BamRecordImpl result;
@@ -205,12 +509,15 @@ bool BamRecordImpl::HasTag(const string& tagName) const
 {
     if (tagName.size() != 2)
         return false;
-    return TagOffset(tagName) != -1;
+    return HasTag(TagId(tagName[0], tagName[1]));
 
     // 27635
 //    return bam_aux_get(d_.get(), tagName.c_str()) != 0;
 }
 
+bool BamRecordImpl::HasTag(const TagId& tagId) const
+{ return TagOffset(tagId) != -1; }
+
 void BamRecordImpl::InitializeData(void)
 {
     d_.reset(bam_init1(), internal::HtslibRecordDeleter());
@@ -230,6 +537,9 @@ void BamRecordImpl::InitializeData(void)
     d_->m_data = 0x800;
 }
 
+void BamRecordImpl::InvalidateTagMap(void) const
+{ tagMapState_.Invalidate(); }
+
 void BamRecordImpl::MaybeReallocData(void)
 {
     // about to grow data contents to l_data size, but m_data is our current max.
@@ -248,6 +558,8 @@ string BamRecordImpl::Name(void) const
 
 BamRecordImpl& BamRecordImpl::Name(const std::string& name)
 {
+    DetachData();
+
     // determine change in memory needed
     // diffNumBytes: pos -> growing, neg -> shrinking
     const size_t numChars = name.size() + 1; // +1 for NULL-term
@@ -277,41 +589,48 @@ QualityValues BamRecordImpl::Qualities(void) const
     if (qualData[0] == 0xff)
         return QualityValues();
 
-    const size_t numQuals = d_->core.l_qseq;
-    QualityValues result;
-    result.reserve(numQuals);
-    for (size_t i = 0; i < numQuals; ++i)
-        result.push_back(QualityValue(qualData[i]));
-    return result;
+    return QualityValues(qualData, d_->core.l_qseq);
+}
+
+TagView BamRecordImpl::QualitiesView(void) const
+{
+    const uint8_t* qualData = bam_get_qual(d_);
+    if (d_->core.l_qseq == 0 || qualData[0] == 0xff)
+        return TagView();
+    return TagView(TagDataType::UINT8_ARRAY, TagModifier::NONE, qualData, d_->core.l_qseq);
 }
 
 bool BamRecordImpl::RemoveTag(const string& tagName)
 {
-    const bool removed = RemoveTagImpl(tagName);
+    if (tagName.size() != 2)
+        return false;
+    return RemoveTag(TagId(tagName[0], tagName[1]));
+}
+
+bool BamRecordImpl::RemoveTag(const TagId& tagId)
+{
+    const bool removed = RemoveTagImpl(tagId);
     if (removed)
-        UpdateTagMap();
+        InvalidateTagMap();
     return removed;
 }
 
-bool BamRecordImpl::RemoveTagImpl(const string &tagName)
+bool BamRecordImpl::RemoveTagImpl(const TagId& tagId)
 {
-    if (tagName.size() != 2)
-        return false;
-    uint8_t* data = bam_aux_get(d_.get(), tagName.c_str());
-    if (data == 0)
+    // tag offsets point at each tag's type code, same as bam_aux_get()
+    const int offset = TagOffset(tagId);
+    if (offset == -1)
         return false;
+    DetachData();
+    uint8_t* data = bam_get_aux(d_) + offset;
     const bool ok = bam_aux_del(d_.get(), data) == 0;
     return ok;
 }
 
 string BamRecordImpl::Sequence(void) const
 {
-    string result;
-    result.reserve(d_->core.l_qseq);
-    static const string DnaLookup = string("=ACMGRSVTWYHKDBN");
-    const uint8_t* seqData = bam_get_seq(d_);
-    for (int i = 0; i < d_->core.l_qseq; ++i)
-        result.append(1, DnaLookup[bam_seqi(seqData, i)]);
+    string result(d_->core.l_qseq, '\0');
+    internal::DecodeSequence(bam_get_seq(d_), result.size(), &result[0]);
     return result;
 }
 
@@ -357,6 +676,8 @@ BamRecordImpl& BamRecordImpl::SetSequenceAndQualitiesInternal(const char* sequen
                                                               const char* qualities,
                                                               bool isPreencoded)
 {
+    DetachData();
+
     // determine change in memory needed
     // diffNumBytes: pos -> growing, neg -> shrinking
     const int encodedSequenceLength = static_cast<int>((sequenceLength+1)/2);
@@ -378,11 +699,8 @@ BamRecordImpl& BamRecordImpl::SetSequenceAndQualitiesInternal(const char* sequen
     uint8_t* pEncodedSequence = bam_get_seq(d_);
     if (isPreencoded) {
         memcpy(pEncodedSequence, sequence, encodedSequenceLength);
-    } else {
-        memset(pEncodedSequence, 0, encodedSequenceLength);
-        for (size_t i = 0; i < sequenceLength; ++i)
-            pEncodedSequence[i>>1] |= seq_nt16_table[(int)sequence[i]] << ((~i&1)<<2);
-    }
+    } else
+        internal::EncodeSequence(sequence, sequenceLength, pEncodedSequence);
 
     // fill in quality values
     uint8_t* encodedQualities = bam_get_qual(d_);
@@ -395,17 +713,16 @@ BamRecordImpl& BamRecordImpl::SetSequenceAndQualitiesInternal(const char* sequen
     return *this;
 }
 
-int BamRecordImpl::TagOffset(const string& tagName) const
+int BamRecordImpl::TagOffset(const TagId& tagId) const
 {
-    if (tagName.size() != 2)
-        throw std::runtime_error("invalid tag name size");
+    tagMapState_.EnsureValid([this]() { BuildTagMap(); });
 
-    if (tagOffsets_.empty())
-        UpdateTagMap();
-
-    const uint16_t tagCode = (static_cast<uint8_t>(tagName.at(0)) << 8) | static_cast<uint8_t>(tagName.at(1));
-    const auto found = tagOffsets_.find(tagCode);
-    return (found != tagOffsets_.cend() ? found->second : -1);
+    const uint16_t tagCode = tagId.Code();
+    for (const auto& entry : tagOffsets_) {
+        if (entry.first == tagCode)
+            return entry.second;
+    }
+    return -1;
 }
 
 BamRecordImpl& BamRecordImpl::Tags(const TagCollection& tags)
@@ -415,6 +732,8 @@ BamRecordImpl& BamRecordImpl::Tags(const TagCollection& tags)
     const size_t numBytes = tagData.size();
     const uint8_t* data = tagData.data();
 
+    DetachData();
+
     // determine change in memory needed
     uint8_t* tagStart = bam_get_aux(d_);
     const size_t oldNumBytes = d_->l_data - (tagStart - d_->data);
@@ -427,7 +746,7 @@ BamRecordImpl& BamRecordImpl::Tags(const TagCollection& tags)
     memcpy((void*)tagStart, data, numBytes);
 
     // update tag info
-    UpdateTagMap();
+    InvalidateTagMap();
     return *this;
 }
 
@@ -442,8 +761,12 @@ Tag BamRecordImpl::TagValue(const string& tagName) const
 {
     if (tagName.size() != 2)
         return Tag();
+    return TagValue(TagId(tagName[0], tagName[1]));
+}
 
-    const int offset = TagOffset(tagName);
+Tag BamRecordImpl::TagValue(const TagId& tagId) const
+{
+    const int offset = TagOffset(tagId);
     if (offset == -1)
         return Tag();
 
@@ -457,13 +780,77 @@ Tag BamRecordImpl::TagValue(const string& tagName) const
     return BamTagCodec::FromRawData(tagData);
 }
 
-void BamRecordImpl::UpdateTagMap(void) const
+TagView BamRecordImpl::TagValueView(const string& tagName) const
+{
+    if (tagName.size() != 2)
+        return TagView();
+    return TagValueView(TagId(tagName[0], tagName[1]));
+}
+
+TagView BamRecordImpl::TagValueView(const TagId& tagId) const
+{
+    const int offset = TagOffset(tagId);
+    if (offset == -1 || offset >= d_->l_data)
+        return TagView();
+
+    const uint8_t* tagData = bam_get_aux(d_) + offset;
+    const char tagType = static_cast<char>(*tagData++);
+    switch (tagType) {
+        case 'A' :
+        case 'a' : return TagView(TagDataType::UINT8, TagModifier::ASCII_CHAR, tagData, 1);
+        case 'c' : return TagView(TagDataType::INT8,   TagModifier::NONE, tagData, 1);
+        case 'C' : return TagView(TagDataType::UINT8,  TagModifier::NONE, tagData, 1);
+        case 's' : return TagView(TagDataType::INT16,  TagModifier::NONE, tagData, 1);
+        case 'S' : return TagView(TagDataType::UINT16, TagModifier::NONE, tagData, 1);
+        case 'i' : return TagView(TagDataType::INT32,  TagModifier::NONE, tagData, 1);
+        case 'I' : return TagView(TagDataType::UINT32, TagModifier::NONE, tagData, 1);
+        case 'f' : return TagView(TagDataType::FLOAT,  TagModifier::NONE, tagData, 1);
+
+        case 'Z' :
+        case 'H' :
+        {
+            const size_t length = strlen(reinterpret_cast<const char*>(tagData));
+            return TagView(TagDataType::STRING,
+                           (tagType == 'H' ? TagModifier::HEX_STRING : TagModifier::NONE),
+                           tagData,
+                           length);
+        }
+
+        case 'B' :
+        {
+            const char subTagType = static_cast<char>(*tagData++);
+            uint32_t numElements;
+            memcpy(&numElements, tagData, sizeof(uint32_t));
+            tagData += sizeof(uint32_t);
+
+            TagDataType type;
+            switch (subTagType) {
+                case 'c' : type = TagDataType::INT8_ARRAY;   break;
+                case 'C' : type = TagDataType::UINT8_ARRAY;  break;
+                case 's' : type = TagDataType::INT16_ARRAY;  break;
+                case 'S' : type = TagDataType::UINT16_ARRAY; break;
+                case 'i' : type = TagDataType::INT32_ARRAY;  break;
+                case 'I' : type = TagDataType::UINT32_ARRAY; break;
+                case 'f' : type = TagDataType::FLOAT_ARRAY;  break;
+
+                // unknown subTagType
+                default:
+                    PB_ASSERT_OR_RETURN_VALUE(false, TagView());
+            }
+            return TagView(type, TagModifier::NONE, tagData, numElements);
+        }
+
+        // unknown tagType
+        default:
+            PB_ASSERT_OR_RETURN_VALUE(false, TagView());
+    }
+    return TagView(); // to avoid compiler warning
+}
+
+void BamRecordImpl::BuildTagMap(void) const
 {
-    // clear out offsets, leave map structure basically intact
-    auto tagIter = tagOffsets_.begin();
-    auto tagEnd  = tagOffsets_.end();
-    for ( ; tagIter != tagEnd; ++tagIter )
-        tagIter->second = -1;
+    // clear out offsets, keeping storage for reuse
+    tagOffsets_.clear();
 
     const uint8_t* tagStart = bam_get_aux(d_);
     if (tagStart == 0)
@@ -479,9 +866,9 @@ void BamRecordImpl::UpdateTagMap(void) const
     while(i < numBytes) {
 
         // store (tag name code -> start offset into tag data)
-        tagNameCode = static_cast<char>(tagStart[i]) << 8 | static_cast<char>(tagStart[i+1]);
+        tagNameCode = static_cast<uint8_t>(tagStart[i]) << 8 | static_cast<uint8_t>(tagStart[i+1]);
         i += 2;
-        tagOffsets_[tagNameCode] = i;
+        tagOffsets_.push_back(std::make_pair(tagNameCode, static_cast<int>(i)));
 
         // skip tag contents
         const char tagType = static_cast<char>(tagStart[i++]);
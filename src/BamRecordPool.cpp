@@ -0,0 +1,92 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file BamRecordPool.cpp
+/// \brief Implements the BamRecordPool class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/BamRecordPool.h"
+#include "MemoryUtils.h"
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+BamRecordPool::BamRecordPool(const size_t maxSize)
+    : maxSize_(maxSize)
+{
+    // reserve up front, so releasing never has to grow (& copy) the free list
+    records_.reserve(maxSize_);
+}
+
+BamRecordPool::~BamRecordPool(void) { }
+
+BamRecord BamRecordPool::Acquire(void)
+{
+    if (records_.empty())
+        return BamRecord();
+
+    BamRecord record(std::move(records_.back()));
+    records_.pop_back();
+    return record;
+}
+
+void BamRecordPool::Clear(void)
+{ records_.clear(); }
+
+size_t BamRecordPool::MaxSize(void) const
+{ return maxSize_; }
+
+void BamRecordPool::Release(BamRecord&& record)
+{
+    if (records_.size() >= maxSize_)
+        return;
+    if (!internal::BamRecordMemory::GetRawData(record))
+        return;
+    if (internal::BamRecordMemory::IsRawDataShared(record))
+        return;
+    records_.push_back(std::move(record));
+}
+
+void BamRecordPool::Release(std::vector<BamRecord>& records)
+{
+    for (BamRecord& record : records)
+        Release(std::move(record));
+    records.clear();
+}
+
+size_t BamRecordPool::Size(void) const
+{ return records_.size(); }
@@ -0,0 +1,94 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file BamRecordTags.h
+/// \brief Defines the tag names used by BamRecord's PacBio-specific fields.
+//
+// Author: Derek Barnett
+
+#ifndef BAMRECORDTAGS_H
+#define BAMRECORDTAGS_H
+
+#include "pbbam/TagId.h"
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// BAM record tag names
+static constexpr TagId tagName_alternative_labelQV     ('p', 'v');
+static constexpr TagId tagName_alternative_labelTag    ('p', 't');
+static constexpr TagId tagName_barcodes                ('b', 'c');
+static constexpr TagId tagName_barcode_quality         ('b', 'q');
+static constexpr TagId tagName_contextFlags            ('c', 'x');
+static constexpr TagId tagName_holeNumber              ('z', 'm');
+static constexpr TagId tagName_deletionQV              ('d', 'q');
+static constexpr TagId tagName_deletionTag             ('d', 't');
+static constexpr TagId tagName_insertionQV             ('i', 'q');
+static constexpr TagId tagName_ipd                     ('i', 'p');
+static constexpr TagId tagName_labelQV                 ('p', 'q');
+static constexpr TagId tagName_mergeQV                 ('m', 'q');
+static constexpr TagId tagName_numPasses               ('n', 'p');
+static constexpr TagId tagName_pkmean                  ('p', 'a');
+static constexpr TagId tagName_pkmid                   ('p', 'm');
+static constexpr TagId tagName_pkmean2                 ('p', 's');
+static constexpr TagId tagName_pkmid2                  ('p', 'i');
+static constexpr TagId tagName_pre_pulse_frames        ('p', 'd');
+static constexpr TagId tagName_pulse_call              ('p', 'c');
+static constexpr TagId tagName_pulse_call_width        ('p', 'x');
+static constexpr TagId tagName_pulseMergeQV            ('p', 'g');
+static constexpr TagId tagName_pulseWidth              ('p', 'w');
+static constexpr TagId tagName_queryStart              ('q', 's');
+static constexpr TagId tagName_queryEnd                ('q', 'e');
+static constexpr TagId tagName_readAccuracy            ('r', 'q');
+static constexpr TagId tagName_readGroup               ('R', 'G');
+static constexpr TagId tagName_scrap_region_type       ('s', 'c');
+static constexpr TagId tagName_scrap_zmw_type          ('s', 'z');
+static constexpr TagId tagName_snr                     ('s', 'n');
+static constexpr TagId tagName_startFrame              ('s', 'f');
+static constexpr TagId tagName_substitutionQV          ('s', 'q');
+static constexpr TagId tagName_substitutionTag         ('s', 't');
+
+// faux (helper) tag names
+// (not valid tag names, so these can't clash with real tags)
+static constexpr TagId tagName_QUAL('\0', 'Q');
+static constexpr TagId tagName_SEQ ('\0', 'S');
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+#endif // BAMRECORDTAGS_H
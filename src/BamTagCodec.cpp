@@ -61,6 +61,50 @@ inline void appendBamMultiValue(const vector<T>& container, kstring_t* str)
     kputsn_((char*)&container[0], n*sizeof(T), str);
 }
 
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// Destinations for BamTagCodec::EncodeTags: one only counts bytes (to size
+// the output up front), the other writes them to memory already sized.
+struct TagByteCounter
+{
+    TagByteCounter(void) : numBytes_(0) { }
+    void Put(const void*, const size_t n) { numBytes_ += n; }
+    void Put(const char)                  { ++numBytes_; }
+    size_t numBytes_;
+};
+
+struct TagByteWriter
+{
+    explicit TagByteWriter(uint8_t* out) : out_(out) { }
+    void Put(const void* data, const size_t n) { memcpy(out_, data, n); out_ += n; }
+    void Put(const char c)                     { *out_++ = static_cast<uint8_t>(c); }
+    uint8_t* out_;
+};
+
+template<typename T, typename Sink>
+inline void PutBamValue(const T& value, Sink& sink)
+{ sink.Put(&value, sizeof(value)); }
+
+// "B<element type><count><elements>"
+template<typename T, typename Sink>
+inline void PutBamMultiValue(const char elementType,
+                             const vector<T>& container,
+                             Sink& sink)
+{
+    const uint32_t n = container.size();
+    sink.Put('B');
+    sink.Put(elementType);
+    sink.Put(&n, sizeof(n));
+    if (n > 0)
+        sink.Put(container.data(), n*sizeof(T));
+}
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
 template<typename T>
 inline T readBamValue(const uint8_t* src, size_t& offset)
 {
@@ -164,8 +208,34 @@ TagCollection BamTagCodec::Decode(const vector<uint8_t>& data)
 
 vector<uint8_t> BamTagCodec::Encode(const TagCollection& tags)
 {
-    kstring_t str = { 0, 0, NULL };
+    vector<uint8_t> result(EncodedSize(tags));
+    if (!result.empty()) {
+        const size_t numBytes = Encode(tags, result.data());
+        if (numBytes != result.size())
+            result.clear();
+    }
+    return result;
+}
 
+size_t BamTagCodec::Encode(const TagCollection& tags, uint8_t* out)
+{
+    internal::TagByteWriter writer(out);
+    if (!EncodeTags(tags, writer))
+        return 0;
+    return writer.out_ - out;
+}
+
+size_t BamTagCodec::EncodedSize(const TagCollection& tags)
+{
+    internal::TagByteCounter counter;
+    if (!EncodeTags(tags, counter))
+        return 0;
+    return counter.numBytes_;
+}
+
+template<typename Sink>
+bool BamTagCodec::EncodeTags(const TagCollection& tags, Sink& sink)
+{
     const auto tagEnd  = tags.cend();
     for (auto tagIter = tags.cbegin(); tagIter != tagEnd; ++tagIter) {
         const string& name = (*tagIter).first;
@@ -175,136 +245,121 @@ vector<uint8_t> BamTagCodec::Encode(const TagCollection& tags)
             continue;
 
         // "<TAG>:"
-        kputsn_(name.c_str(), 2, &str);
+        sink.Put(name.c_str(), 2);
 
         // "<TYPE>:<DATA>" for printable, ASCII char
         if (tag.HasModifier(TagModifier::ASCII_CHAR)) {
             char c = tag.ToAscii();
             if (c != '\0') {
-                kputc_('A', &str);
-                kputc_(c, &str);
+                sink.Put('A');
+                sink.Put(c);
                 continue;
             }
         }
 
         // "<TYPE>:<DATA>" for all other data
+        //
+        // NOTE: strings & arrays are read in place (not via Tag::To*(), which
+        // return copies), since this may be run twice per tag: once to size
+        // the output, then again to write it
+        //
         switch ( tag.Type() ) {
             case TagDataType::INT8   :
             {
-                kputc_('c', &str);
-                appendBamValue(tag.ToInt8(), &str);
+                sink.Put('c');
+                internal::PutBamValue(tag.ToInt8(), sink);
                 break;
             }
             case TagDataType::UINT8  :
             {
-                kputc_('C', &str);
-                appendBamValue(tag.ToUInt8(), &str);
+                sink.Put('C');
+                internal::PutBamValue(tag.ToUInt8(), sink);
                 break;
             }
             case TagDataType::INT16  :
             {
-                kputc_('s', &str);
-                appendBamValue(tag.ToInt16(), &str);
+                sink.Put('s');
+                internal::PutBamValue(tag.ToInt16(), sink);
                 break;
             }
             case TagDataType::UINT16 :
             {
-                kputc_('S', &str);
-                appendBamValue(tag.ToUInt16(), &str);
+                sink.Put('S');
+                internal::PutBamValue(tag.ToUInt16(), sink);
                 break;
             }
             case TagDataType::INT32  :
             {
-                kputc_('i', &str);
-                appendBamValue(tag.ToInt32(), &str);
+                sink.Put('i');
+                internal::PutBamValue(tag.ToInt32(), sink);
                 break;
             }
             case TagDataType::UINT32 :
             {
-                kputc_('I', &str);
-                appendBamValue(tag.ToUInt32(), &str);
+                sink.Put('I');
+                internal::PutBamValue(tag.ToUInt32(), sink);
                 break;
             }
-            case TagDataType::FLOAT :
+            case TagDataType::FLOAT  :
             {
-                kputc_('f', &str);
-                appendBamValue(tag.ToFloat(), &str);
+                sink.Put('f');
+                internal::PutBamValue(tag.ToFloat(), sink);
                 break;
             }
 
             case TagDataType::STRING :
             {
                 if (tag.HasModifier(TagModifier::HEX_STRING))
-                    kputc_('H', &str);
+                    sink.Put('H');
                 else
-                    kputc_('Z', &str);
-                const string& s = tag.ToString();
-                kputsn_(s.c_str(), s.size()+1, &str); // this adds the null-term
+                    sink.Put('Z');
+                const string& s = boost::get<string>(tag.data_);
+                sink.Put(s.c_str(), s.size()+1); // this adds the null-term
                 break;
             }
 
             case TagDataType::INT8_ARRAY   :
             {
-                kputc_('B', &str);
-                kputc_('c', &str);
-                appendBamMultiValue(tag.ToInt8Array(), &str);
+                internal::PutBamMultiValue('c', boost::get< vector<int8_t> >(tag.data_), sink);
                 break;
             }
             case TagDataType::UINT8_ARRAY  :
             {
-                kputc_('B', &str);
-                kputc_('C', &str);
-                appendBamMultiValue(tag.ToUInt8Array(), &str);
+                internal::PutBamMultiValue('C', boost::get< vector<uint8_t> >(tag.data_), sink);
                 break;
             }
             case TagDataType::INT16_ARRAY  :
             {
-                kputc_('B', &str);
-                kputc_('s', &str);
-                appendBamMultiValue(tag.ToInt16Array(), &str);
+                internal::PutBamMultiValue('s', boost::get< vector<int16_t> >(tag.data_), sink);
                 break;
             }
             case TagDataType::UINT16_ARRAY :
             {
-                kputc_('B', &str);
-                kputc_('S', &str);
-                appendBamMultiValue(tag.ToUInt16Array(), &str);
+                internal::PutBamMultiValue('S', boost::get< vector<uint16_t> >(tag.data_), sink);
                 break;
             }
             case TagDataType::INT32_ARRAY  :
             {
-                kputc_('B', &str);
-                kputc_('i', &str);
-                appendBamMultiValue(tag.ToInt32Array(), &str);
+                internal::PutBamMultiValue('i', boost::get< vector<int32_t> >(tag.data_), sink);
                 break;
             }
             case TagDataType::UINT32_ARRAY :
             {
-                kputc_('B', &str);
-                kputc_('I', &str);
-                appendBamMultiValue(tag.ToUInt32Array(), &str);
+                internal::PutBamMultiValue('I', boost::get< vector<uint32_t> >(tag.data_), sink);
                 break;
             }
-            case TagDataType::FLOAT_ARRAY :
+            case TagDataType::FLOAT_ARRAY  :
             {
-                kputc_('B', &str);
-                kputc_('f', &str);
-                appendBamMultiValue(tag.ToFloatArray(), &str);
+                internal::PutBamMultiValue('f', boost::get< vector<float> >(tag.data_), sink);
                 break;
             }
 
             // unsupported tag type
             default :
-                free(str.s);
-                PB_ASSERT_OR_RETURN_VALUE(false, vector<uint8_t>());
+                PB_ASSERT_OR_RETURN_VALUE(false, false);
         }
     }
-
-    vector<uint8_t> result;
-    result.resize(str.l);
-    memcpy((char*)&result[0], str.s, str.l);
-    free(str.s);
-    return result;
+    return true;
 }
 
 Tag BamTagCodec::FromRawData(uint8_t* rawData)
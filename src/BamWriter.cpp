@@ -37,13 +37,16 @@
 
 #include "pbbam/BamWriter.h"
 #include "pbbam/BamFile.h"
+#include "pbbam/PbiBuilder.h"
 #include "pbbam/Validator.h"
 #include "AssertUtils.h"
+#include "BaiBuilder.h"
 #include "FileProducer.h"
 #include "MemoryUtils.h"
 #include <htslib/bgzf.h>
 #include <htslib/hfile.h>
 #include <htslib/hts.h>
+#include <exception>
 #include <iostream>
 #include <thread>
 using namespace PacBio;
@@ -54,6 +57,13 @@ namespace PacBio {
 namespace BAM {
 namespace internal {
 
+// Older htslib does not keep bgzf_tell() current for multithreaded output.
+// The underlying file position is, as long as no compressed blocks are left
+// queued, so the writer flushes (only) at block boundaries when indexing.
+static inline
+int64_t VirtualTell(BGZF* bgzf)
+{ return (static_cast<int64_t>(htell(bgzf->fp)) << 16) | bgzf->block_offset; }
+
 class BamWriterPrivate : public internal::FileProducer
 {
 public:
@@ -61,24 +71,32 @@ public:
                      const PBBAM_SHARED_PTR<bam_hdr_t> rawHeader,
                      const BamWriter::CompressionLevel compressionLevel,
                      const size_t numThreads,
-                     const BamWriter::BinCalculationMode binCalculationMode);
+                     const BamWriter::BinCalculationMode binCalculationMode,
+                     const BamWriter::IndexTypes indexTypes);
+    ~BamWriterPrivate(void);
 
 public:
     void Write(const BamRecord& record);
     void Write(const BamRecord& record, int64_t* vOffset);
     void Write(const BamRecordImpl& recordImpl);
 
+private:
+    void RawWrite(const BamRecord& record);
+
 public:
     bool calculateBins_;
     std::unique_ptr<samFile, internal::HtslibFileDeleter> file_;
     PBBAM_SHARED_PTR<bam_hdr_t> header_;
+    std::unique_ptr<PbiBuilder> pbiBuilder_;
+    std::unique_ptr<BaiBuilder> baiBuilder_;
 };
 
 BamWriterPrivate::BamWriterPrivate(const string& filename,
                                    const PBBAM_SHARED_PTR<bam_hdr_t> rawHeader,
                                    const BamWriter::CompressionLevel compressionLevel,
                                    const size_t numThreads,
-                                   const BamWriter::BinCalculationMode binCalculationMode)
+                                   const BamWriter::BinCalculationMode binCalculationMode,
+                                   const BamWriter::IndexTypes indexTypes)
     : internal::FileProducer(filename)
     , calculateBins_(binCalculationMode == BamWriter::BinCalculation_ON)
     , file_(nullptr)
@@ -112,9 +130,64 @@ BamWriterPrivate::BamWriterPrivate(const string& filename,
     const int ret = sam_hdr_write(file_.get(), header_.get());
     if (ret != 0)
         throw std::runtime_error("could not write header");
+
+    // setup requested on-the-fly indices
+    if (indexTypes == BamWriter::NoIndex)
+        return;
+    if (filename == "-")
+        throw std::runtime_error("cannot generate index files when writing to stdout");
+
+    // first record starts in a new block, just past the header
+    BGZF* bgzf = file_.get()->fp.bgzf;
+    if (bgzf_flush(bgzf) != 0)
+        throw std::runtime_error("could not flush output buffer contents");
+
+    if (indexTypes & BamWriter::PacBioIndex)
+        pbiBuilder_.reset(new PbiBuilder(filename + ".pbi",
+                                         header_->n_targets,
+                                         PbiBuilder::DefaultCompression,
+                                         actualNumThreads));
+    if (indexTypes & BamWriter::StandardIndex)
+        baiBuilder_.reset(new BaiBuilder(filename, header_->n_targets, VirtualTell(bgzf)));
+}
+
+BamWriterPrivate::~BamWriterPrivate(void)
+{
+    if (!baiBuilder_ && !pbiBuilder_)
+        return;
+
+    // leave index files (and BAM) unfinished if unwinding from an exception
+    if (std::uncaught_exception())
+        return;
+
+    // destructor must not throw: an index that cannot be finished is not
+    // written (see BaiBuilder::Save)
+    try {
+        // capture end of record data, before the EOF marker block
+        BGZF* bgzf = file_.get()->fp.bgzf;
+        assert(bgzf);
+        bgzf_flush(bgzf);
+        const int64_t eofOffset = VirtualTell(bgzf);
+
+        // close BAM before writing indices, so they are not older than the data
+        file_.reset();
+        if (baiBuilder_)
+            baiBuilder_->Save(eofOffset);
+        pbiBuilder_.reset();
+    } catch (...) { }
 }
 
 void BamWriterPrivate::Write(const BamRecord& record)
+{
+    // indices require the record's offset
+    if (pbiBuilder_ || baiBuilder_) {
+        int64_t vOffset;
+        Write(record, &vOffset);
+    } else
+        RawWrite(record);
+}
+
+void BamWriterPrivate::RawWrite(const BamRecord& record)
 {
 #if PBBAM_AUTOVALIDATE
     Validator::Validate(record);
@@ -124,11 +197,16 @@ void BamWriterPrivate::Write(const BamRecord& record)
 
     // (probably) store bins
     // min_shift=14 & n_lvls=5 are BAM "magic numbers"
+    //
+    // The bin is set on a shallow copy of the record's core data (pointing at
+    // the same variable-length data), as the record's data may be shared with
+    // copies being read elsewhere.
+    bam1_t toWrite = *rawRecord;
     if (calculateBins_)
-        rawRecord->core.bin = hts_reg2bin(rawRecord->core.pos, bam_endpos(rawRecord.get()), 14, 5);
+        toWrite.core.bin = hts_reg2bin(toWrite.core.pos, bam_endpos(&toWrite), 14, 5);
 
     // write record to file
-    const int ret = sam_write1(file_.get(), header_.get(), rawRecord.get());
+    const int ret = sam_write1(file_.get(), header_.get(), &toWrite);
     if (ret <= 0)
         throw std::runtime_error("could not write record");
 }
@@ -139,16 +217,42 @@ void BamWriterPrivate::Write(const BamRecord& record, int64_t* vOffset)
     assert(bgzf);
     assert(vOffset);
 
-    // ensure offsets up-to-date
-    bgzf_flush(bgzf);
+    // without indices, earlier multithreaded writes may have left blocks queued
+    if (bgzf->mt && !pbiBuilder_ && !baiBuilder_) {
+        if (bgzf_flush(bgzf) != 0)
+            throw std::runtime_error("could not flush output buffer contents");
+    }
+
+    // htslib starts a new block for a record that does not fit in the current
+    // one (bgzf_flush_try). Do that here first, so the record's start offset
+    // is known up front. The previous record now ends at the new block.
+    const auto rawRecord = internal::BamRecordMemory::GetRawData(record);
+    const int64_t recordLength = 4 + 32 + rawRecord->l_data; // block_size + core + data
+    if (bgzf->block_offset + recordLength > BGZF_BLOCK_SIZE) {
+        if (bgzf_flush(bgzf) != 0)
+            throw std::runtime_error("could not flush output buffer contents");
+        if (baiBuilder_)
+            baiBuilder_->AmendLastOffset(VirtualTell(bgzf));
+    }
 
     // capture virtual offset where we’re about to write
-    const off_t rawTell = htell(bgzf->fp);
-    const int length = bgzf->block_offset;
-    *vOffset = (rawTell << 16) | length ;
+    const int startBlockOffset = bgzf->block_offset;
+    *vOffset = VirtualTell(bgzf);
 
     // now write data
-    Write(record);
+    RawWrite(record);
+
+    // record filled (at least) one block, which multithreaded output only queues
+    if (bgzf->mt && startBlockOffset + recordLength >= BGZF_BLOCK_SIZE) {
+        if (bgzf_flush(bgzf) != 0)
+            throw std::runtime_error("could not flush output buffer contents");
+    }
+
+    // update indices, BAI with the offset just past the record
+    if (pbiBuilder_)
+        pbiBuilder_->AddRecord(record, *vOffset);
+    if (baiBuilder_)
+        baiBuilder_->AddRecord(record, VirtualTell(bgzf));
 }
 
 inline void BamWriterPrivate::Write(const BamRecordImpl& recordImpl)
@@ -162,7 +266,8 @@ BamWriter::BamWriter(const std::string& filename,
                      const BamHeader& header,
                      const BamWriter::CompressionLevel compressionLevel,
                      const size_t numThreads,
-                     const BinCalculationMode binCalculationMode)
+                     const BinCalculationMode binCalculationMode,
+                     const IndexTypes indexTypes)
     : d_(nullptr)
 {
 #if PBBAM_AUTOVALIDATE
@@ -172,7 +277,8 @@ BamWriter::BamWriter(const std::string& filename,
                                              internal::BamHeaderMemory::MakeRawHeader(header),
                                              compressionLevel,
                                              numThreads,
-                                             binCalculationMode
+                                             binCalculationMode,
+                                             indexTypes
                                            });
 }
 
@@ -184,9 +290,14 @@ BamWriter::~BamWriter(void)
 void BamWriter::TryFlush(void)
 {
     // TODO: sanity checks on file_ & fp
-    const int ret = bgzf_flush(d_->file_.get()->fp.bgzf);
+    BGZF* bgzf = d_->file_.get()->fp.bgzf;
+    const int ret = bgzf_flush(bgzf);
     if (ret != 0)
         throw std::runtime_error("could not flush output buffer contents");
+
+    // last record written now ends at the new block
+    if (d_->baiBuilder_)
+        d_->baiBuilder_->AmendLastOffset(internal::VirtualTell(bgzf));
 }
 
 void BamWriter::Write(const BamRecord& record)
@@ -42,7 +42,9 @@
 #include "pbbam/Frames.h"
 #include <algorithm>
 #include <cassert>
-#include <cmath>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 using namespace PacBio;
 using namespace PacBio::BAM;
 using namespace std;
@@ -51,95 +53,136 @@ namespace PacBio {
 namespace BAM {
 namespace internal {
 
-static vector<uint16_t> framepoints;
-static vector<uint8_t> frameToCode;
-static uint16_t maxFramepoint;
+// The lossy frame codec (see kineticsTools/_downsampling.py) maps frame counts
+// onto 4 groups of 64 codes, with group g stepping by 2^g frames. Both
+// directions have a closed form, so no lookup tables need to be built (or
+// guarded against concurrent initialization):
+//
+//   code  -> frames : ((64 + (code & 63)) << (code >> 6)) - 64
+//   frames -> code  : (g << 6) + ((f - base(g) + grain(g)/2) >> g)
+//
+// where f is the frame count clamped to the largest framepoint (952) and g
+// is the group containing f. Ties within a group round up, matching the
+// original table construction.
+//
+static const uint16_t maxFramepoint = 952;
 
-static
-void InitIpdDownsampling(void)
+static inline
+uint16_t CodeToFrames(const uint8_t code)
 {
-    if (!framepoints.empty())
-        return;
-
-    // liftover from Dave's python code:
-    // .../bioinformatics/tools/kineticsTools/kineticsTools/_downsampling.py
-
-    const int B = 2;
-    const int t = 6;
-    const double T = pow(B, t);
-
-    int next = 0;
-    double grain;
-    const int end = 256/T;
-    for (int i = 0; i < end; ++i) {
-        grain = pow(B, i);
-        vector<uint16_t> nextOnes;
-        for (double j = 0; j < T; ++j)
-            nextOnes.push_back(j*grain + next);
-        next = nextOnes.back() + grain;
-        framepoints.insert(framepoints.end(), nextOnes.cbegin(), nextOnes.cend());
-    }
-    assert(framepoints.size()-1 <= UINT8_MAX);
-
-    const uint16_t maxElement = (*max_element(framepoints.cbegin(), framepoints.cend()));
-    frameToCode.assign(maxElement+1, 0);
-
-    const int fpEnd = framepoints.size() - 1;
-    uint8_t i = 0;
-    uint16_t fl = 0;
-    uint16_t fu = 0;
-    for (; i < fpEnd; ++i) {
-        fl = framepoints[i];
-        fu = framepoints[i+1];
-        if (fu > fl+1) {
-            const int middle = (fl+fu)/2;
-            for (int f = fl; f < middle; ++f)
-                frameToCode[f] = i;
-            for (int f = middle; f < fu; ++f)
-                frameToCode[f] = i+1;
-        } else
-            frameToCode[fl] = i;
-    }
+    return static_cast<uint16_t>(((64u + (code & 63u)) << (code >> 6)) - 64u);
+}
 
-    // this next line differs from the python implementation (there, it's "i+1")
-    // our C++ for loop has incremented our index counter one more time than the indexes from python enumerate(...)
-    frameToCode[fu] = i;
-    maxFramepoint = fu;
+static inline
+uint8_t FramesToCode(const uint16_t frame)
+{
+    const uint32_t f = std::min(frame, maxFramepoint);
+    const uint32_t g = (f >= 64) + (f >= 192) + (f >= 448);
+    const uint32_t base = (64u << g) - 64u;
+    const uint32_t halfGrain = (1u << g) >> 1;
+    return static_cast<uint8_t>((g << 6) + ((f - base + halfGrain) >> g));
 }
 
+#if defined(__SSE2__)
+
+// Decodes 8 codes (already widened to 16-bit lanes).
 static inline
-uint16_t CodeToFrames(const uint8_t code)
+__m128i CodeToFrames_SSE2(const __m128i codes)
 {
-    return framepoints[code];
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i g = _mm_srli_epi16(codes, 6);
+
+    // multiplier = 1 << g, built from per-lane compares (SSE2 has no variable shifts)
+    __m128i mult = _mm_set1_epi16(1);
+    mult = _mm_add_epi16(mult, _mm_and_si128(_mm_cmpgt_epi16(g, zero),              _mm_set1_epi16(1)));
+    mult = _mm_add_epi16(mult, _mm_and_si128(_mm_cmpgt_epi16(g, _mm_set1_epi16(1)), _mm_set1_epi16(2)));
+    mult = _mm_add_epi16(mult, _mm_and_si128(_mm_cmpgt_epi16(g, _mm_set1_epi16(2)), _mm_set1_epi16(4)));
+
+    const __m128i x = _mm_add_epi16(_mm_and_si128(codes, _mm_set1_epi16(63)), _mm_set1_epi16(64));
+    return _mm_sub_epi16(_mm_mullo_epi16(x, mult), _mm_set1_epi16(64));
 }
 
-static
-vector<uint16_t> CodeToFrames(const vector<uint8_t>& codedData)
+// Encodes 8 frame counts, returning codes in 16-bit lanes.
+static inline
+__m128i FramesToCode_SSE2(const __m128i frames)
 {
-    InitIpdDownsampling();
+    // unsigned min(frames, maxFramepoint)
+    const __m128i f = _mm_sub_epi16(frames, _mm_subs_epu16(frames, _mm_set1_epi16(maxFramepoint)));
+
+    // group masks (f <= 952, so signed compares are safe)
+    const __m128i g1 = _mm_cmpgt_epi16(f, _mm_set1_epi16(63));
+    const __m128i g2 = _mm_cmpgt_epi16(f, _mm_set1_epi16(191));
+    const __m128i g3 = _mm_cmpgt_epi16(f, _mm_set1_epi16(447));
+
+    const __m128i base = _mm_add_epi16(_mm_and_si128(g1, _mm_set1_epi16(64)),
+                         _mm_add_epi16(_mm_and_si128(g2, _mm_set1_epi16(128)),
+                                       _mm_and_si128(g3, _mm_set1_epi16(256))));
+    const __m128i halfGrain = _mm_add_epi16(_mm_and_si128(g1, _mm_set1_epi16(1)),
+                              _mm_add_epi16(_mm_and_si128(g2, _mm_set1_epi16(1)),
+                                            _mm_and_si128(g3, _mm_set1_epi16(2))));
+    const __m128i groupCode = _mm_add_epi16(_mm_and_si128(g1, _mm_set1_epi16(64)),
+                              _mm_add_epi16(_mm_and_si128(g2, _mm_set1_epi16(64)),
+                                            _mm_and_si128(g3, _mm_set1_epi16(64))));
+
+    // x >> g, computed as mulhi(x << 1, 0x8000 >> g)
+    __m128i shiftMult = _mm_set1_epi16(static_cast<short>(0x8000));
+    shiftMult = _mm_sub_epi16(shiftMult, _mm_and_si128(g1, _mm_set1_epi16(0x4000)));
+    shiftMult = _mm_sub_epi16(shiftMult, _mm_and_si128(g2, _mm_set1_epi16(0x2000)));
+    shiftMult = _mm_sub_epi16(shiftMult, _mm_and_si128(g3, _mm_set1_epi16(0x1000)));
+
+    const __m128i x = _mm_add_epi16(_mm_sub_epi16(f, base), halfGrain);
+    const __m128i idx = _mm_mulhi_epu16(_mm_slli_epi16(x, 1), shiftMult);
+    return _mm_add_epi16(groupCode, idx);
+}
+
+#endif // __SSE2__
 
-    const size_t length = codedData.size();
-    vector<uint16_t> frames(length, 0);
-    for (size_t i = 0; i < length; ++i)
+static
+void CodeToFrames(const uint8_t* codedData, const size_t length, uint16_t* frames)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        const __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codedData + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(frames + i),
+                         CodeToFrames_SSE2(_mm_unpacklo_epi8(codes, zero)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(frames + i + 8),
+                         CodeToFrames_SSE2(_mm_unpackhi_epi8(codes, zero)));
+    }
+#endif
+    for (; i < length; ++i)
         frames[i] = CodeToFrames(codedData[i]);
+}
+
+static
+vector<uint16_t> CodeToFrames(const uint8_t* codedData, const size_t length)
+{
+    vector<uint16_t> frames(length);
+    CodeToFrames(codedData, length, frames.data());
     return frames;
 }
 
-static inline
-uint8_t FramesToCode(const uint16_t frame)
+static
+void FramesToCode(const uint16_t* frames, const size_t length, uint8_t* codedData)
 {
-    return frameToCode[std::min(maxFramepoint, frame)];
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= length; i += 16) {
+        const __m128i lo = FramesToCode_SSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(frames + i)));
+        const __m128i hi = FramesToCode_SSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(frames + i + 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(codedData + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < length; ++i)
+        codedData[i] = FramesToCode(frames[i]);
 }
 
 static
 vector<uint8_t> FramesToCode(const vector<uint16_t>& frames)
 {
-    InitIpdDownsampling();
-
-    const size_t length = frames.size();
-    vector<uint8_t> result(length, 0);
-    for (size_t i = 0; i < length; ++i)
-        result[i] = FramesToCode(frames[i]);
+    vector<uint8_t> result(frames.size());
+    FramesToCode(frames.data(), frames.size(), result.data());
     return result;
 }
 
@@ -175,7 +218,27 @@ Frames& Frames::operator=(Frames&& other)
 { data_ = std::move(other.data_); return *this; }
 
 Frames Frames::Decode(const std::vector<uint8_t>& codedData)
-{ return Frames(internal::CodeToFrames(codedData)); }
+{ return Frames(internal::CodeToFrames(codedData.data(), codedData.size())); }
+
+Frames Frames::Decode(const uint8_t* codedData, const size_t length)
+{ return Frames(internal::CodeToFrames(codedData, length)); }
+
+void Frames::Decode(const uint8_t* codedData,
+                    const size_t length,
+                    Frames* frames)
+{
+    assert(frames);
+    frames->data_.resize(length);
+    internal::CodeToFrames(codedData, length, frames->data_.data());
+}
+
+void Frames::Decode(const uint8_t* codedData,
+                    const size_t length,
+                    uint16_t* frames)
+{
+    assert(frames);
+    internal::CodeToFrames(codedData, length, frames);
+}
 
 std::vector<uint8_t> Frames::Encode(const std::vector<uint16_t>& frames)
 { return internal::FramesToCode(frames); }
@@ -159,12 +159,12 @@ IndexedFastaReader::ReferenceSubsequence(const BamRecord& bamRecord,
     if (bamRecord.Impl().IsMapped() && gapped)
     {
         size_t seqIndex = 0;
-        const Cigar& cigar = bamRecord.Impl().CigarData();
-        Cigar::const_iterator cigarIter = cigar.cbegin();
-        Cigar::const_iterator cigarEnd = cigar.cend();
+        const CigarView cigar = bamRecord.Impl().CigarDataView();
+        CigarView::const_iterator cigarIter = cigar.begin();
+        CigarView::const_iterator cigarEnd = cigar.end();
         for (; cigarIter != cigarEnd; ++cigarIter)
         {
-            const CigarOperation& op = (*cigarIter);
+            const CigarOperation op = (*cigarIter);
             const CigarOperationType& type = op.Type();
 
             // do nothing for hard clips
@@ -44,6 +44,7 @@
 #include "pbbam/BamRecordImpl.h"
 #include <htslib/bgzf.h>
 #include <htslib/sam.h>
+#include <atomic>
 #include <memory>
 
 namespace PacBio {
@@ -133,6 +134,13 @@ public:
     static PBBAM_SHARED_PTR<bam1_t> GetRawData(const BamRecordImpl& impl);
     static PBBAM_SHARED_PTR<bam1_t> GetRawData(const BamRecordImpl* impl);
 
+    // Returns the record's raw data, for callers about to replace all of it
+    // (e.g. reading the next record). If the data is shared with a copy, the
+    // record first gets a fresh buffer of its own (see BamRecordImpl COW).
+    static bam1_t* GetRawDataForOverwrite(BamRecord& r);
+
+    static bool IsRawDataShared(const BamRecord& r);
+
     static void UpdateRecordTags(const BamRecord& r);
     static void UpdateRecordTags(const BamRecordImpl& r);
 };
@@ -155,11 +163,32 @@ inline PBBAM_SHARED_PTR<bam1_t> BamRecordMemory::GetRawData(const BamRecordImpl&
 inline PBBAM_SHARED_PTR<bam1_t> BamRecordMemory::GetRawData(const BamRecordImpl* impl)
 { return impl->d_; }
 
+inline bam1_t* BamRecordMemory::GetRawDataForOverwrite(BamRecord& r)
+{
+    r.impl_.DetachDataForOverwrite();
+    return r.impl_.d_.get();
+}
+
+inline bool BamRecordMemory::IsRawDataShared(const BamRecord& r)
+{
+    if (r.impl_.d_.use_count() > 1)
+        return true;
+
+    // unshared data may be reused in place (see BamRecordImpl::DetachData())
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return false;
+}
+
 inline void BamRecordMemory::UpdateRecordTags(const BamRecord& r)
-{ UpdateRecordTags(r.impl_); }
+{
+    UpdateRecordTags(r.impl_);
+    r.recordTypeState_.Invalidate();
+    r.alignedPositionsState_.Invalidate();
+    r.alignmentStatsState_.Invalidate();
+}
 
 inline void BamRecordMemory::UpdateRecordTags(const BamRecordImpl& r)
-{ r.UpdateTagMap(); }
+{ r.InvalidateTagMap(); }
 
 } // namespace internal
 } // namespace BAM
@@ -0,0 +1,301 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file OrderedBamWriter.cpp
+/// \brief Implements the OrderedBamWriter class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/OrderedBamWriter.h"
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+class OrderedBamWriterPrivate
+{
+public:
+    OrderedBamWriterPrivate(const string& filename,
+                            const BamHeader& header,
+                            const size_t windowSize,
+                            const BamWriter::CompressionLevel compressionLevel,
+                            const size_t numThreads,
+                            const BamWriter::BinCalculationMode binCalculationMode,
+                            const BamWriter::IndexTypes indexTypes);
+
+public:
+    void Close(void);
+    void Write(const uint64_t sequenceNumber, vector<BamRecord>&& records);
+
+private:
+    void Run(void);
+    void Stop(void);
+
+private:
+    // slot for a single sequence number, in circular window
+    struct Slot
+    {
+        bool isFilled_;
+        vector<BamRecord> records_;
+
+        Slot(void) : isFilled_(false) { }
+    };
+
+    Slot& SlotFor(const uint64_t sequenceNumber)
+    { return window_.at(sequenceNumber % window_.size()); }
+
+private:
+    unique_ptr<BamWriter> writer_;
+
+    // guarded by mutex_
+    mutex mutex_;
+    condition_variable hasNext_;    // signals background thread
+    condition_variable hasSpace_;   // signals producers waiting on window
+    vector<Slot> window_;
+    uint64_t nextSequenceNumber_;   // oldest sequence number not yet taken
+    bool isClosing_;
+    bool isClosed_;
+    exception_ptr error_;
+
+    thread worker_;
+};
+
+OrderedBamWriterPrivate::OrderedBamWriterPrivate(const string& filename,
+                                                 const BamHeader& header,
+                                                 const size_t windowSize,
+                                                 const BamWriter::CompressionLevel compressionLevel,
+                                                 const size_t numThreads,
+                                                 const BamWriter::BinCalculationMode binCalculationMode,
+                                                 const BamWriter::IndexTypes indexTypes)
+    : writer_(new BamWriter(filename,
+                            header,
+                            compressionLevel,
+                            numThreads,
+                            binCalculationMode,
+                            indexTypes))
+    , window_(windowSize == 0 ? 1 : windowSize)
+    , nextSequenceNumber_(0)
+    , isClosing_(false)
+    , isClosed_(false)
+{
+    // start background thread only after file & header are ready, so that
+    // any errors there are thrown directly to the caller
+    worker_ = thread(&OrderedBamWriterPrivate::Run, this);
+}
+
+void OrderedBamWriterPrivate::Close(void)
+{
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (isClosed_)
+            return;
+        isClosed_ = true;
+    }
+    Stop();
+
+    // background thread stops at the first gap, anything left is unwritten
+    if (!error_) {
+        for (const Slot& slot : window_) {
+            if (slot.isFilled_) {
+                stringstream s;
+                s << "OrderedBamWriter: missing records for sequence number "
+                  << nextSequenceNumber_;
+                error_ = make_exception_ptr(std::runtime_error(s.str()));
+                break;
+            }
+        }
+    }
+
+    // If anything failed, destroy the writer while the error is 'live'. This
+    // way the incomplete file is not renamed to the requested filename & no
+    // index files are written.
+    if (error_) {
+        try {
+            rethrow_exception(error_);
+        } catch (...) {
+            writer_.reset();
+            throw;
+        }
+    }
+    writer_.reset();
+}
+
+void OrderedBamWriterPrivate::Run(void)
+{
+    vector<vector<BamRecord> > batch;
+    while (true) {
+
+        // take all consecutive, ready submissions at once
+        {
+            unique_lock<mutex> lock(mutex_);
+            hasNext_.wait(lock, [this]{ return SlotFor(nextSequenceNumber_).isFilled_ || isClosing_; });
+            while (SlotFor(nextSequenceNumber_).isFilled_) {
+                Slot& slot = SlotFor(nextSequenceNumber_);
+                batch.push_back(std::move(slot.records_));
+                slot.records_.clear();
+                slot.isFilled_ = false;
+                ++nextSequenceNumber_;
+            }
+            if (batch.empty())
+                return; // closing & nothing more can be written
+        }
+        hasSpace_.notify_all();
+
+        // write outside of lock
+        try {
+            for (const vector<BamRecord>& records : batch) {
+                for (const BamRecord& record : records)
+                    writer_->Write(record);
+            }
+            batch.clear();
+        } catch (...) {
+            lock_guard<mutex> lock(mutex_);
+            error_ = current_exception();
+            for (Slot& slot : window_) {
+                slot.records_.clear();
+                slot.isFilled_ = false;
+            }
+            hasSpace_.notify_all();
+            return;
+        }
+    }
+}
+
+void OrderedBamWriterPrivate::Stop(void)
+{
+    {
+        lock_guard<mutex> lock(mutex_);
+        isClosing_ = true;
+    }
+    hasNext_.notify_one();
+    hasSpace_.notify_all();
+    if (worker_.joinable())
+        worker_.join();
+}
+
+void OrderedBamWriterPrivate::Write(const uint64_t sequenceNumber,
+                                    vector<BamRecord>&& records)
+{
+    bool isNext = false;
+    {
+        unique_lock<mutex> lock(mutex_);
+        if (isClosed_)
+            throw std::runtime_error("OrderedBamWriter: cannot write after Close()");
+
+        // wait for window to reach this sequence number
+        const uint64_t windowSize = window_.size();
+        hasSpace_.wait(lock, [&]{
+            return sequenceNumber < nextSequenceNumber_ + windowSize || error_ || isClosing_;
+        });
+        if (error_)
+            rethrow_exception(error_);
+        if (isClosing_)
+            throw std::runtime_error("OrderedBamWriter: cannot write after Close()");
+
+        Slot& slot = SlotFor(sequenceNumber);
+        if (sequenceNumber < nextSequenceNumber_ || slot.isFilled_) {
+            stringstream s;
+            s << "OrderedBamWriter: sequence number " << sequenceNumber
+              << " was already submitted";
+            throw std::runtime_error(s.str());
+        }
+        slot.records_ = std::move(records);
+        slot.isFilled_ = true;
+        isNext = (sequenceNumber == nextSequenceNumber_);
+    }
+
+    // only the oldest missing sequence number unblocks the background thread
+    if (isNext)
+        hasNext_.notify_one();
+}
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+// ---------------------------------
+// OrderedBamWriter implementation
+// ---------------------------------
+
+OrderedBamWriter::OrderedBamWriter(const std::string& filename,
+                                   const BamHeader& header,
+                                   const size_t windowSize,
+                                   const BamWriter::CompressionLevel compressionLevel,
+                                   const size_t numThreads,
+                                   const BamWriter::BinCalculationMode binCalculationMode,
+                                   const BamWriter::IndexTypes indexTypes)
+    : d_(new internal::OrderedBamWriterPrivate(filename,
+                                               header,
+                                               windowSize,
+                                               compressionLevel,
+                                               numThreads,
+                                               binCalculationMode,
+                                               indexTypes))
+{ }
+
+OrderedBamWriter::~OrderedBamWriter(void)
+{
+    try {
+        d_->Close();
+    } catch (std::exception&) {
+        // swallow, destructor cannot throw. Call Close() to observe errors.
+    }
+}
+
+void OrderedBamWriter::Close(void)
+{ d_->Close(); }
+
+void OrderedBamWriter::Write(const uint64_t sequenceNumber, const BamRecord& record)
+{ d_->Write(sequenceNumber, vector<BamRecord>(1, record)); }
+
+void OrderedBamWriter::Write(const uint64_t sequenceNumber, BamRecord&& record)
+{
+    vector<BamRecord> records;
+    records.push_back(std::move(record));
+    d_->Write(sequenceNumber, std::move(records));
+}
+
+void OrderedBamWriter::Write(const uint64_t sequenceNumber, std::vector<BamRecord>&& records)
+{ d_->Write(sequenceNumber, std::move(records)); }
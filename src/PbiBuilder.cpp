@@ -69,6 +69,9 @@ public:
 public:
     bool AddRecord(const BamRecord& record,
                    const PbiReferenceEntry::Row rowNumber);
+    bool AddRow(const int32_t tId,
+                const int32_t pos,
+                const PbiReferenceEntry::Row rowNumber);
     PbiRawReferenceData Result(void) const;
 
 private:
@@ -96,10 +99,13 @@ PbiRawReferenceDataBuilder::PbiRawReferenceDataBuilder(const size_t numReference
 bool PbiRawReferenceDataBuilder::AddRecord(const BamRecord& record,
                                            const PbiReferenceEntry::Row rowNumber)
 {
-    // fetch ref ID & pos for record
-    const int32_t tId = record.ReferenceId();
-    const int32_t pos = record.ReferenceStart();
+    return AddRow(record.ReferenceId(), record.ReferenceStart(), rowNumber);
+}
 
+bool PbiRawReferenceDataBuilder::AddRow(const int32_t tId,
+                                        const int32_t pos,
+                                        const PbiReferenceEntry::Row rowNumber)
+{
     // sanity checks to protect against non-coordinate-sorted BAMs
     if (lastRefId_ != tId || (lastRefId_ >= 0 && tId < 0)) {
         if (tId >= 0) {
@@ -171,6 +177,9 @@ public:
 
 public:
     void AddRecord(const BamRecord& record, const int64_t vOffset);
+    void AddRow(const PbiRawData& index,
+                const uint32_t row,
+                const int64_t vOffset);
 
 public:
     bool HasBarcodeData(void) const;
@@ -284,9 +293,6 @@ PbiBuilderPrivate::~PbiBuilderPrivate(void)
 
 void PbiBuilderPrivate::AddRecord(const BamRecord& record, const int64_t vOffset)
 {
-    // ensure updated data
-    record.ResetCachedPositions();
-
     // store data
     rawData_.BarcodeData().AddRecord(record);
     rawData_.BasicData().AddRecord(record, vOffset);
@@ -304,6 +310,75 @@ void PbiBuilderPrivate::AddRecord(const BamRecord& record, const int64_t vOffset
     ++currentRow_;
 }
 
+void PbiBuilderPrivate::AddRow(const PbiRawData& index,
+                               const uint32_t row,
+                               const int64_t vOffset)
+{
+    // basic data
+    const PbiRawBasicData& srcBasic = index.BasicData();
+    PbiRawBasicData& basicData = rawData_.BasicData();
+    basicData.rgId_.push_back(srcBasic.rgId_.at(row));
+    basicData.qStart_.push_back(srcBasic.qStart_.at(row));
+    basicData.qEnd_.push_back(srcBasic.qEnd_.at(row));
+    basicData.holeNumber_.push_back(srcBasic.holeNumber_.at(row));
+    basicData.readQual_.push_back(srcBasic.readQual_.at(row));
+    basicData.ctxtFlag_.push_back(srcBasic.ctxtFlag_.at(row));
+    basicData.fileOffset_.push_back(vOffset);
+
+    // mapped data (index without MappedData only contains unmapped records)
+    PbiRawMappedData& mappedData = rawData_.MappedData();
+    int32_t tId  = -1;
+    uint32_t pos = static_cast<uint32_t>(-1);
+    if (index.HasMappedData()) {
+        const PbiRawMappedData& srcMapped = index.MappedData();
+        tId = srcMapped.tId_.at(row);
+        pos = srcMapped.tStart_.at(row);
+        mappedData.tId_.push_back(tId);
+        mappedData.tStart_.push_back(pos);
+        mappedData.tEnd_.push_back(srcMapped.tEnd_.at(row));
+        mappedData.aStart_.push_back(srcMapped.aStart_.at(row));
+        mappedData.aEnd_.push_back(srcMapped.aEnd_.at(row));
+        mappedData.revStrand_.push_back(srcMapped.revStrand_.at(row));
+        mappedData.nM_.push_back(srcMapped.nM_.at(row));
+        mappedData.nMM_.push_back(srcMapped.nMM_.at(row));
+        mappedData.mapQV_.push_back(srcMapped.mapQV_.at(row));
+    } else {
+        mappedData.tId_.push_back(tId);
+        mappedData.tStart_.push_back(pos);
+        mappedData.tEnd_.push_back(pos);
+        mappedData.aStart_.push_back(pos);
+        mappedData.aEnd_.push_back(pos);
+        mappedData.revStrand_.push_back(0);
+        mappedData.nM_.push_back(0);
+        mappedData.nMM_.push_back(0);
+        mappedData.mapQV_.push_back(255);
+    }
+
+    // barcode data (index without BarcodeData only contains missing values)
+    PbiRawBarcodeData& barcodeData = rawData_.BarcodeData();
+    if (index.HasBarcodeData()) {
+        const PbiRawBarcodeData& srcBarcode = index.BarcodeData();
+        barcodeData.bcForward_.push_back(srcBarcode.bcForward_.at(row));
+        barcodeData.bcReverse_.push_back(srcBarcode.bcReverse_.at(row));
+        barcodeData.bcQual_.push_back(srcBarcode.bcQual_.at(row));
+    } else {
+        barcodeData.bcForward_.push_back(-1);
+        barcodeData.bcReverse_.push_back(-1);
+        barcodeData.bcQual_.push_back(-1);
+    }
+
+    if (refDataBuilder_) {
+
+        // stop storing coordinate-sorted reference data if we encounter out-of-order record
+        const bool sorted = refDataBuilder_->AddRow(tId, static_cast<int32_t>(pos), currentRow_);
+        if (!sorted)
+            refDataBuilder_.reset();
+    }
+
+    // increment row counter
+    ++currentRow_;
+}
+
 bool PbiBuilderPrivate::HasBarcodeData(void) const
 {
     // fetch data components
@@ -396,9 +471,13 @@ PbiBuilder::PbiBuilder(const string& pbiFilename,
 PbiBuilder::~PbiBuilder(void) { }
 
 void PbiBuilder::AddRecord(const BamRecord& record, const int64_t vOffset)
+{ d_->AddRecord(record, vOffset); }
+
+void PbiBuilder::AddRow(const PbiRawData& index,
+                        const uint32_t row,
+                        const int64_t vOffset)
 {
-    internal::BamRecordMemory::UpdateRecordTags(record);
-    d_->AddRecord(record, vOffset);
+    d_->AddRow(index, row, vOffset);
 }
 
 const PbiRawData& PbiBuilder::Index(void) const
@@ -0,0 +1,268 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file PerBaseColumns.cpp
+/// \brief Implements the PerBaseColumns class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/PerBaseColumns.h"
+#include "pbbam/Frames.h"
+#include "pbbam/QualityValues.h"
+#include "pbbam/TagView.h"
+#include "BamRecordTags.h"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+static
+bool IsFrameField(const PerBaseField field)
+{ return field == PerBaseField::IPD || field == PerBaseField::PULSE_WIDTH; }
+
+static
+TagId FieldTagId(const PerBaseField field)
+{
+    switch (field) {
+        case PerBaseField::IPD             : return internal::tagName_ipd;
+        case PerBaseField::PULSE_WIDTH     : return internal::tagName_pulseWidth;
+        case PerBaseField::DELETION_QV     : return internal::tagName_deletionQV;
+        case PerBaseField::INSERTION_QV    : return internal::tagName_insertionQV;
+        case PerBaseField::MERGE_QV        : return internal::tagName_mergeQV;
+        case PerBaseField::SUBSTITUTION_QV : return internal::tagName_substitutionQV;
+        default:
+            throw std::runtime_error("PerBaseColumns: unknown per-base field");
+    }
+}
+
+// View over a record's raw data for field (null if missing). Frame tags may be
+// lossy (uint8 codes) or lossless (uint16), QV tags are FASTQ strings, and
+// QUAL is numeric.
+static
+TagView FieldView(const BamRecord& record, const PerBaseField field)
+{
+    const BamRecordImpl& impl = record.Impl();
+    if (field == PerBaseField::QUALITIES)
+        return impl.QualitiesView();
+
+    const TagView view = impl.TagValueView(FieldTagId(field));
+    if (view.IsNull())
+        return view;
+
+    const TagDataType type = view.Type();
+    const bool isValid = IsFrameField(field) ? (type == TagDataType::UINT8_ARRAY ||
+                                                type == TagDataType::UINT16_ARRAY)
+                                             : (type == TagDataType::STRING);
+    if (!isValid)
+        throw std::runtime_error("PerBaseColumns: unexpected data type for tag: " +
+                                 FieldTagId(field).ToString());
+    return view;
+}
+
+// Calls func(begin, end) over contiguous slices of [0, n), on up to numThreads
+// threads (the caller's included). Small inputs are not worth a thread.
+// Exceptions are rethrown here, after all threads have finished.
+template<typename Func>
+static
+void RunInParallel(const size_t n, const size_t numThreads, const Func& func)
+{
+    static const size_t minPerThread = 256;
+    const size_t numUsed = std::max<size_t>(1, std::min(numThreads, n / minPerThread));
+    if (numUsed == 1) {
+        func(0, n);
+        return;
+    }
+
+    const size_t chunkSize = (n + numUsed - 1) / numUsed;
+    vector<exception_ptr> errors(numUsed);
+    auto runChunk = [&](const size_t i) {
+        try {
+            const size_t begin = std::min(n, i * chunkSize);
+            const size_t end   = std::min(n, begin + chunkSize);
+            func(begin, end);
+        } catch (...) {
+            errors[i] = current_exception();
+        }
+    };
+
+    vector<thread> threads;
+    threads.reserve(numUsed - 1);
+    for (size_t i = 1; i < numUsed; ++i)
+        threads.emplace_back(runChunk, i);
+    runChunk(0);
+    for (thread& t : threads)
+        t.join();
+
+    for (const exception_ptr& e : errors) {
+        if (e)
+            rethrow_exception(e);
+    }
+}
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+PerBaseColumns::PerBaseColumns(const std::vector<PerBaseField>& fields,
+                               const Orientation orientation,
+                               const size_t numThreads)
+    : fields_(fields)
+    , orientation_(orientation)
+    , numThreads_(numThreads)
+{
+    if (fields_.empty())
+        throw std::runtime_error("PerBaseColumns: no per-base fields requested");
+
+    if (numThreads_ == 0)
+        numThreads_ = std::max(1u, thread::hardware_concurrency());
+
+    columns_.reserve(fields_.size());
+    for (const PerBaseField field : fields_) {
+        if (HasField(field))
+            throw std::runtime_error("PerBaseColumns: per-base field requested more than once");
+        Column column;
+        column.field = field;
+        column.isFrames = internal::IsFrameField(field);
+        column.offsets.push_back(0);
+        columns_.push_back(std::move(column));
+    }
+}
+
+void PerBaseColumns::Append(const BamRecord* records, const size_t numRecords)
+{
+    if (numRecords == 0)
+        return;
+    const size_t numColumns = columns_.size();
+
+    // size each record's fields (validating their types before anything is
+    // modified)
+    lengths_.resize(numRecords * numColumns);
+    internal::RunInParallel(numRecords, numThreads_, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t c = 0; c < numColumns; ++c) {
+                const TagView view = internal::FieldView(records[i], columns_[c].field);
+                lengths_[i*numColumns + c] = view.Size();
+            }
+        }
+    });
+
+    // extend offsets & value storage
+    const size_t firstRecord = NumRecords();
+    for (size_t c = 0; c < numColumns; ++c) {
+        Column& column = columns_[c];
+        size_t total = column.offsets.back();
+        for (size_t i = 0; i < numRecords; ++i) {
+            total += lengths_[i*numColumns + c];
+            column.offsets.push_back(total);
+        }
+        if (column.isFrames)
+            column.frames.resize(total);
+        else
+            column.quals.resize(total);
+    }
+
+    // fill each record's slice of the columns in place
+    internal::RunInParallel(numRecords, numThreads_, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const BamRecord& record = records[i];
+            const bool isReverseStrand = record.Impl().IsReverseStrand();
+            for (size_t c = 0; c < numColumns; ++c) {
+                const size_t length = lengths_[i*numColumns + c];
+                if (length == 0)
+                    continue;
+
+                // tags are stored in native orientation, QUAL in genomic
+                Column& column = columns_[c];
+                const Orientation stored = (column.field == PerBaseField::QUALITIES ? Orientation::GENOMIC
+                                                                                    : Orientation::NATIVE);
+                const bool reverse = (isReverseStrand && orientation_ != stored);
+                const size_t start = column.offsets[firstRecord + i];
+                const TagView view = internal::FieldView(record, column.field);
+                if (column.isFrames) {
+                    uint16_t* frames = column.frames.data() + start;
+                    if (view.Type() == TagDataType::UINT8_ARRAY)
+                        Frames::Decode(view.RawData(), length, frames);
+                    else
+                        view.CopyTo(frames);
+                    if (reverse)
+                        std::reverse(frames, frames + length);
+                } else {
+                    uint8_t* quals = column.quals.data() + start;
+                    if (view.Type() == TagDataType::STRING)
+                        QualityValues::FromFastq(view.Chars(), length, quals);
+                    else
+                        QualityValues::FromRawData(view.RawData(), length, quals);
+                    if (reverse)
+                        std::reverse(quals, quals + length);
+                }
+            }
+        }
+    });
+}
+
+void PerBaseColumns::Clear(void)
+{
+    for (Column& column : columns_) {
+        column.offsets.assign(1, 0);
+        column.frames.clear();
+        column.quals.clear();
+    }
+}
+
+const PerBaseColumns::Column& PerBaseColumns::ColumnFor(const PerBaseField field) const
+{
+    for (const Column& column : columns_) {
+        if (column.field == field)
+            return column;
+    }
+    throw std::runtime_error("PerBaseColumns: requested field was not extracted");
+}
+
+bool PerBaseColumns::HasField(const PerBaseField field) const
+{
+    for (const Column& column : columns_) {
+        if (column.field == field)
+            return true;
+    }
+    return false;
+}
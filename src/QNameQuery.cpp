@@ -40,9 +40,10 @@
 // Author: Derek Barnett
 
 #include "pbbam/QNameQuery.h"
+#include "pbbam/BamRecordPool.h"
 #include "pbbam/CompositeBamReader.h"
-#include <boost/optional.hpp>
-#include <cassert>
+#include "MemoryUtils.h"
+#include <htslib/sam.h>
 using namespace PacBio;
 using namespace PacBio::BAM;
 using namespace PacBio::BAM::internal;
@@ -53,44 +54,43 @@ struct QNameQuery::QNameQueryPrivate
 public:
     QNameQueryPrivate(const DataSet& dataset)
         : reader_(new SequentialCompositeBamReader(dataset))
-        , nextRecord_(boost::none)
+        , hasNextRecord_(false)
     { }
 
     bool GetNext(vector<BamRecord>& records)
     {
-        records.clear();
+        // recycle the previous group's records
+        pool_.Release(records);
 
-        string groupRecordName;
-
-        if (nextRecord_.is_initialized()) {
-            BamRecord r = nextRecord_.get();
-            groupRecordName = r.FullName();
-            records.push_back(std::move(r));
-            nextRecord_ = boost::none;
+        if (hasNextRecord_) {
+            groupRecordName_ = bam_get_qname(BamRecordMemory::GetRawData(nextRecord_));
+            records.push_back(std::move(nextRecord_));
+            hasNextRecord_ = false;
         }
 
-        BamRecord record;
+        BamRecord record = pool_.Acquire();
         while (reader_->GetNext(record)) {
-            if (records.empty()) {
-                groupRecordName = record.FullName();
-                records.push_back(record);
-            }
-            else {
-                assert(!records.empty());
-                if (record.FullName() == groupRecordName)
-                    records.push_back(record);
-                else {
-                    nextRecord_ = record;
-                    return true;
-                }
+            const char* name = bam_get_qname(BamRecordMemory::GetRawData(record));
+            if (records.empty())
+                groupRecordName_ = name;
+            else if (groupRecordName_ != name) {
+                nextRecord_ = std::move(record);
+                hasNextRecord_ = true;
+                return true;
             }
+            records.push_back(std::move(record));
+            record = pool_.Acquire();
         }
+        pool_.Release(std::move(record));
         return !records.empty();
     }
 
 public:
     unique_ptr<SequentialCompositeBamReader> reader_;
-    boost::optional<BamRecord> nextRecord_;
+    BamRecordPool pool_;
+    BamRecord nextRecord_;
+    bool hasNextRecord_;
+    string groupRecordName_;
 };
 
 QNameQuery::QNameQuery(const DataSet& dataset)
@@ -0,0 +1,191 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file QualityValues.cpp
+/// \brief Implements the QualityValues class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/QualityValues.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// All conversions work on the raw bytes - QualityValue is a single uint8_t.
+// The SSE2 paths (16 values per iteration) are always available on x86-64;
+// other platforms use the scalar loops.
+
+// quals[i] = min(src[i] - offset, QualityValue::MAX), with uint8_t wraparound
+// (so FASTQ chars below '!' clamp to MAX, as with QualityValue::FromFastq)
+static
+void ClampedCopy(const uint8_t* src,
+                 const size_t length,
+                 const uint8_t offset,
+                 uint8_t* quals)
+{
+    const uint8_t maxQv = QualityValue::MAX;
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i vOffset = _mm_set1_epi8(static_cast<char>(offset));
+    const __m128i vMax = _mm_set1_epi8(static_cast<char>(maxQv));
+    for ( ; i + 16 <= length; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(quals + i),
+                         _mm_min_epu8(_mm_sub_epi8(v, vOffset), vMax));
+    }
+#endif
+    for ( ; i < length; ++i)
+        quals[i] = std::min(static_cast<uint8_t>(src[i] - offset), maxQv);
+}
+
+static
+void QualsToFastq(const uint8_t* quals, const size_t length, char* fastq)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i vOffset = _mm_set1_epi8(33);
+    for ( ; i + 16 <= length; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(quals + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(fastq + i), _mm_add_epi8(v, vOffset));
+    }
+#endif
+    for ( ; i < length; ++i)
+        fastq[i] = static_cast<char>(quals[i] + 33);
+}
+
+#if defined(__SSE2__)
+static inline
+__m128i ReversedBytes(__m128i v)
+{
+    v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_or_si128(_mm_srli_epi16(v, 8), _mm_slli_epi16(v, 8));
+}
+#endif
+
+static
+void ReverseQuals(uint8_t* quals, const size_t length)
+{
+    uint8_t* front = quals;
+    uint8_t* back  = quals + length;
+#if defined(__SSE2__)
+    // swap 16-byte blocks from either end, until they would overlap
+    while (back - front >= 32) {
+        __m128i* frontBlock = reinterpret_cast<__m128i*>(front);
+        __m128i* backBlock  = reinterpret_cast<__m128i*>(back - 16);
+        const __m128i f = _mm_loadu_si128(frontBlock);
+        const __m128i b = _mm_loadu_si128(backBlock);
+        _mm_storeu_si128(frontBlock, ReversedBytes(b));
+        _mm_storeu_si128(backBlock,  ReversedBytes(f));
+        front += 16;
+        back  -= 16;
+    }
+#endif
+    std::reverse(front, back);
+}
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+QualityValues::QualityValues(const uint8_t* quals, const size_t length)
+    : std::vector<QualityValue>(length)
+{
+    internal::ClampedCopy(quals, length, 0, RawData());
+}
+
+QualityValues QualityValues::FromFastq(const char* fastq, const size_t length)
+{
+    QualityValues result;
+    result.resize(length);
+    internal::ClampedCopy(reinterpret_cast<const uint8_t*>(fastq), length, 33, result.RawData());
+    return result;
+}
+
+void QualityValues::FromFastq(const char* fastq,
+                              const size_t length,
+                              QualityValues* quals)
+{
+    assert(quals);
+    quals->resize(length);
+    internal::ClampedCopy(reinterpret_cast<const uint8_t*>(fastq), length, 33, quals->RawData());
+}
+
+void QualityValues::FromRawData(const uint8_t* rawQuals,
+                                const size_t length,
+                                QualityValues* quals)
+{
+    assert(quals);
+    quals->resize(length);
+    internal::ClampedCopy(rawQuals, length, 0, quals->RawData());
+}
+
+void QualityValues::FromFastq(const char* fastq,
+                              const size_t length,
+                              uint8_t* quals)
+{
+    assert(quals);
+    internal::ClampedCopy(reinterpret_cast<const uint8_t*>(fastq), length, 33, quals);
+}
+
+void QualityValues::FromRawData(const uint8_t* rawQuals,
+                                const size_t length,
+                                uint8_t* quals)
+{
+    assert(quals);
+    internal::ClampedCopy(rawQuals, length, 0, quals);
+}
+
+std::string QualityValues::Fastq(void) const
+{
+    std::string result(size(), '\0');
+    internal::QualsToFastq(RawData(), size(), &result[0]);
+    return result;
+}
+
+void QualityValues::Reverse(void)
+{ internal::ReverseQuals(RawData(), size()); }
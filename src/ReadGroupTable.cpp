@@ -0,0 +1,171 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file ReadGroupTable.cpp
+/// \brief Implements the ReadGroupTable class.
+//
+// Author: Derek Barnett
+
+#include "ReadGroupTable.h"
+#include <algorithm>
+#include <cstring>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace PacBio::BAM::internal;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// record type names
+static const string recordTypeName_ZMW        = "ZMW";
+static const string recordTypeName_Polymerase = "POLYMERASE";
+static const string recordTypeName_HqRegion   = "HQREGION";
+static const string recordTypeName_Subread    = "SUBREAD";
+static const string recordTypeName_CCS        = "CCS";
+static const string recordTypeName_Scrap      = "SCRAP";
+
+static
+RecordType NameToType(const string& name)
+{
+    if (name == recordTypeName_Subread)
+        return RecordType::SUBREAD;
+    if (name == recordTypeName_ZMW || name == recordTypeName_Polymerase)
+        return RecordType::ZMW;
+    if (name == recordTypeName_HqRegion)
+        return RecordType::HQREGION;
+    if (name == recordTypeName_CCS)
+        return RecordType::CCS;
+    if (name == recordTypeName_Scrap)
+        return RecordType::SCRAP;
+    return RecordType::UNKNOWN;
+}
+
+// Parses a (PacBio-style) hexadecimal read group ID, without allocating.
+// Returns false if the ID is empty, too long, or not plain hex digits.
+static
+bool ParseHexId(const char* id, const size_t length, int32_t* result)
+{
+    if (length == 0 || length > 8)
+        return false;
+
+    uint32_t value = 0;
+    for (size_t i = 0; i < length; ++i) {
+        const char c = id[i];
+        uint32_t digit;
+        if      (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else
+            return false;
+        value = (value << 4) | digit;
+    }
+    *result = static_cast<int32_t>(value);
+    return true;
+}
+
+static inline
+bool IdEquals(const ReadGroupTableEntry& entry, const char* id, const size_t length)
+{
+    return entry.id_.size() == length
+            && memcmp(entry.id_.data(), id, length) == 0;
+}
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+ReadGroupTable::ReadGroupTable(const map<string, ReadGroupInfo>& readGroups)
+    : numNumericIds_(0)
+{
+    entries_.reserve(readGroups.size());
+    for (const auto& rg : readGroups) {
+        ReadGroupTableEntry entry;
+        entry.readGroup_ = rg.second;
+        entry.id_ = rg.first;
+        entry.movieName_ = rg.second.MovieName();
+        entry.type_ = NameToType(rg.second.ReadType());
+        entry.numericId_ = 0;
+        entry.hasNumericId_ = ParseHexId(entry.id_.data(),
+                                         entry.id_.size(),
+                                         &entry.numericId_);
+        if (entry.hasNumericId_)
+            ++numNumericIds_;
+        entries_.push_back(std::move(entry));
+    }
+
+    // numeric IDs first (sorted), then any others
+    std::stable_sort(entries_.begin(), entries_.end(),
+                     [](const ReadGroupTableEntry& lhs, const ReadGroupTableEntry& rhs)
+    {
+        if (lhs.hasNumericId_ != rhs.hasNumericId_)
+            return lhs.hasNumericId_;
+        return lhs.hasNumericId_ && lhs.numericId_ < rhs.numericId_;
+    });
+}
+
+const ReadGroupTableEntry* ReadGroupTable::Find(const char* id,
+                                                const size_t length) const
+{
+    int32_t numericId;
+    if (ParseHexId(id, length, &numericId)) {
+        const auto numericEnd = entries_.cbegin() + numNumericIds_;
+        auto iter = std::lower_bound(entries_.cbegin(), numericEnd, numericId,
+                                     [](const ReadGroupTableEntry& entry, const int32_t value)
+        {
+            return entry.numericId_ < value;
+        });
+
+        // (IDs differing only in case or leading zeros share a numeric ID)
+        for ( ; iter != numericEnd && iter->numericId_ == numericId; ++iter) {
+            if (IdEquals(*iter, id, length))
+                return &(*iter);
+        }
+        return nullptr;
+    }
+
+    // non-hex IDs
+    const auto end = entries_.cend();
+    for (auto iter = entries_.cbegin() + numNumericIds_; iter != end; ++iter) {
+        if (IdEquals(*iter, id, length))
+            return &(*iter);
+    }
+    return nullptr;
+}
+
+const ReadGroupTableEntry* ReadGroupTable::Find(const string& id) const
+{ return Find(id.data(), id.size()); }
@@ -0,0 +1,98 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file ReadGroupTable.h
+/// \brief Defines the ReadGroupTable class.
+//
+// Author: Derek Barnett
+
+#ifndef READGROUPTABLE_H
+#define READGROUPTABLE_H
+
+#include "pbbam/BamRecord.h"
+#include "pbbam/ReadGroupInfo.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// Pre-parsed read group data, for per-record lookups (e.g. BamRecord::Type)
+// that should not copy or re-parse ReadGroupInfo.
+//
+class ReadGroupTableEntry
+{
+public:
+    ReadGroupInfo readGroup_;
+    std::string id_;
+    std::string movieName_;
+    RecordType type_;
+    int32_t numericId_;
+    bool hasNumericId_;
+};
+
+// The ReadGroupTable class is an immutable snapshot of a BamHeader's read
+// groups. It is built once (lazily) per header, and rebuilt only if the
+// header's read groups are modified.
+//
+// Entries are sorted by numeric ID (see ReadGroupInfo::IdToInt), so record
+// lookups need neither a string allocation nor a string-keyed map. Entries
+// are matched on their exact ID string, just like BamHeader::ReadGroup.
+//
+class ReadGroupTable
+{
+public:
+    explicit ReadGroupTable(const std::map<std::string, ReadGroupInfo>& readGroups);
+
+public:
+    // returns nullptr if not found
+    const ReadGroupTableEntry* Find(const char* id, const size_t length) const;
+    const ReadGroupTableEntry* Find(const std::string& id) const;
+
+private:
+    std::vector<ReadGroupTableEntry> entries_; // numeric IDs first, sorted
+    size_t numNumericIds_;
+};
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+#endif // READGROUPTABLE_H
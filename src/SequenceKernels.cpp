@@ -0,0 +1,359 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file SequenceKernels.cpp
+/// \brief Implements low-level sequence packing & reverse-complement kernels.
+//
+// Author: Derek Barnett
+
+#include "SequenceKernels.h"
+#include "SequenceUtils.h"
+#include <htslib/sam.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PBBAM_HAVE_SSSE3_KERNELS
+#include <tmmintrin.h>
+#endif
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// ------------------------
+// lookup tables
+// ------------------------
+
+struct SequenceTables
+{
+    uint8_t encode[256];
+    char complement[256];
+    char complementCaseSens[256];
+
+    SequenceTables(void)
+    {
+        // case-sensitive complement: A,C,G,T,U (either case), 'N', ' ', '-'
+        // all else maps to 4, as in the original ReverseComplementCaseSens table
+        for (int i = 0; i < 256; ++i) {
+            encode[i] = seq_nt16_table[i];
+            complement[i] = Complement(static_cast<char>(i));
+            complementCaseSens[i] = 4;
+        }
+        const char* from = "ACGTUacgtuN -";
+        const char* to   = "TGCAAtgcaaN -";
+        for ( ; *from; ++from, ++to)
+            complementCaseSens[static_cast<uint8_t>(*from)] = *to;
+    }
+};
+
+static inline
+const SequenceTables& Tables(void)
+{
+    static const SequenceTables tables;
+    return tables;
+}
+
+// ------------------------
+// scalar kernels
+// ------------------------
+
+static
+void DecodeSequence_Scalar(const uint8_t* encoded, const size_t length, char* out)
+{
+    const size_t numPairs = length / 2;
+    for (size_t i = 0; i < numPairs; ++i) {
+        const uint8_t b = encoded[i];
+        out[2*i]   = seq_nt16_str[b >> 4];
+        out[2*i+1] = seq_nt16_str[b & 0x0f];
+    }
+    if (length & 1)
+        out[length-1] = seq_nt16_str[encoded[numPairs] >> 4];
+}
+
+static
+void EncodeSequence_Scalar(const char* sequence,
+                           const size_t length,
+                           uint8_t* out,
+                           const uint8_t* table)
+{
+    const size_t numPairs = length / 2;
+    for (size_t i = 0; i < numPairs; ++i) {
+        out[i] = static_cast<uint8_t>((table[static_cast<uint8_t>(sequence[2*i])] << 4) |
+                                       table[static_cast<uint8_t>(sequence[2*i+1])]);
+    }
+    if (length & 1)
+        out[numPairs] = static_cast<uint8_t>(table[static_cast<uint8_t>(sequence[length-1])] << 4);
+}
+
+// Swaps & complements 'count' characters from each end: front[i] <-> back[-1-i].
+static inline
+void ReverseComplementEnds_Scalar(char* front,
+                                  char* back,
+                                  const size_t count,
+                                  const char* table)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const char f = front[i];
+        front[i] = table[static_cast<uint8_t>(back[-1-static_cast<ptrdiff_t>(i)])];
+        back[-1-static_cast<ptrdiff_t>(i)] = table[static_cast<uint8_t>(f)];
+    }
+}
+
+static
+void ReverseComplement_Scalar(char* sequence, const size_t length, const char* table)
+{
+    ReverseComplementEnds_Scalar(sequence, sequence + length, length / 2, table);
+    if (length & 1)
+        sequence[length/2] = table[static_cast<uint8_t>(sequence[length/2])];
+}
+
+// ------------------------
+// SSSE3 kernels
+// ------------------------
+
+#ifdef PBBAM_HAVE_SSSE3_KERNELS
+
+#define PBBAM_SSSE3 __attribute__((target("ssse3")))
+
+// True if all 16 bytes are in [0x40,0x80) - the range covered by Lookup64_SSSE3.
+// That covers all letters; blocks with anything else use the scalar kernels.
+PBBAM_SSSE3 static inline
+bool InLookupRange_SSSE3(const __m128i c)
+{
+    const __m128i bits = _mm_and_si128(c, _mm_set1_epi8(static_cast<char>(0xC0)));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(bits, _mm_set1_epi8(0x40))) == 0xFFFF;
+}
+
+// Table lookup for bytes in [0x40,0x80), as 4 rows of 16 entries. Each row is
+// shuffled with its index offset so that out-of-row lanes saturate to >= 0x80,
+// which pshufb maps to zero.
+struct Lookup64_SSSE3
+{
+    __m128i rows[4];
+
+    PBBAM_SSSE3 explicit Lookup64_SSSE3(const void* table)
+    {
+        const uint8_t* t = static_cast<const uint8_t*>(table) + 0x40;
+        for (int i = 0; i < 4; ++i)
+            rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t + 16*i));
+    }
+
+    PBBAM_SSSE3 __m128i operator()(const __m128i c) const
+    {
+        const __m128i bias = _mm_set1_epi8(0x70);
+        const __m128i sixteen = _mm_set1_epi8(16);
+        __m128i x = _mm_sub_epi8(c, _mm_set1_epi8(0x40));
+        __m128i result = _mm_shuffle_epi8(rows[0], _mm_adds_epu8(x, bias));
+        x = _mm_sub_epi8(x, sixteen);
+        result = _mm_or_si128(result, _mm_shuffle_epi8(rows[1], _mm_adds_epu8(x, bias)));
+        x = _mm_sub_epi8(x, sixteen);
+        result = _mm_or_si128(result, _mm_shuffle_epi8(rows[2], _mm_adds_epu8(x, bias)));
+        x = _mm_sub_epi8(x, sixteen);
+        result = _mm_or_si128(result, _mm_shuffle_epi8(rows[3], _mm_adds_epu8(x, bias)));
+        return result;
+    }
+};
+
+PBBAM_SSSE3 static
+void DecodeSequence_SSSE3(const uint8_t* encoded, const size_t length, char* out)
+{
+    const __m128i lut = _mm_loadu_si128(reinterpret_cast<const __m128i*>(seq_nt16_str));
+    const __m128i lowNibbles = _mm_set1_epi8(0x0f);
+
+    // 16 bytes -> 32 bases per iteration
+    const size_t numPairs = length / 2;
+    size_t i = 0;
+    for ( ; i + 16 <= numPairs; i += 16) {
+        const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(encoded + i));
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), lowNibbles);
+        const __m128i lo = _mm_and_si128(packed, lowNibbles);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2*i),
+                         _mm_shuffle_epi8(lut, _mm_unpacklo_epi8(hi, lo)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2*i + 16),
+                         _mm_shuffle_epi8(lut, _mm_unpackhi_epi8(hi, lo)));
+    }
+    DecodeSequence_Scalar(encoded + i, length - 2*i, out + 2*i);
+}
+
+PBBAM_SSSE3 static
+void EncodeSequence_SSSE3(const char* sequence, const size_t length, uint8_t* out)
+{
+    const uint8_t* table = Tables().encode;
+    const Lookup64_SSSE3 lookup(table);
+    const __m128i weights = _mm_set1_epi16(0x0110); // (16 * first) + second
+
+    // 16 bases -> 8 bytes per iteration
+    size_t i = 0;
+    for ( ; i + 16 <= length; i += 16) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sequence + i));
+        if (!InLookupRange_SSSE3(c)) {
+            EncodeSequence_Scalar(sequence + i, 16, out + i/2, table);
+            continue;
+        }
+        const __m128i codes = lookup(c);
+        const __m128i pairs = _mm_maddubs_epi16(codes, weights);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i/2), _mm_packus_epi16(pairs, pairs));
+    }
+    EncodeSequence_Scalar(sequence + i, length - i, out + i/2, table);
+}
+
+PBBAM_SSSE3 static
+void ReverseComplement_SSSE3(char* sequence, const size_t length, const char* table)
+{
+    const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                           7,  6,  5,  4,  3,  2, 1, 0);
+    const Lookup64_SSSE3 lookup(table);
+
+    // swap 16-byte blocks from either end, until they would overlap
+    char* front = sequence;
+    char* back  = sequence + length;
+    while (back - front >= 32) {
+        __m128i* frontBlock = reinterpret_cast<__m128i*>(front);
+        __m128i* backBlock  = reinterpret_cast<__m128i*>(back - 16);
+        const __m128i f = _mm_loadu_si128(frontBlock);
+        const __m128i b = _mm_loadu_si128(backBlock);
+        if (InLookupRange_SSSE3(f) && InLookupRange_SSSE3(b)) {
+            _mm_storeu_si128(frontBlock, _mm_shuffle_epi8(lookup(b), reverse));
+            _mm_storeu_si128(backBlock,  _mm_shuffle_epi8(lookup(f), reverse));
+        } else
+            ReverseComplementEnds_Scalar(front, back, 16, table);
+        front += 16;
+        back  -= 16;
+    }
+    ReverseComplement_Scalar(front, back - front, table);
+}
+
+#undef PBBAM_SSSE3
+
+#endif // PBBAM_HAVE_SSSE3_KERNELS
+
+// ------------------------
+// dispatch
+// ------------------------
+
+static
+SequenceKernelLevel DetectSequenceKernelLevel(void)
+{
+#ifdef PBBAM_HAVE_SSSE3_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3"))
+        return SequenceKernelLevel::SSSE3;
+#endif
+    return SequenceKernelLevel::SCALAR;
+}
+
+SequenceKernelLevel BestSequenceKernelLevel(void)
+{
+    static const SequenceKernelLevel level = DetectSequenceKernelLevel();
+    return level;
+}
+
+static inline
+bool UseSSSE3(const SequenceKernelLevel level)
+{
+#ifdef PBBAM_HAVE_SSSE3_KERNELS
+    return level == SequenceKernelLevel::SSSE3 &&
+           BestSequenceKernelLevel() == SequenceKernelLevel::SSSE3;
+#else
+    (void)level;
+    return false;
+#endif
+}
+
+void DecodeSequence(const uint8_t* encoded, const size_t length, char* out)
+{ DecodeSequence(encoded, length, out, BestSequenceKernelLevel()); }
+
+void DecodeSequence(const uint8_t* encoded,
+                    const size_t length,
+                    char* out,
+                    const SequenceKernelLevel level)
+{
+#ifdef PBBAM_HAVE_SSSE3_KERNELS
+    if (UseSSSE3(level))
+        return DecodeSequence_SSSE3(encoded, length, out);
+#endif
+    (void)level;
+    DecodeSequence_Scalar(encoded, length, out);
+}
+
+void EncodeSequence(const char* sequence, const size_t length, uint8_t* out)
+{ EncodeSequence(sequence, length, out, BestSequenceKernelLevel()); }
+
+void EncodeSequence(const char* sequence,
+                    const size_t length,
+                    uint8_t* out,
+                    const SequenceKernelLevel level)
+{
+#ifdef PBBAM_HAVE_SSSE3_KERNELS
+    if (UseSSSE3(level))
+        return EncodeSequence_SSSE3(sequence, length, out);
+#endif
+    (void)level;
+    EncodeSequence_Scalar(sequence, length, out, Tables().encode);
+}
+
+void ReverseComplement(char* sequence, const size_t length)
+{ ReverseComplement(sequence, length, BestSequenceKernelLevel()); }
+
+void ReverseComplement(char* sequence,
+                       const size_t length,
+                       const SequenceKernelLevel level)
+{
+#ifdef PBBAM_HAVE_SSSE3_KERNELS
+    if (UseSSSE3(level))
+        return ReverseComplement_SSSE3(sequence, length, Tables().complement);
+#endif
+    (void)level;
+    ReverseComplement_Scalar(sequence, length, Tables().complement);
+}
+
+void ReverseComplementCaseSens(char* sequence, const size_t length)
+{ ReverseComplementCaseSens(sequence, length, BestSequenceKernelLevel()); }
+
+void ReverseComplementCaseSens(char* sequence,
+                               const size_t length,
+                               const SequenceKernelLevel level)
+{
+#ifdef PBBAM_HAVE_SSSE3_KERNELS
+    if (UseSSSE3(level))
+        return ReverseComplement_SSSE3(sequence, length, Tables().complementCaseSens);
+#endif
+    (void)level;
+    ReverseComplement_Scalar(sequence, length, Tables().complementCaseSens);
+}
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
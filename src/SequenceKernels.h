@@ -0,0 +1,102 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file SequenceKernels.h
+/// \brief Defines low-level sequence packing & reverse-complement kernels.
+//
+// Author: Derek Barnett
+
+#ifndef SEQUENCEKERNELS_H
+#define SEQUENCEKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// Instruction set used by the kernels below. The overloads without an explicit
+// level dispatch to BestSequenceKernelLevel(), which is determined once from
+// the running CPU. Explicit levels are available for testing/benchmarking; a
+// level not supported by the CPU (or build) silently falls back to SCALAR.
+//
+enum class SequenceKernelLevel
+{
+    SCALAR
+  , SSSE3
+};
+
+SequenceKernelLevel BestSequenceKernelLevel(void);
+
+// Unpacks 'length' 4-bit BAM SEQ codes (2 per byte, high nibble first) into
+// IUPAC characters. 'out' must hold at least 'length' chars.
+//
+void DecodeSequence(const uint8_t* encoded, const size_t length, char* out);
+void DecodeSequence(const uint8_t* encoded,
+                    const size_t length,
+                    char* out,
+                    const SequenceKernelLevel level);
+
+// Packs 'length' characters into 4-bit BAM SEQ codes. 'out' must hold at least
+// (length+1)/2 bytes; the unused low nibble of an odd-length sequence is zero.
+//
+void EncodeSequence(const char* sequence, const size_t length, uint8_t* out);
+void EncodeSequence(const char* sequence,
+                    const size_t length,
+                    uint8_t* out,
+                    const SequenceKernelLevel level);
+
+// In-place reverse complement, case-insensitive (output is upper-case; '-' and
+// '*' are preserved). Same results as internal::Complement() per character.
+//
+void ReverseComplement(char* sequence, const size_t length);
+void ReverseComplement(char* sequence,
+                       const size_t length,
+                       const SequenceKernelLevel level);
+
+// In-place reverse complement, preserving case (for pulse calls & FASTA).
+//
+void ReverseComplementCaseSens(char* sequence, const size_t length);
+void ReverseComplementCaseSens(char* sequence,
+                               const size_t length,
+                               const SequenceKernelLevel level);
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+#endif // SEQUENCEKERNELS_H
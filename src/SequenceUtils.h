@@ -38,6 +38,7 @@
 #ifndef SEQUENCEUTILS_H
 #define SEQUENCEUTILS_H
 
+#include "SequenceKernels.h"
 #include "StringUtils.h"
 #include <algorithm>
 #include <string>
@@ -55,11 +56,12 @@ inline char Complement(const char character)
         '\0', '\0', 'C', 'D', '\0',
         '\0', 'M', '\0', 'K', 'N',
         '\0', '\0', '\0', 'Y', 'S',
-        'A', 'A', 'B', 'W', '\0', 'R'
+        'A', 'A', 'B', 'W', '\0', 'R',
+        '\0', '\0', '\0', '\0', '\0', '\0'
     };
     if (character == '-' || character == '*')
         return character;
-    return complementLookup[toupper(character) & 0x1f];
+    return complementLookup[toupper(static_cast<unsigned char>(character)) & 0x1f];
 }
 
 //inline void Reverse(std::string& s)
@@ -91,14 +93,8 @@ T Reversed(const T& input)
 //    return result;
 //}
 
-inline void ReverseComplement(std::string& seq) {
-
-    std::string::iterator sIter = seq.begin();
-    std::string::iterator sEnd  = seq.end();
-    for ( ; sIter != sEnd; ++sIter )
-        *sIter = Complement(*sIter);
-    Reverse(seq);
-}
+inline void ReverseComplement(std::string& seq)
+{ ReverseComplement(&seq[0], seq.size()); }
 
 inline std::string MaybeReverseComplement(std::string&& seq, bool reverse)
 {
@@ -108,21 +104,7 @@ inline std::string MaybeReverseComplement(std::string&& seq, bool reverse)
 
 /// Reverse complement a DNA sequence case-sensitive
 inline void ReverseComplementCaseSens(std::string& seq)
-{
-    const std::string original = seq;
-    int8_t rc_table[128] = {
-        4, 4, 4,   4,  4,   4, 4, 4,  4,  4,  4,  4, 4, 4,  4,  4, 4, 4, 4,
-        4, 4, 4,   4,  4,   4, 4, 4,  4,  4,  4,  4, 4, 32, 4,  4, 4, 4, 4,
-        4, 4, 4,   4,  4,   4, 4, 45, 4,  4,  4,  4, 4, 4,  4,  4, 4, 4, 4,
-        4, 4, 4,   4,  4,   4, 4, 4,  84, 4,  71, 4, 4, 4,  67, 4, 4, 4, 4,
-        4, 4, 78,  4,  4,   4, 4, 4,  65, 65, 4,  4, 4, 4,  4,  4, 4, 4, 4,
-        4, 4, 116, 4,  103, 4, 4, 4,  99, 4,  4,  4, 4, 4,  4,  4, 4, 4, 4,
-        4, 4, 97,  97, 4,   4, 4, 4,  4,  4,  4,  4, 4, 4};
-    std::string reverseCompl(original.length(), 'N');
-    for (uint32_t i = 0; i < original.length(); ++i)
-        reverseCompl[original.length()-i-1] = (char)rc_table[(int8_t)original[i]];
-    seq = reverseCompl;
-}
+{ ReverseComplementCaseSens(&seq[0], seq.size()); }
 
 inline std::string MaybeReverseComplementCaseSens(std::string&& seq, bool reverse)
 {
@@ -0,0 +1,455 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file SortingBamWriter.cpp
+/// \brief Implements the SortingBamWriter class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/SortingBamWriter.h"
+#include "pbbam/BamReader.h"
+#include "MemoryUtils.h"
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <cassert>
+#include <cstdio>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace internal {
+
+// Precomputed sort values for a record. Coordinate order uses only refId_ &
+// position_. QName order uses the remaining fields. Ties are broken on
+// sequence_ (input order), so results are deterministic & stable.
+struct SortKey
+{
+    const string* movieName_;
+    uint32_t refId_;
+    int32_t  position_;
+    int32_t  holeNumber_;
+    int32_t  isCcs_;
+    int32_t  queryStart_;
+    uint64_t sequence_;
+};
+
+struct SortKeyLess
+{
+    bool operator()(const SortKey& lhs, const SortKey& rhs) const
+    {
+        if (lhs.movieName_ != rhs.movieName_) {
+            const int cmp = lhs.movieName_->compare(*rhs.movieName_);
+            if (cmp != 0)
+                return cmp < 0;
+        }
+        if (lhs.refId_ != rhs.refId_)           return lhs.refId_ < rhs.refId_;
+        if (lhs.position_ != rhs.position_)     return lhs.position_ < rhs.position_;
+        if (lhs.holeNumber_ != rhs.holeNumber_) return lhs.holeNumber_ < rhs.holeNumber_;
+        if (lhs.isCcs_ != rhs.isCcs_)           return lhs.isCcs_ < rhs.isCcs_;
+        if (lhs.queryStart_ != rhs.queryStart_) return lhs.queryStart_ < rhs.queryStart_;
+        return lhs.sequence_ < rhs.sequence_;
+    }
+};
+
+struct SortKeyGreater
+{
+    bool operator()(const SortKey& lhs, const SortKey& rhs) const
+    { return SortKeyLess()(rhs, lhs); }
+};
+
+// sorts [begin, end) by splitting into per-thread chunks, then merging
+template<typename Iter, typename Compare>
+static void ParallelSort(Iter begin,
+                         Iter end,
+                         Compare comp,
+                         const size_t numThreads)
+{
+    const size_t numElements = std::distance(begin, end);
+    const size_t minChunkSize = 0x2000;
+    if (numThreads < 2 || numElements < 2*minChunkSize) {
+        std::sort(begin, end, comp);
+        return;
+    }
+
+    const size_t numChunks = std::min(numThreads, numElements / minChunkSize);
+    const size_t chunkSize = (numElements + numChunks - 1) / numChunks;
+    vector<Iter> bounds;
+    for (size_t i = 0; i < numChunks; ++i)
+        bounds.push_back(begin + i*chunkSize);
+    bounds.push_back(end);
+
+    vector<thread> threads;
+    for (size_t i = 0; i < numChunks; ++i)
+        threads.emplace_back([&bounds, &comp, i]() { std::sort(bounds.at(i), bounds.at(i+1), comp); });
+    for (auto& t : threads)
+        t.join();
+
+    // merge neighboring chunks, in parallel, until one remains
+    while (bounds.size() > 2) {
+        vector<Iter> mergedBounds;
+        threads.clear();
+        size_t i = 0;
+        for ( ; i + 2 < bounds.size(); i += 2) {
+            mergedBounds.push_back(bounds.at(i));
+            threads.emplace_back([&bounds, &comp, i]() {
+                std::inplace_merge(bounds.at(i), bounds.at(i+1), bounds.at(i+2), comp);
+            });
+        }
+        for ( ; i + 1 < bounds.size(); ++i)
+            mergedBounds.push_back(bounds.at(i));
+        mergedBounds.push_back(end);
+        for (auto& t : threads)
+            t.join();
+        bounds = std::move(mergedBounds);
+    }
+}
+
+// ------------------------------------------
+// SortingBamWriterPrivate implementation
+// ------------------------------------------
+
+class SortingBamWriterPrivate
+{
+public:
+    SortingBamWriterPrivate(const string& filename,
+                            const BamHeader& header,
+                            const SortingBamWriter::SortOrder sortOrder,
+                            const size_t memoryLimit,
+                            const size_t numThreads,
+                            const bool createPbi,
+                            const bool createBai,
+                            const BamWriter::CompressionLevel compressionLevel);
+    ~SortingBamWriterPrivate(void);
+
+public:
+    void Close(void);
+    void Write(const BamRecord& record);
+
+private:
+    SortKey MakeKey(const BamRecord& record, const uint64_t sequence);
+    void MergeRuns(void);
+    void RemoveRuns(void);
+    void SortBatch(void);
+    void SpillBatch(void);
+
+public:
+    string filename_;
+    BamHeader header_;
+    SortingBamWriter::SortOrder sortOrder_;
+    size_t memoryLimit_;
+    size_t numThreads_;
+    bool createPbi_;
+    bool createBai_;
+    BamWriter::CompressionLevel compressionLevel_;
+    bool isClosed_;
+
+    // current batch
+    vector<BamRecord> records_;
+    vector<SortKey> keys_;
+    size_t batchBytes_;
+    uint64_t numRecords_;
+
+    // sorted runs, written to temp files
+    vector<string> runFilenames_;
+
+    // QName order lookups
+    set<string> movieNames_;
+    map<string, pair<const string*, bool> > readGroupLookup_;
+};
+
+// writes sorted records to final output, with optional indices built on the fly
+class SortedOutput
+{
+public:
+    SortedOutput(const SortingBamWriterPrivate& settings)
+        : writer_(settings.filename_,
+                  settings.header_,
+                  settings.compressionLevel_,
+                  settings.numThreads_,
+                  BamWriter::BinCalculation_ON,
+                  OutputIndexTypes(settings))
+    { }
+
+    void Write(const BamRecord& record)
+    { writer_.Write(record); }
+
+private:
+    static BamWriter::IndexTypes OutputIndexTypes(const SortingBamWriterPrivate& settings)
+    {
+        BamWriter::IndexTypes indexTypes = BamWriter::NoIndex;
+        if (settings.filename_ != "-") {
+            if (settings.createPbi_)
+                indexTypes |= BamWriter::PacBioIndex;
+            if (settings.createBai_)
+                indexTypes |= BamWriter::StandardIndex;
+        }
+        return indexTypes;
+    }
+
+private:
+    BamWriter writer_;
+};
+
+SortingBamWriterPrivate::SortingBamWriterPrivate(const string& filename,
+                                                 const BamHeader& header,
+                                                 const SortingBamWriter::SortOrder sortOrder,
+                                                 const size_t memoryLimit,
+                                                 const size_t numThreads,
+                                                 const bool createPbi,
+                                                 const bool createBai,
+                                                 const BamWriter::CompressionLevel compressionLevel)
+    : filename_(filename)
+    , header_(header.DeepCopy())
+    , sortOrder_(sortOrder)
+    , memoryLimit_(memoryLimit)
+    , numThreads_(numThreads)
+    , createPbi_(createPbi)
+    , createBai_(createBai && sortOrder == SortingBamWriter::SortOrder_Coordinate)
+    , compressionLevel_(compressionLevel)
+    , isClosed_(false)
+    , batchBytes_(0)
+    , numRecords_(0)
+{
+    if (filename_.empty())
+        throw std::runtime_error("no output filename provided to SortingBamWriter");
+
+    // if no explicit thread count given, attempt built-in check
+    if (numThreads_ == 0) {
+        numThreads_ = thread::hardware_concurrency();
+
+        // if still unknown, default to single-threaded
+        if (numThreads_ == 0)
+            numThreads_ = 1;
+    }
+
+    header_.SortOrder(sortOrder_ == SortingBamWriter::SortOrder_Coordinate ? "coordinate"
+                                                                           : "unknown");
+}
+
+SortingBamWriterPrivate::~SortingBamWriterPrivate(void)
+{
+    RemoveRuns();
+}
+
+void SortingBamWriterPrivate::Close(void)
+{
+    if (isClosed_)
+        return;
+    isClosed_ = true;
+
+    // everything fit in memory, write directly
+    if (runFilenames_.empty()) {
+        SortBatch();
+        SortedOutput output(*this);
+        for (const SortKey& key : keys_)
+            output.Write(records_.at(key.sequence_ - (numRecords_ - records_.size())));
+        records_.clear();
+        keys_.clear();
+    }
+
+    // otherwise, write final run & merge all
+    else {
+        if (!records_.empty())
+            SpillBatch();
+        MergeRuns();
+        RemoveRuns();
+    }
+}
+
+SortKey SortingBamWriterPrivate::MakeKey(const BamRecord& record,
+                                         const uint64_t sequence)
+{
+    SortKey key;
+    key.movieName_  = nullptr;
+    key.refId_      = 0;
+    key.position_   = 0;
+    key.holeNumber_ = 0;
+    key.isCcs_      = 0;
+    key.queryStart_ = 0;
+    key.sequence_   = sequence;
+
+    if (sortOrder_ == SortingBamWriter::SortOrder_Coordinate) {
+        const int32_t refId = record.ReferenceId();
+        key.refId_ = static_cast<uint32_t>(refId); // unmapped (-1) sorts last
+        if (refId >= 0)
+            key.position_ = record.ReferenceStart();
+        return key;
+    }
+
+    // look up movie name & read type once per read group
+    pair<const string*, bool> readGroupValues;
+    const string rgId = record.ReadGroupId();
+    const auto found = readGroupLookup_.find(rgId);
+    if (found != readGroupLookup_.cend())
+        readGroupValues = found->second;
+    else {
+        const string* movieName = &(*movieNames_.insert(record.MovieName()).first);
+        readGroupValues = make_pair(movieName, record.Type() == RecordType::CCS);
+        if (!rgId.empty())
+            readGroupLookup_[rgId] = readGroupValues;
+    }
+
+    key.movieName_  = readGroupValues.first;
+    key.holeNumber_ = record.HoleNumber();
+    key.isCcs_      = readGroupValues.second ? 1 : 0;
+    if (!readGroupValues.second)
+        key.queryStart_ = record.QueryStart();
+    return key;
+}
+
+void SortingBamWriterPrivate::MergeRuns(void)
+{
+    // open runs & prime queue with each run's first record
+    const size_t numRuns = runFilenames_.size();
+    vector<unique_ptr<BamReader> > readers;
+    vector<BamRecord> nextRecords(numRuns);
+    priority_queue<SortKey, vector<SortKey>, SortKeyGreater> queue;
+    readers.reserve(numRuns);
+    for (size_t i = 0; i < numRuns; ++i) {
+        readers.emplace_back(new BamReader(runFilenames_.at(i)));
+        if (readers.back()->GetNext(nextRecords.at(i)))
+            queue.push(MakeKey(nextRecords.at(i), i)); // earlier runs win ties
+    }
+
+    SortedOutput output(*this);
+    while (!queue.empty()) {
+        const size_t run = queue.top().sequence_;
+        queue.pop();
+        output.Write(nextRecords.at(run));
+        if (readers.at(run)->GetNext(nextRecords.at(run)))
+            queue.push(MakeKey(nextRecords.at(run), run));
+    }
+}
+
+void SortingBamWriterPrivate::RemoveRuns(void)
+{
+    for (const string& fn : runFilenames_)
+        remove(fn.c_str());
+    runFilenames_.clear();
+}
+
+void SortingBamWriterPrivate::SortBatch(void)
+{
+    ParallelSort(keys_.begin(), keys_.end(), SortKeyLess(), numThreads_);
+}
+
+void SortingBamWriterPrivate::SpillBatch(void)
+{
+    SortBatch();
+
+    const string prefix = (filename_ == "-" ? string("pbbam") : filename_);
+    const string runFilename = prefix + ".sort." + to_string(runFilenames_.size()) + ".bam";
+    runFilenames_.push_back(runFilename);
+    {
+        BamWriter writer(runFilename,
+                         header_,
+                         BamWriter::FastCompression,
+                         numThreads_,
+                         BamWriter::BinCalculation_OFF);
+        const uint64_t firstSequence = numRecords_ - records_.size();
+        for (const SortKey& key : keys_)
+            writer.Write(records_.at(key.sequence_ - firstSequence));
+    }
+
+    records_.clear();
+    keys_.clear();
+    batchBytes_ = 0;
+}
+
+void SortingBamWriterPrivate::Write(const BamRecord& record)
+{
+    if (isClosed_)
+        throw std::runtime_error("cannot write to closed SortingBamWriter");
+
+    // flush batch to temp file if record would exceed memory limit
+    const auto rawRecord = internal::BamRecordMemory::GetRawData(record);
+    const size_t recordBytes = sizeof(BamRecord) + sizeof(SortKey) + sizeof(bam1_t) + rawRecord->l_data;
+    if (!records_.empty() && batchBytes_ + recordBytes > memoryLimit_)
+        SpillBatch();
+
+    keys_.push_back(MakeKey(record, numRecords_));
+    records_.push_back(record);
+    batchBytes_ += recordBytes;
+    ++numRecords_;
+}
+
+} // namespace internal
+} // namespace BAM
+} // namespace PacBio
+
+// ---------------------------------
+// SortingBamWriter implementation
+// ---------------------------------
+
+SortingBamWriter::SortingBamWriter(const std::string& filename,
+                                   const BamHeader& header,
+                                   const SortOrder sortOrder,
+                                   const size_t memoryLimit,
+                                   const size_t numThreads,
+                                   const bool createPbi,
+                                   const bool createBai,
+                                   const BamWriter::CompressionLevel compressionLevel)
+    : d_(new internal::SortingBamWriterPrivate(filename,
+                                               header,
+                                               sortOrder,
+                                               memoryLimit,
+                                               numThreads,
+                                               createPbi,
+                                               createBai,
+                                               compressionLevel))
+{ }
+
+SortingBamWriter::~SortingBamWriter(void)
+{
+    try {
+        d_->Close();
+    } catch (std::exception&) {
+        // swallow, destructor cannot throw. Call Close() to observe errors.
+    }
+}
+
+void SortingBamWriter::Close(void)
+{ d_->Close(); }
+
+void SortingBamWriter::Write(const BamRecord& record)
+{ d_->Write(record); }
@@ -0,0 +1,116 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file TagBatch.cpp
+/// \brief Implements the TagBatch class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/TagBatch.h"
+#include "pbbam/BamTagCodec.h"
+#include <algorithm>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+void TagBatch::EraseSetTag(const uint16_t tagCode)
+{
+    for (size_t i = 0; i < setTags_.size(); ++i) {
+        if (setTags_[i].first != tagCode)
+            continue;
+
+        // drop its bytes, shifting the values that follow
+        const size_t begin = setTags_[i].second;
+        const size_t end = (i+1 < setTags_.size()) ? setTags_[i+1].second
+                                                   : data_.size();
+        data_.erase(data_.begin() + begin, data_.begin() + end);
+        setTags_.erase(setTags_.begin() + i);
+        for (size_t j = i; j < setTags_.size(); ++j)
+            setTags_[j].second -= (end - begin);
+        return;
+    }
+}
+
+void TagBatch::Remove(const TagId& tagId)
+{
+    const uint16_t tagCode = tagId.Code();
+    EraseSetTag(tagCode);
+    if (std::find(removedTags_.cbegin(), removedTags_.cend(), tagCode) == removedTags_.cend())
+        removedTags_.push_back(tagCode);
+}
+
+bool TagBatch::Remove(const string& tagName)
+{
+    if (tagName.size() != 2)
+        return false;
+    Remove(TagId(tagName[0], tagName[1]));
+    return true;
+}
+
+bool TagBatch::Set(const TagId& tagId,
+                   const Tag& value,
+                   const TagModifier additionalModifier)
+{
+    const uint8_t typeCode = BamTagCodec::TagTypeCode(value, additionalModifier);
+    if (typeCode == 0)
+        return false;
+    const vector<uint8_t> rawData = BamTagCodec::ToRawData(value, additionalModifier);
+    if (rawData.empty())
+        return false;
+
+    // last value wins, & a value overrides any earlier removal
+    const uint16_t tagCode = tagId.Code();
+    EraseSetTag(tagCode);
+    removedTags_.erase(std::remove(removedTags_.begin(), removedTags_.end(), tagCode),
+                       removedTags_.end());
+
+    // "<TAG><TYPE><DATA>"
+    setTags_.push_back(std::make_pair(tagCode, data_.size()));
+    data_.push_back(static_cast<uint8_t>(tagCode >> 8));
+    data_.push_back(static_cast<uint8_t>(tagCode & 0xFF));
+    data_.push_back(typeCode);
+    data_.insert(data_.end(), rawData.cbegin(), rawData.cend());
+    return true;
+}
+
+bool TagBatch::Set(const string& tagName,
+                   const Tag& value,
+                   const TagModifier additionalModifier)
+{
+    if (tagName.size() != 2)
+        return false;
+    return Set(TagId(tagName[0], tagName[1]), value, additionalModifier);
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file TagView.cpp
+/// \brief Implements the TagView class.
+//
+// Author: Derek Barnett
+
+#include "pbbam/TagView.h"
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+size_t TagView::ElementSize(void) const
+{
+    switch (type_) {
+        case TagDataType::INT8        : // fall through
+        case TagDataType::UINT8       : // .
+        case TagDataType::STRING      : // .
+        case TagDataType::INT8_ARRAY  : // .
+        case TagDataType::UINT8_ARRAY : return 1;
+
+        case TagDataType::INT16        : // fall through
+        case TagDataType::UINT16       : // .
+        case TagDataType::INT16_ARRAY  : // .
+        case TagDataType::UINT16_ARRAY : return 2;
+
+        case TagDataType::INT32        : // fall through
+        case TagDataType::UINT32       : // .
+        case TagDataType::FLOAT        : // .
+        case TagDataType::INT32_ARRAY  : // .
+        case TagDataType::UINT32_ARRAY : // .
+        case TagDataType::FLOAT_ARRAY  : return 4;
+
+        default:
+            return 0;
+    }
+}
+
+Tag TagView::ToTag(void) const
+{
+    Tag result;
+    switch (type_) {
+        case TagDataType::INT8   : result = Tag(Element<int8_t>(0));   break;
+        case TagDataType::UINT8  : result = Tag(Element<uint8_t>(0));  break;
+        case TagDataType::INT16  : result = Tag(Element<int16_t>(0));  break;
+        case TagDataType::UINT16 : result = Tag(Element<uint16_t>(0)); break;
+        case TagDataType::INT32  : result = Tag(Element<int32_t>(0));  break;
+        case TagDataType::UINT32 : result = Tag(Element<uint32_t>(0)); break;
+        case TagDataType::FLOAT  : result = Tag(Element<float>(0));    break;
+        case TagDataType::STRING : result = Tag(ToString());            break;
+
+        case TagDataType::INT8_ARRAY   : result = Tag(ToVector<int8_t>());   break;
+        case TagDataType::UINT8_ARRAY  : result = Tag(ToVector<uint8_t>());  break;
+        case TagDataType::INT16_ARRAY  : result = Tag(ToVector<int16_t>());  break;
+        case TagDataType::UINT16_ARRAY : result = Tag(ToVector<uint16_t>()); break;
+        case TagDataType::INT32_ARRAY  : result = Tag(ToVector<int32_t>());  break;
+        case TagDataType::UINT32_ARRAY : result = Tag(ToVector<uint32_t>()); break;
+        case TagDataType::FLOAT_ARRAY  : result = Tag(ToVector<float>());    break;
+
+        default:
+            return Tag();
+    }
+    result.Modifier(modifier_);
+    return result;
+}
@@ -47,6 +47,8 @@
 #include "pbbam/virtual/VirtualZmwBamRecord.h"
 #include "pbbam/virtual/VirtualRegionType.h"
 #include "pbbam/virtual/VirtualRegionTypeMap.h"
+#include "pbbam/TagBatch.h"
+#include "BamRecordTags.h"
 
 using namespace PacBio;
 using namespace PacBio::BAM;
@@ -306,49 +308,54 @@ void VirtualZmwBamRecord::StitchSources(void)
     else
         this->Impl().SetSequenceAndQualities(sequence);
 
+    // Per-base tags, applied to the record in a single pass
+    TagBatch tags;
+
     // Tags as strings
     if (!deletionTag.empty())
-        this->DeletionTag(deletionTag);
+        tags.Set(tagName_deletionTag, deletionTag);
     if (!substitutionTag.empty())
-        this->SubstitutionTag(substitutionTag);
+        tags.Set(tagName_substitutionTag, substitutionTag);
     if (!alternativeLabelTag.empty())
-        this->AltLabelTag(alternativeLabelTag);
+        tags.Set(tagName_alternative_labelTag, alternativeLabelTag);
     if (!pulseCall.empty())
-        this->PulseCall(pulseCall);
+        tags.Set(tagName_pulse_call, pulseCall);
 
     // QVs
     if (!deletionQv.empty())
-        this->DeletionQV(deletionQv);
+        tags.Set(tagName_deletionQV, deletionQv.Fastq());
     if (!insertionQv.empty())
-        this->InsertionQV(insertionQv);
+        tags.Set(tagName_insertionQV, insertionQv.Fastq());
     if (!mergeQv.empty())
-        this->MergeQV(mergeQv);
+        tags.Set(tagName_mergeQV, mergeQv.Fastq());
     if (!pulseMergeQv.empty())
-        this->PulseMergeQV(pulseMergeQv);
+        tags.Set(tagName_pulseMergeQV, pulseMergeQv.Fastq());
     if (!substitutionQv.empty())
-        this->SubstitutionQV(substitutionQv);
+        tags.Set(tagName_substitutionQV, substitutionQv.Fastq());
     if (!labelQv.empty())
-        this->LabelQV(labelQv);
+        tags.Set(tagName_labelQV, labelQv.Fastq());
     if (!alternativeLabelQv.empty())
-        this->AltLabelQV(alternativeLabelQv);
+        tags.Set(tagName_alternative_labelQV, alternativeLabelQv.Fastq());
 
     // 16 bit arrays
     if (!ipd.Data().empty())
-        this->IPD(ipd, FrameEncodingType::LOSSLESS);
+        tags.Set(tagName_ipd, ipd.Data());
     if (!pw.Data().empty())
-        this->PulseWidth(pw, FrameEncodingType::LOSSLESS);
+        tags.Set(tagName_pulseWidth, pw.Data());
     if (!pa.empty())
-        this->Pkmean(pa);
+        tags.Set(tagName_pkmean, EncodePhotons(pa));
     if (!pm.empty())
-        this->Pkmid(pm);
+        tags.Set(tagName_pkmid, EncodePhotons(pm));
     if (!pd.Data().empty())
-        this->PrePulseFrames(pd, FrameEncodingType::LOSSLESS);
+        tags.Set(tagName_pre_pulse_frames, pd.Data());
     if (!px.Data().empty())
-        this->PulseCallWidth(px, FrameEncodingType::LOSSLESS);
+        tags.Set(tagName_pulse_call_width, px.Data());
 
     // 32 bit arrays
     if (!sf.empty())
-        this->StartFrame(sf);
+        tags.Set(tagName_startFrame, sf);
+
+    this->Impl().EditTags(tags);
 
     // Determine HQREGION bases on LQREGIONS
     if (HasVirtualRegionType(VirtualRegionType::LQREGION))
@@ -98,7 +98,7 @@ bool VirtualZmwCompositeReader::HasNext(void)
 VirtualZmwBamRecord VirtualZmwCompositeReader::Next(void)
 {
     if (currentReader_) {
-        const auto result = currentReader_->Next();
+        auto result = currentReader_->Next();
         if (!currentReader_->HasNext())
             OpenNextReader();
         return result;
@@ -115,7 +115,7 @@ VirtualZmwBamRecord VirtualZmwCompositeReader::Next(void)
 vector<BamRecord> VirtualZmwCompositeReader::NextRaw(void)
 {
     if (currentReader_) {
-        const auto result = currentReader_->NextRaw();
+        auto result = currentReader_->NextRaw();
         if (!currentReader_->HasNext())
             OpenNextReader();
         return result;
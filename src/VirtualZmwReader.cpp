@@ -40,6 +40,7 @@
 // Author: Armin Töpfer
 
 #include <stdexcept>
+#include <utility>
 
 #include "VirtualZmwReader.h"
 #include "pbbam/ReadGroupInfo.h"
@@ -119,18 +120,25 @@ std::vector<BamRecord> VirtualZmwReader::NextRaw(void)
         currentHoleNumber = std::min((*primaryIt_).HoleNumber(),
                                      (*scrapsIt_).HoleNumber());
 
+    // Records are swapped out of the iterators rather than copied: each
+    // iterator is left holding a fresh record for its next read.
+
     // collect subreads or hqregions
     while (primaryIt_ != primaryQuery_->end() &&
            currentHoleNumber == (*primaryIt_).HoleNumber())
     {
-        bamRecordVec.push_back(*primaryIt_++);
+        bamRecordVec.emplace_back();
+        std::swap(bamRecordVec.back(), *primaryIt_);
+        ++primaryIt_;
     }
 
     // collect scraps
     while (scrapsIt_ != scrapsQuery_->end() &&
            currentHoleNumber == (*scrapsIt_).HoleNumber())
     {
-        bamRecordVec.push_back(*scrapsIt_++);
+        bamRecordVec.emplace_back();
+        std::swap(bamRecordVec.back(), *scrapsIt_);
+        ++scrapsIt_;
     }
 
     return bamRecordVec;
@@ -105,10 +105,14 @@ public:
         scrapsReader_->Filter(PbiZmwFilter{zmw});
 
         auto record = BamRecord{ };
-        while (primaryReader_->GetNext(record))
-            result.push_back(record);
-        while (scrapsReader_->GetNext(record))
-            result.push_back(record);
+        while (primaryReader_->GetNext(record)) {
+            result.push_back(std::move(record));
+            record = BamRecord{ };
+        }
+        while (scrapsReader_->GetNext(record)) {
+            result.push_back(std::move(record));
+            record = BamRecord{ };
+        }
 
         zmwWhitelist_.pop_front();
         return result;
@@ -41,6 +41,7 @@
 
 #include "pbbam/ZmwGroupQuery.h"
 #include "pbbam/BamRecord.h"
+#include "pbbam/BamRecordPool.h"
 #include "pbbam/CompositeBamReader.h"
 #include "pbbam/PbiFilterTypes.h"
 #include "MemoryUtils.h"
@@ -74,14 +75,18 @@ struct ZmwGroupQuery::ZmwGroupQueryPrivate
 
     bool GetNext(std::vector<BamRecord>& records)
     {
-        records.clear();
+        // recycle the previous group's records
+        pool_.Release(records);
         if (!reader_)
             return false;
 
         // get all records matching ZMW
-        BamRecord r;
-        while (reader_->GetNext(r))
-            records.push_back(r);
+        BamRecord r = pool_.Acquire();
+        while (reader_->GetNext(r)) {
+            records.push_back(std::move(r));
+            r = pool_.Acquire();
+        }
+        pool_.Release(std::move(r));
 
         // set next ZMW (if any left)
         if (!whitelist_.empty()) {
@@ -98,6 +103,7 @@ struct ZmwGroupQuery::ZmwGroupQueryPrivate
 
     std::deque<int32_t> whitelist_;
     ReaderPtr reader_;
+    BamRecordPool pool_;
 };
 
 ZmwGroupQuery::ZmwGroupQuery(const std::vector<int32_t>& zmwWhitelist,
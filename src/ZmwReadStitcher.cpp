@@ -117,7 +117,7 @@ public:
     VirtualZmwBamRecord Next(void)
     {
         if (currentReader_) {
-            const auto result = currentReader_->Next();
+            auto result = currentReader_->Next();
             if (!currentReader_->HasNext())
                 OpenNextReader();
             return result;
@@ -134,7 +134,7 @@ public:
     vector<BamRecord> NextRaw(void)
     {
         if (currentReader_) {
-            const auto result = currentReader_->NextRaw();
+            auto result = currentReader_->NextRaw();
             if (!currentReader_->HasNext())
                 OpenNextReader();
             return result;
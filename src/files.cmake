@@ -5,11 +5,15 @@ set( PacBioBAM_H
     # API headers
     ${PacBioBAM_IncludeDir}/pbbam/Accuracy.h
     ${PacBioBAM_IncludeDir}/pbbam/AlignmentPrinter.h
+    ${PacBioBAM_IncludeDir}/pbbam/AsyncBamWriter.h
     ${PacBioBAM_IncludeDir}/pbbam/BamFile.h
+    ${PacBioBAM_IncludeDir}/pbbam/BamFileConcatenator.h
+    ${PacBioBAM_IncludeDir}/pbbam/BamFileCopier.h
     ${PacBioBAM_IncludeDir}/pbbam/BamHeader.h
     ${PacBioBAM_IncludeDir}/pbbam/BamRecord.h
     ${PacBioBAM_IncludeDir}/pbbam/BamRecordBuilder.h
     ${PacBioBAM_IncludeDir}/pbbam/BamRecordImpl.h
+    ${PacBioBAM_IncludeDir}/pbbam/BamRecordPool.h
     ${PacBioBAM_IncludeDir}/pbbam/BamTagCodec.h
     ${PacBioBAM_IncludeDir}/pbbam/BaiIndexedBamReader.h
     ${PacBioBAM_IncludeDir}/pbbam/BamReader.h
@@ -18,6 +22,7 @@ set( PacBioBAM_H
     ${PacBioBAM_IncludeDir}/pbbam/BarcodeQuery.h
     ${PacBioBAM_IncludeDir}/pbbam/Cigar.h
     ${PacBioBAM_IncludeDir}/pbbam/CigarOperation.h
+    ${PacBioBAM_IncludeDir}/pbbam/CigarView.h
     ${PacBioBAM_IncludeDir}/pbbam/Compare.h
     ${PacBioBAM_IncludeDir}/pbbam/Config.h
     ${PacBioBAM_IncludeDir}/pbbam/DataSet.h
@@ -31,6 +36,7 @@ set( PacBioBAM_H
     ${PacBioBAM_IncludeDir}/pbbam/Interval.h
     ${PacBioBAM_IncludeDir}/pbbam/LocalContextFlags.h
     ${PacBioBAM_IncludeDir}/pbbam/MD5.h
+    ${PacBioBAM_IncludeDir}/pbbam/OrderedBamWriter.h
     ${PacBioBAM_IncludeDir}/pbbam/Orientation.h
     ${PacBioBAM_IncludeDir}/pbbam/PbiBasicTypes.h
     ${PacBioBAM_IncludeDir}/pbbam/PbiBuilder.h
@@ -42,6 +48,7 @@ set( PacBioBAM_H
     ${PacBioBAM_IncludeDir}/pbbam/PbiIndexedBamReader.h
     ${PacBioBAM_IncludeDir}/pbbam/PbiLookupData.h
     ${PacBioBAM_IncludeDir}/pbbam/PbiRawData.h
+    ${PacBioBAM_IncludeDir}/pbbam/PerBaseColumns.h
     ${PacBioBAM_IncludeDir}/pbbam/Position.h
     ${PacBioBAM_IncludeDir}/pbbam/ProgramInfo.h
     ${PacBioBAM_IncludeDir}/pbbam/QNameQuery.h
@@ -51,10 +58,14 @@ set( PacBioBAM_H
     ${PacBioBAM_IncludeDir}/pbbam/ReadGroupInfo.h
     ${PacBioBAM_IncludeDir}/pbbam/SamTagCodec.h
     ${PacBioBAM_IncludeDir}/pbbam/SequenceInfo.h
+    ${PacBioBAM_IncludeDir}/pbbam/SortingBamWriter.h
     ${PacBioBAM_IncludeDir}/pbbam/Strand.h  
     ${PacBioBAM_IncludeDir}/pbbam/SubreadLengthQuery.h
     ${PacBioBAM_IncludeDir}/pbbam/Tag.h
+    ${PacBioBAM_IncludeDir}/pbbam/TagBatch.h
     ${PacBioBAM_IncludeDir}/pbbam/TagCollection.h
+    ${PacBioBAM_IncludeDir}/pbbam/TagId.h
+    ${PacBioBAM_IncludeDir}/pbbam/TagView.h
 #    ${PacBioBAM_IncludeDir}/pbbam/UnmappedReadsQuery.h
     ${PacBioBAM_IncludeDir}/pbbam/Validator.h
     ${PacBioBAM_IncludeDir}/pbbam/ZmwGroupQuery.h
@@ -72,8 +83,11 @@ set( PacBioBAM_H
     ${PacBioBAM_IncludeDir}/pbbam/internal/BamRecord.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/BamRecordBuilder.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/BamRecordImpl.inl
+    ${PacBioBAM_IncludeDir}/pbbam/internal/CacheState.h
+    ${PacBioBAM_IncludeDir}/pbbam/internal/CacheState.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/Cigar.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/CigarOperation.inl
+    ${PacBioBAM_IncludeDir}/pbbam/internal/CigarView.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/Compare.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/CompositeBamReader.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/DataSet.inl
@@ -93,6 +107,7 @@ set( PacBioBAM_H
     ${PacBioBAM_IncludeDir}/pbbam/internal/PbiIndex.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/PbiLookupData.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/PbiRawData.inl
+    ${PacBioBAM_IncludeDir}/pbbam/internal/PerBaseColumns.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/ProgramInfo.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/QualityValue.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/QualityValues.inl
@@ -101,6 +116,9 @@ set( PacBioBAM_H
     ${PacBioBAM_IncludeDir}/pbbam/internal/ReadGroupInfo.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/SequenceInfo.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/Tag.inl
+    ${PacBioBAM_IncludeDir}/pbbam/internal/TagBatch.inl
+    ${PacBioBAM_IncludeDir}/pbbam/internal/TagId.inl
+    ${PacBioBAM_IncludeDir}/pbbam/internal/TagView.inl
     ${PacBioBAM_IncludeDir}/pbbam/internal/Validator.inl
 
     # virtual headers
@@ -117,6 +135,8 @@ set( PacBioBAM_H
 
     # library-internal headers
     ${PacBioBAM_SourceDir}/AssertUtils.h
+    ${PacBioBAM_SourceDir}/BaiBuilder.h
+    ${PacBioBAM_SourceDir}/BamRecordTags.h
     ${PacBioBAM_SourceDir}/ChemistryTable.h
     ${PacBioBAM_SourceDir}/DataSetIO.h
     ${PacBioBAM_SourceDir}/DataSetUtils.h
@@ -125,6 +145,8 @@ set( PacBioBAM_H
     ${PacBioBAM_SourceDir}/FofnReader.h
     ${PacBioBAM_SourceDir}/MemoryUtils.h
     ${PacBioBAM_SourceDir}/PbiIndexIO.h
+    ${PacBioBAM_SourceDir}/ReadGroupTable.h
+    ${PacBioBAM_SourceDir}/SequenceKernels.h
     ${PacBioBAM_SourceDir}/SequenceUtils.h
     ${PacBioBAM_SourceDir}/StringUtils.h
     ${PacBioBAM_SourceDir}/TimeUtils.h
@@ -144,19 +166,25 @@ set( PacBioBAM_CPP
     ${PacBioBAM_SourceDir}/Accuracy.cpp
     ${PacBioBAM_SourceDir}/AlignmentPrinter.cpp
     ${PacBioBAM_SourceDir}/AssertUtils.cpp
+    ${PacBioBAM_SourceDir}/AsyncBamWriter.cpp
+    ${PacBioBAM_SourceDir}/BaiBuilder.cpp
     ${PacBioBAM_SourceDir}/BaiIndexedBamReader.cpp
     ${PacBioBAM_SourceDir}/BamFile.cpp
+    ${PacBioBAM_SourceDir}/BamFileConcatenator.cpp
+    ${PacBioBAM_SourceDir}/BamFileCopier.cpp
     ${PacBioBAM_SourceDir}/BamHeader.cpp
     ${PacBioBAM_SourceDir}/BamReader.cpp
     ${PacBioBAM_SourceDir}/BamRecord.cpp
     ${PacBioBAM_SourceDir}/BamRecordBuilder.cpp
     ${PacBioBAM_SourceDir}/BamRecordImpl.cpp
+    ${PacBioBAM_SourceDir}/BamRecordPool.cpp
     ${PacBioBAM_SourceDir}/BamTagCodec.cpp
     ${PacBioBAM_SourceDir}/BamWriter.cpp
     ${PacBioBAM_SourceDir}/BarcodeQuery.cpp
     ${PacBioBAM_SourceDir}/ChemistryTable.cpp
     ${PacBioBAM_SourceDir}/Cigar.cpp
     ${PacBioBAM_SourceDir}/CigarOperation.cpp
+    ${PacBioBAM_SourceDir}/CigarView.cpp
     ${PacBioBAM_SourceDir}/Compare.cpp
     ${PacBioBAM_SourceDir}/Config.cpp
     ${PacBioBAM_SourceDir}/DataSet.cpp
@@ -175,6 +203,7 @@ set( PacBioBAM_CPP
     ${PacBioBAM_SourceDir}/IndexedFastaReader.cpp
     ${PacBioBAM_SourceDir}/MD5.cpp
     ${PacBioBAM_SourceDir}/MemoryUtils.cpp
+    ${PacBioBAM_SourceDir}/OrderedBamWriter.cpp
     ${PacBioBAM_SourceDir}/PbiBuilder.cpp
     ${PacBioBAM_SourceDir}/PbiFile.cpp
     ${PacBioBAM_SourceDir}/PbiFilter.cpp
@@ -184,16 +213,23 @@ set( PacBioBAM_CPP
     ${PacBioBAM_SourceDir}/PbiIndexedBamReader.cpp
     ${PacBioBAM_SourceDir}/PbiIndexIO.cpp
     ${PacBioBAM_SourceDir}/PbiRawData.cpp
+    ${PacBioBAM_SourceDir}/PerBaseColumns.cpp
     ${PacBioBAM_SourceDir}/ProgramInfo.cpp
     ${PacBioBAM_SourceDir}/QNameQuery.cpp
     ${PacBioBAM_SourceDir}/QualityValue.cpp
+    ${PacBioBAM_SourceDir}/QualityValues.cpp
     ${PacBioBAM_SourceDir}/ReadAccuracyQuery.cpp
     ${PacBioBAM_SourceDir}/ReadGroupInfo.cpp
+    ${PacBioBAM_SourceDir}/ReadGroupTable.cpp
     ${PacBioBAM_SourceDir}/SamTagCodec.cpp
     ${PacBioBAM_SourceDir}/SequenceInfo.cpp
+    ${PacBioBAM_SourceDir}/SequenceKernels.cpp
+    ${PacBioBAM_SourceDir}/SortingBamWriter.cpp
     ${PacBioBAM_SourceDir}/SubreadLengthQuery.cpp
     ${PacBioBAM_SourceDir}/Tag.cpp
+    ${PacBioBAM_SourceDir}/TagBatch.cpp
     ${PacBioBAM_SourceDir}/TagCollection.cpp
+    ${PacBioBAM_SourceDir}/TagView.cpp
 #    ${PacBioBAM_SourceDir}/UnmappedReadsQuery.cpp
     ${PacBioBAM_SourceDir}/Validator.cpp
     ${PacBioBAM_SourceDir}/ValidationErrors.cpp
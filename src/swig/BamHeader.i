@@ -13,6 +13,7 @@ using namespace PacBio::BAM;
 
 %ignore PacBio::BAM::BamHeader::BamHeader(BamHeader&&);      // move ctors not used
 %ignore PacBio::BAM::BamHeader::operator=;                   // assignment operators not used
+%ignore PacBio::BAM::BamHeader::ReadGroupLookupTable;        // library-internal
 
 %template(ProgramInfoList)   std::vector<PacBio::BAM::ProgramInfo>;
 %template(ReadGroupInfoList) std::vector<PacBio::BAM::ReadGroupInfo>;
@@ -13,5 +13,8 @@ using namespace PacBio::BAM;
 %ignore PacBio::BAM::QualityValues::operator=;
 %ignore PacBio::BAM::QualityValues::QualityValues(QualityValues&&);
 %ignore PacBio::BAM::QualityValues::QualityValues(std::vector<QualityValue>&&);
+%ignore PacBio::BAM::QualityValues::QualityValues(const uint8_t*, const size_t);
+%ignore PacBio::BAM::QualityValues::FromFastq(const char*, const size_t);
+%ignore PacBio::BAM::QualityValues::RawData;
 
 %include <pbbam/QualityValues.h>
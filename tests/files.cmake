@@ -8,7 +8,10 @@ set( PacBioBAMTest_CPP
 
     ${PacBioBAM_TestsDir}/src/test_Accuracy.cpp
     ${PacBioBAM_TestsDir}/src/test_AlignmentPrinter.cpp
+    ${PacBioBAM_TestsDir}/src/test_AsyncBamWriter.cpp
     ${PacBioBAM_TestsDir}/src/test_BamFile.cpp
+    ${PacBioBAM_TestsDir}/src/test_BamFileConcatenator.cpp
+    ${PacBioBAM_TestsDir}/src/test_BamFileCopier.cpp
     ${PacBioBAM_TestsDir}/src/test_BamHeader.cpp
     ${PacBioBAM_TestsDir}/src/test_BamRecord.cpp
     ${PacBioBAM_TestsDir}/src/test_BamRecordBuilder.cpp
@@ -17,6 +20,7 @@ set( PacBioBAMTest_CPP
     ${PacBioBAM_TestsDir}/src/test_BamRecordImplTags.cpp
     ${PacBioBAM_TestsDir}/src/test_BamRecordImplVariableData.cpp
     ${PacBioBAM_TestsDir}/src/test_BamRecordMapping.cpp
+    ${PacBioBAM_TestsDir}/src/test_BamRecordPool.cpp
     ${PacBioBAM_TestsDir}/src/test_BamWriter.cpp
     ${PacBioBAM_TestsDir}/src/test_BarcodeQuery.cpp
     ${PacBioBAM_TestsDir}/src/test_Cigar.cpp
@@ -32,14 +36,17 @@ set( PacBioBAMTest_CPP
     ${PacBioBAM_TestsDir}/src/test_GenomicIntervalQuery.cpp
     ${PacBioBAM_TestsDir}/src/test_IndexedFastaReader.cpp
     ${PacBioBAM_TestsDir}/src/test_Intervals.cpp
+    ${PacBioBAM_TestsDir}/src/test_OrderedBamWriter.cpp
     ${PacBioBAM_TestsDir}/src/test_PacBioIndex.cpp
     ${PacBioBAM_TestsDir}/src/test_PbiFilter.cpp
     ${PacBioBAM_TestsDir}/src/test_PbiFilterQuery.cpp
+    ${PacBioBAM_TestsDir}/src/test_PerBaseColumns.cpp
     ${PacBioBAM_TestsDir}/src/test_QNameQuery.cpp
     ${PacBioBAM_TestsDir}/src/test_QualityValues.cpp
     ${PacBioBAM_TestsDir}/src/test_ReadAccuracyQuery.cpp
     ${PacBioBAM_TestsDir}/src/test_ReadGroupInfo.cpp
     ${PacBioBAM_TestsDir}/src/test_SequenceUtils.cpp
+    ${PacBioBAM_TestsDir}/src/test_SortingBamWriter.cpp
     ${PacBioBAM_TestsDir}/src/test_StringUtils.cpp
     ${PacBioBAM_TestsDir}/src/test_SubreadLengthQuery.cpp
     ${PacBioBAM_TestsDir}/src/test_Tags.cpp
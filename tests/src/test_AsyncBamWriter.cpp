@@ -0,0 +1,191 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// Author: Derek Barnett
+
+#ifdef PBBAM_TESTING
+#define private public
+#endif
+
+#include "TestData.h"
+#include <gtest/gtest.h>
+#include <pbbam/AsyncBamWriter.h>
+#include <pbbam/BamFile.h>
+#include <pbbam/BamRecord.h>
+#include <pbbam/EntireFileQuery.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdio>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace tests {
+
+static
+vector<BamRecord> LoadRecords(const string& fn)
+{
+    vector<BamRecord> result;
+    EntireFileQuery query(fn);
+    for (const BamRecord& record : query)
+        result.push_back(record);
+    return result;
+}
+
+static
+vector<string> RecordNames(const vector<BamRecord>& records)
+{
+    vector<string> result;
+    result.reserve(records.size());
+    for (const BamRecord& record : records)
+        result.push_back(record.FullName());
+    return result;
+}
+
+} // namespace tests
+} // namespace BAM
+} // namespace PacBio
+
+TEST(AsyncBamWriterTest, WritesRecordsInOrder)
+{
+    const string inputFn  = tests::Data_Dir + "/aligned2.bam";
+    const string outputFn = "/tmp/async_writer.bam";
+    const BamFile inputFile(inputFn);
+    const vector<BamRecord> input = tests::LoadRecords(inputFn);
+    ASSERT_FALSE(input.empty());
+
+    // queue of size 1 forces Write() to wait on the background thread
+    for (const size_t queueSize : { size_t(1), size_t(1024) }) {
+        {
+            vector<BamRecord> toMove = input;
+            AsyncBamWriter writer(outputFn, inputFile.Header(), queueSize);
+            for (size_t i = 0; i < toMove.size(); ++i) {
+                if (i % 2 == 0)
+                    writer.Write(input.at(i));
+                else
+                    writer.Write(std::move(toMove.at(i)));
+                if (i == toMove.size() / 2)
+                    writer.Flush();
+            }
+            writer.Close();
+        }
+        EXPECT_EQ(tests::RecordNames(input),
+                  tests::RecordNames(tests::LoadRecords(outputFn)));
+        remove(outputFn.c_str());
+    }
+}
+
+TEST(AsyncBamWriterTest, CreatesIndexes)
+{
+    const string inputFn  = tests::Data_Dir + "/aligned2.bam";
+    const string outputFn = "/tmp/async_writer_indexed.bam";
+    const BamFile inputFile(inputFn);
+    {
+        AsyncBamWriter writer(outputFn,
+                              inputFile.Header(),
+                              16,
+                              BamWriter::DefaultCompression,
+                              4,
+                              BamWriter::BinCalculation_ON,
+                              BamWriter::PacBioIndex | BamWriter::StandardIndex);
+        for (BamRecord& record : tests::LoadRecords(inputFn))
+            writer.Write(std::move(record));
+    }
+
+    const BamFile outputFile(outputFn);
+    EXPECT_TRUE(outputFile.PacBioIndexExists());
+    EXPECT_TRUE(outputFile.StandardIndexExists());
+
+    remove(outputFn.c_str());
+    remove(outputFile.PacBioIndexFilename().c_str());
+    remove(outputFile.StandardIndexFilename().c_str());
+}
+
+TEST(AsyncBamWriterTest, BackgroundErrorRethrownOnClose)
+{
+    const string inputFn  = tests::Data_Dir + "/aligned2.bam";
+    const string outputFn = "/tmp/async_writer_unsorted.bam";
+    const BamFile inputFile(inputFn);
+    vector<BamRecord> input = tests::LoadRecords(inputFn);
+    std::reverse(input.begin(), input.end());
+
+    // BAI generation fails on unsorted records, in the background thread
+    {
+        AsyncBamWriter writer(outputFn,
+                              inputFile.Header(),
+                              1024,
+                              BamWriter::DefaultCompression,
+                              4,
+                              BamWriter::BinCalculation_ON,
+                              BamWriter::StandardIndex);
+        EXPECT_THROW(
+        {
+            for (const BamRecord& record : input)
+                writer.Write(record);
+            writer.Close();
+        },
+        std::runtime_error);
+    }
+
+    // incomplete output is never renamed to requested filename
+    FILE* f = fopen(outputFn.c_str(), "rb");
+    EXPECT_TRUE(f == nullptr);
+    if (f)
+        fclose(f);
+
+    remove((outputFn + ".tmp").c_str());
+    remove((outputFn + ".tmp.bai").c_str());
+}
+
+TEST(AsyncBamWriterTest, ThrowsOnWriteAfterClose)
+{
+    const string inputFn  = tests::Data_Dir + "/aligned2.bam";
+    const string outputFn = "/tmp/async_writer_closed.bam";
+    const BamFile inputFile(inputFn);
+    const vector<BamRecord> input = tests::LoadRecords(inputFn);
+
+    AsyncBamWriter writer(outputFn, inputFile.Header());
+    writer.Write(input.front());
+    writer.Close();
+    EXPECT_THROW(writer.Write(input.front()), std::runtime_error);
+    EXPECT_THROW(writer.Flush(), std::runtime_error);
+    EXPECT_NO_THROW(writer.Close());
+
+    remove(outputFn.c_str());
+}
@@ -43,7 +43,10 @@
 #include <gtest/gtest.h>
 #include <pbbam/BamFile.h>
 #include <pbbam/EntireFileQuery.h>
+#include <pbbam/PbiRawData.h>
 #include <pbbam/../../src/FileUtils.h>
+#include <fstream>
+#include <iterator>
 #include <stdexcept>
 #include <cstdlib>
 #include <unistd.h>
@@ -67,6 +70,13 @@ void CheckFile(const T& input, const size_t expectedCount)
     EXPECT_EQ(expectedCount, observedCount);
 }
 
+static
+string FileContents(const string& fn)
+{
+    ifstream in(fn, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
 } // namespace tests
 } // namespace BAM
 } // namespace PacBio
@@ -140,3 +150,39 @@ TEST(BamFileTest, TruncatedFileThrowsOk)
 {
     EXPECT_THROW(BamFile{ tests::GeneratedData_Dir + "/truncated.bam" }, std::runtime_error);
 }
+
+TEST(BamFileTest, CreateIndexesMatchesSeparateIndexing)
+{
+    const string inputBamFn     = tests::Data_Dir + "/aligned2.bam";
+    const string generatedBamFn = "/tmp/bamfile_createindexes.bam";
+    const string generatedPbiFn = generatedBamFn + ".pbi";
+    const string generatedBaiFn = generatedBamFn + ".bai";
+
+    // byte-for-byte copy, so offsets in the original PBI remain valid
+    {
+        ifstream in(inputBamFn, ios::binary);
+        ofstream out(generatedBamFn, ios::binary);
+        out << in.rdbuf();
+    }
+
+    const BamFile file(generatedBamFn);
+    file.CreateIndexes();
+    EXPECT_TRUE(file.PacBioIndexExists());
+    EXPECT_TRUE(file.StandardIndexExists());
+
+    const string singlePassBai = tests::FileContents(generatedBaiFn);
+    file.CreateStandardIndex();
+    EXPECT_EQ(tests::FileContents(generatedBaiFn), singlePassBai);
+
+    const PbiRawData expectedPbi(inputBamFn + ".pbi");
+    const PbiRawData singlePassPbi(generatedPbiFn);
+    EXPECT_EQ(expectedPbi.NumReads(),     singlePassPbi.NumReads());
+    EXPECT_EQ(expectedPbi.FileSections(), singlePassPbi.FileSections());
+    EXPECT_EQ(expectedPbi.BasicData().fileOffset_, singlePassPbi.BasicData().fileOffset_);
+    EXPECT_EQ(expectedPbi.BasicData().holeNumber_, singlePassPbi.BasicData().holeNumber_);
+    EXPECT_EQ(expectedPbi.MappedData().tStart_,    singlePassPbi.MappedData().tStart_);
+
+    remove(generatedBamFn.c_str());
+    remove(generatedPbiFn.c_str());
+    remove(generatedBaiFn.c_str());
+}
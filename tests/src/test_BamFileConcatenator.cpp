@@ -0,0 +1,165 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// Author: Derek Barnett
+
+#ifdef PBBAM_TESTING
+#define private public
+#endif
+
+#include "TestData.h"
+#include <gtest/gtest.h>
+#include <pbbam/BamFile.h>
+#include <pbbam/BamFileConcatenator.h>
+#include <pbbam/BamReader.h>
+#include <pbbam/BamRecord.h>
+#include <pbbam/EntireFileQuery.h>
+#include <pbbam/PbiBuilder.h>
+#include <pbbam/PbiRawData.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace tests {
+
+static const string chunkPrefix = tests::Data_Dir + "/chunking/m150404_101626_42267_c100807920800000001823174110291514_s1_p0";
+
+static
+vector<BamFile> ChunkedBamFiles(void)
+{
+    return vector<BamFile> {
+        BamFile{ chunkPrefix + ".1.subreads.bam" },
+        BamFile{ chunkPrefix + ".2.subreads.bam" },
+        BamFile{ chunkPrefix + ".3.subreads.bam" }
+    };
+}
+
+static
+vector<string> RecordNames(const BamFile& file)
+{
+    vector<string> result;
+    EntireFileQuery query(file);
+    for (const BamRecord& record : query)
+        result.push_back(record.FullName());
+    return result;
+}
+
+} // namespace tests
+} // namespace BAM
+} // namespace PacBio
+
+TEST(BamFileConcatenatorTest, RecordsCopiedInInputOrder)
+{
+    const string outBamFn = "/tmp/concatenated.bam";
+    const auto inputFiles = tests::ChunkedBamFiles();
+    BamFileConcatenator::Concatenate(inputFiles, outBamFn, ProgramInfo(), false);
+
+    vector<string> expectedNames;
+    for (const auto& file : inputFiles) {
+        const auto names = tests::RecordNames(file);
+        expectedNames.insert(expectedNames.end(), names.cbegin(), names.cend());
+    }
+
+    const BamFile outFile(outBamFn);
+    EXPECT_TRUE(outFile.HasEOF());
+    EXPECT_EQ(inputFiles.front().Header().ReadGroups().size(),
+              outFile.Header().ReadGroups().size());
+    EXPECT_EQ(expectedNames, tests::RecordNames(outFile));
+
+    remove(outBamFn.c_str());
+}
+
+TEST(BamFileConcatenatorTest, ConcatenatedPbiMatchesRebuiltPbi)
+{
+    const string outBamFn = "/tmp/concatenated.bam";
+    const string outPbiFn = outBamFn + ".pbi";
+    const string rebuiltPbiFn = "/tmp/concatenated_rebuilt.bam.pbi";
+
+    BamFileConcatenator::Concatenate(tests::ChunkedBamFiles(), outBamFn);
+
+    // build index from concatenated BAM contents
+    const BamFile outFile(outBamFn);
+    {
+        PbiBuilder builder(rebuiltPbiFn, outFile.Header().Sequences().size());
+        BamReader reader(outFile);
+        BamRecord b;
+        int64_t offset = reader.VirtualTell();
+        while (reader.GetNext(b)) {
+            builder.AddRecord(b, offset);
+            offset = reader.VirtualTell();
+        }
+    }
+
+    const PbiRawData expected(rebuiltPbiFn);
+    const PbiRawData concatenated(outPbiFn);
+    EXPECT_EQ(expected.NumReads(),     concatenated.NumReads());
+    EXPECT_EQ(expected.FileSections(), concatenated.FileSections());
+
+    const PbiRawBasicData& e = expected.BasicData();
+    const PbiRawBasicData& a = concatenated.BasicData();
+    EXPECT_EQ(e.rgId_,       a.rgId_);
+    EXPECT_EQ(e.qStart_,     a.qStart_);
+    EXPECT_EQ(e.qEnd_,       a.qEnd_);
+    EXPECT_EQ(e.holeNumber_, a.holeNumber_);
+    EXPECT_EQ(e.readQual_,   a.readQual_);
+    EXPECT_EQ(e.ctxtFlag_,   a.ctxtFlag_);
+    EXPECT_EQ(e.fileOffset_, a.fileOffset_);
+
+    remove(outBamFn.c_str());
+    remove(outPbiFn.c_str());
+    remove(rebuiltPbiFn.c_str());
+}
+
+TEST(BamFileConcatenatorTest, ThrowsOnMismatchedSequences)
+{
+    const string outBamFn = "/tmp/concatenated_mismatch.bam";
+    const vector<BamFile> inputFiles {
+        BamFile{ tests::Data_Dir + "/aligned.bam" },
+        BamFile{ tests::chunkPrefix + ".1.subreads.bam" }
+    };
+    EXPECT_THROW(BamFileConcatenator::Concatenate(inputFiles, outBamFn),
+                 std::runtime_error);
+}
+
+TEST(BamFileConcatenatorTest, ThrowsOnEmptyInput)
+{
+    EXPECT_THROW(BamFileConcatenator::Concatenate(vector<BamFile>(), "/tmp/concatenated.bam"),
+                 std::runtime_error);
+}
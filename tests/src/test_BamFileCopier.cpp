@@ -0,0 +1,183 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// Author: Derek Barnett
+
+#ifdef PBBAM_TESTING
+#define private public
+#endif
+
+#include "TestData.h"
+#include <gtest/gtest.h>
+#include <pbbam/BamFile.h>
+#include <pbbam/BamFileCopier.h>
+#include <pbbam/BamReader.h>
+#include <pbbam/BamRecord.h>
+#include <pbbam/PbiBuilder.h>
+#include <pbbam/PbiFilterTypes.h>
+#include <pbbam/PbiRawData.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace tests {
+
+static const string chunkPrefix = tests::Data_Dir + "/chunking/m150404_101626_42267_c100807920800000001823174110291514_s1_p0";
+
+static
+vector<BamFile> ChunkedBamFiles(void)
+{
+    return vector<BamFile> {
+        BamFile{ chunkPrefix + ".1.subreads.bam" },
+        BamFile{ chunkPrefix + ".2.subreads.bam" },
+        BamFile{ chunkPrefix + ".3.subreads.bam" }
+    };
+}
+
+// names of records passing filter, the slow way
+static
+vector<string> ExpectedNames(const vector<BamFile>& files, const PbiFilter& filter)
+{
+    vector<string> result;
+    for (const auto& file : files) {
+        const PbiRawData index(file.PacBioIndexFilename());
+        BamReader reader(file);
+        BamRecord record;
+        size_t row = 0;
+        while (reader.GetNext(record)) {
+            if (filter.Accepts(index, row))
+                result.push_back(record.FullName());
+            ++row;
+        }
+    }
+    return result;
+}
+
+static
+vector<string> RecordNames(const BamFile& file)
+{
+    vector<string> result;
+    BamReader reader(file);
+    BamRecord record;
+    while (reader.GetNext(record))
+        result.push_back(record.FullName());
+    return result;
+}
+
+static
+void CheckCopy(const PbiFilter& filter)
+{
+    const string outBamFn = "/tmp/filtered_copy.bam";
+    const string outPbiFn = outBamFn + ".pbi";
+    const string rebuiltPbiFn = "/tmp/filtered_copy_rebuilt.bam.pbi";
+
+    const auto inputFiles = ChunkedBamFiles();
+    BamFileCopier::Copy(inputFiles, filter, outBamFn);
+
+    // check records
+    const BamFile outFile(outBamFn);
+    EXPECT_TRUE(outFile.HasEOF());
+    EXPECT_EQ(ExpectedNames(inputFiles, filter), RecordNames(outFile));
+
+    // check PBI against index built from output BAM contents
+    {
+        PbiBuilder builder(rebuiltPbiFn, outFile.Header().Sequences().size());
+        BamReader reader(outFile);
+        BamRecord b;
+        int64_t offset = reader.VirtualTell();
+        while (reader.GetNext(b)) {
+            builder.AddRecord(b, offset);
+            offset = reader.VirtualTell();
+        }
+    }
+    const PbiRawData expected(rebuiltPbiFn);
+    const PbiRawData copied(outPbiFn);
+    EXPECT_EQ(expected.NumReads(),     copied.NumReads());
+    EXPECT_EQ(expected.FileSections(), copied.FileSections());
+
+    const PbiRawBasicData& e = expected.BasicData();
+    const PbiRawBasicData& a = copied.BasicData();
+    EXPECT_EQ(e.holeNumber_, a.holeNumber_);
+    EXPECT_EQ(e.qStart_,     a.qStart_);
+    EXPECT_EQ(e.qEnd_,       a.qEnd_);
+    EXPECT_EQ(e.readQual_,   a.readQual_);
+    EXPECT_EQ(e.fileOffset_, a.fileOffset_);
+
+    remove(outBamFn.c_str());
+    remove(outPbiFn.c_str());
+    remove(rebuiltPbiFn.c_str());
+}
+
+} // namespace tests
+} // namespace BAM
+} // namespace PacBio
+
+TEST(BamFileCopierTest, AcceptAllCopiesEveryRecord)
+{
+    tests::CheckCopy(PbiFilter{ });
+}
+
+TEST(BamFileCopierTest, PartialFilterCopiesAcceptedRecords)
+{
+    tests::CheckCopy(PbiQueryLengthFilter{ 500, Compare::GREATER_THAN_EQUAL });
+    tests::CheckCopy(PbiQueryLengthFilter{ 500, Compare::LESS_THAN });
+}
+
+TEST(BamFileCopierTest, RejectAllWritesEmptyFile)
+{
+    tests::CheckCopy(PbiZmwFilter{ -1 });
+}
+
+TEST(BamFileCopierTest, ThrowsOnMismatchedSequences)
+{
+    const string outBamFn = "/tmp/filtered_copy_mismatch.bam";
+    const vector<BamFile> inputFiles {
+        BamFile{ tests::Data_Dir + "/aligned.bam" },
+        BamFile{ tests::chunkPrefix + ".1.subreads.bam" }
+    };
+    EXPECT_THROW(BamFileCopier::Copy(inputFiles, PbiFilter{ }, outBamFn),
+                 std::runtime_error);
+}
+
+TEST(BamFileCopierTest, ThrowsOnEmptyInput)
+{
+    EXPECT_THROW(BamFileCopier::Copy(vector<BamFile>(), PbiFilter{ }, "/tmp/filtered_copy.bam"),
+                 std::runtime_error);
+}
@@ -42,9 +42,14 @@
 #include <gtest/gtest.h>
 #include <pbbam/BamRecord.h>
 #include <pbbam/BamTagCodec.h>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <initializer_list>
+#include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 using namespace PacBio;
 using namespace PacBio::BAM;
@@ -1480,3 +1485,255 @@ TEST(BamRecordTest, FrameTagsClippedAndAligned)
         );
     }
 }
+
+TEST(BamRecordTest, OutParameterOverloadsReuseStorage)
+{
+    const vector<uint16_t> frames = { 10, 20, 10, 20, 10, 20, 10, 20, 10, 20 };
+    const string quals = "?]?]?]?]?]";
+
+    BamRecord b = tests::MakeCigaredQualRecord(quals, "2S3=2D1I2=2P2S", Strand::REVERSE);
+    b.IPD(Frames{ frames }, FrameEncodingType::LOSSLESS);
+    b.DeletionTag(string("ACGTACGTAC"));
+
+    string bases;
+    QualityValues qvs;
+    Frames ipd;
+    for (const auto orientation : { Orientation::GENOMIC, Orientation::NATIVE }) {
+        for (const bool aligned : { false, true }) {
+            for (const bool exciseSoftClips : { false, true }) {
+                b.Sequence(&bases, orientation, aligned, exciseSoftClips);
+                EXPECT_EQ(b.Sequence(orientation, aligned, exciseSoftClips), bases);
+                b.DeletionTag(&bases, orientation, aligned, exciseSoftClips);
+                EXPECT_EQ(b.DeletionTag(orientation, aligned, exciseSoftClips), bases);
+                b.Qualities(&qvs, orientation, aligned, exciseSoftClips);
+                EXPECT_EQ(b.Qualities(orientation, aligned, exciseSoftClips), qvs);
+                b.DeletionQV(&qvs, orientation, aligned, exciseSoftClips);
+                EXPECT_EQ(b.DeletionQV(orientation, aligned, exciseSoftClips), qvs);
+                b.IPD(&ipd, orientation, aligned, exciseSoftClips);
+                EXPECT_EQ(b.IPD(orientation, aligned, exciseSoftClips), ipd);
+            }
+        }
+    }
+
+    // excising soft clips alone drops clipped positions, but leaves out gaps
+    const BamRecord forward = tests::MakeCigaredQualRecord(quals, "2S3=2D1I2=2P2S", Strand::FORWARD);
+    forward.DeletionQV(&qvs, Orientation::GENOMIC, false, true);
+    EXPECT_EQ(string("?]?]?]"), qvs.Fastq());
+    forward.DeletionQV(&qvs, Orientation::GENOMIC, true, true);
+    EXPECT_EQ(string("?]?!!]?]!!"), qvs.Fastq());
+
+    // a buffer large enough for the result is reused as-is
+    bases.reserve(64);
+    const char* basesData = bases.data();
+    b.Sequence(&bases, Orientation::NATIVE, true, false);
+    EXPECT_EQ(basesData, bases.data());
+
+    vector<uint16_t> ipdData;
+    ipdData.reserve(64);
+    ipd.Data(std::move(ipdData));
+    const uint16_t* ipdPtr = ipd.Data().data();
+    b.IPD(&ipd, Orientation::GENOMIC, true, true);
+    EXPECT_EQ(ipdPtr, ipd.Data().data());
+}
+
+TEST(BamRecordTest, AlignmentStatsCachedUntilModified)
+{
+    const ReadGroupInfo rg("movie1", "SUBREAD");
+    BamHeader header;
+    header.AddReadGroup(rg);
+
+    BamRecord b(header);
+    b.Impl() = tests::MakeCigaredImpl("ACGTACGTACGTA", "2S3=2D1I2X1N3=2S", Strand::FORWARD);
+    b.Impl().Position(100);
+    b.ReadGroup(rg).HoleNumber(42).QueryStart(500).QueryEnd(513);
+
+    EXPECT_EQ(6, b.NumMatches());
+    EXPECT_EQ(2, b.NumMismatches());
+    EXPECT_EQ(1, b.NumInsertedBases());
+    EXPECT_EQ(3, b.NumDeletedBases());
+    EXPECT_EQ(111, b.ReferenceEnd());
+    EXPECT_EQ(502, b.AlignedStart());
+    EXPECT_EQ(511, b.AlignedEnd());
+
+    // same values as derived from positions
+    const auto nM  = b.NumMatches();
+    const auto nMM = b.NumMismatches();
+    EXPECT_EQ(b.AlignedEnd() - b.AlignedStart() - nM - nMM, b.NumInsertedBases());
+    EXPECT_EQ(b.ReferenceEnd() - b.ReferenceStart() - nM - nMM, b.NumDeletedBases());
+
+    // copies keep computed values
+    const BamRecord copy = b;
+    EXPECT_TRUE(copy.alignmentStatsState_.IsValid());
+    EXPECT_EQ(6, copy.NumMatches());
+
+    // edits reset them
+    b.Impl().CigarData(std::string("2S4=1X4=2S"));
+    EXPECT_EQ(8, b.NumMatches());
+    EXPECT_EQ(1, b.NumMismatches());
+    EXPECT_EQ(0, b.NumInsertedBases());
+    EXPECT_EQ(0, b.NumDeletedBases());
+    EXPECT_EQ(109, b.ReferenceEnd());
+
+    b.Clip(ClipType::CLIP_TO_REFERENCE, 102, 107);
+    EXPECT_EQ(5, b.NumMatches() + b.NumMismatches());
+    EXPECT_EQ(107, b.ReferenceEnd());
+    EXPECT_EQ(6, copy.NumMatches());
+}
+
+TEST(BamRecordTest, ReadGroupLookupSharedByRecords)
+{
+    const ReadGroupInfo subreadRg("movie1", "SUBREAD");
+    const ReadGroupInfo ccsRg("movie2", "CCS");
+    ReadGroupInfo customRg("custom_id");
+    customRg.MovieName("movie3");
+    customRg.ReadType("HQREGION");
+
+    BamHeader header;
+    header.AddReadGroup(subreadRg);
+    header.AddReadGroup(ccsRg);
+    header.AddReadGroup(customRg);
+
+    BamRecord subread(header);
+    subread.ReadGroup(subreadRg);
+    BamRecord ccs(header);
+    ccs.ReadGroup(ccsRg);
+    BamRecord custom(header);
+    custom.ReadGroupId("custom_id");
+
+    // values come from header's pre-parsed table
+    EXPECT_EQ(string("movie1"), subread.MovieName());
+    EXPECT_EQ(RecordType::SUBREAD, subread.Type());
+    EXPECT_EQ(subreadRg.Id(), subread.ReadGroup().Id());
+    EXPECT_EQ(string("movie2"), ccs.MovieName());
+    EXPECT_EQ(RecordType::CCS, ccs.Type());
+    EXPECT_EQ(string("movie3"), custom.MovieName());
+    EXPECT_EQ(RecordType::HQREGION, custom.Type());
+
+    // no copies: repeated lookups, from any record sharing the header, refer
+    // to the same data
+    const BamRecord subreadCopy = subread;
+    EXPECT_EQ(&subread.ReadGroup(), &subread.ReadGroup());
+    EXPECT_EQ(&subread.ReadGroup(), &subreadCopy.ReadGroup());
+    EXPECT_EQ(&subread.MovieName(), &subreadCopy.MovieName());
+    EXPECT_EQ(&header.ReadGroupLookupTable(), &header.ReadGroupLookupTable());
+
+    // IDs are matched exactly (as with BamHeader::ReadGroup)
+    std::string upperId = subreadRg.Id();
+    std::transform(upperId.begin(), upperId.end(), upperId.begin(), ::toupper);
+    ASSERT_NE(subreadRg.Id(), upperId);
+    BamRecord upperCase(header);
+    upperCase.Impl().AddTag("RG", upperId);
+    EXPECT_THROW(upperCase.ReadGroup(), std::runtime_error);
+
+    // unknown read group
+    BamRecord unknown(header);
+    unknown.Impl().AddTag("RG", string("deadbeef"));
+    EXPECT_THROW(unknown.ReadGroup(), std::runtime_error);
+    EXPECT_THROW(unknown.MovieName(), std::runtime_error);
+    EXPECT_EQ(RecordType::UNKNOWN, unknown.Type());
+
+    // modifying header's read groups rebuilds the table
+    header.ReadGroups({ ReadGroupInfo("movie4", "SUBREAD"), ReadGroupInfo("deadbeef") });
+    EXPECT_THROW(subread.MovieName(), std::runtime_error);
+    EXPECT_EQ(RecordType::UNKNOWN, unknown.Type());
+    EXPECT_NO_THROW(unknown.ReadGroup());
+}
+
+TEST(BamRecordTest, ConcurrentConstAccessIsConsistent)
+{
+    const ReadGroupInfo rg("movie1", "SUBREAD");
+    BamHeader header;
+    header.AddReadGroup(rg);
+
+    const vector<uint16_t> ipd = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    BamRecord prototype(header);
+    prototype.Impl() = tests::MakeCigaredImpl("AACCGTTAGC", "2S6=2S", Strand::FORWARD);
+    prototype.ReadGroup(rg).HoleNumber(42).QueryStart(500).QueryEnd(510);
+    prototype.IPD(Frames{ ipd }, FrameEncodingType::LOSSLESS);
+
+    // each record shares the prototype's data, but starts with empty caches
+    const size_t numRecords = 1000;
+    std::vector<BamRecord> records;
+    records.reserve(numRecords);
+    for (size_t i = 0; i < numRecords; ++i) {
+        BamRecord record(header);
+        record.Impl() = prototype.Impl();
+        record.Impl().InvalidateTagMap();
+        records.push_back(std::move(record));
+    }
+
+    // several threads hit each record's lazily computed values at once
+    // (run under TSan, with -DPacBioBAM_use_tsan=ON, to check for races)
+    std::atomic<int> numMismatches(0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&]() {
+            for (const BamRecord& record : records) {
+                const bool ok = record.AlignedStart() == 502 &&
+                                record.AlignedEnd() == 508 &&
+                                record.Type() == RecordType::SUBREAD &&
+                                record.HoleNumber() == 42 &&
+                                record.HasIPD() &&
+                                record.IPD(Orientation::NATIVE).Data() == ipd;
+                if (!ok)
+                    ++numMismatches;
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    EXPECT_EQ(0, numMismatches);
+
+    // copying a record in concurrent use is also safe, & keeps its values
+    const BamRecord copy = records.front();
+    EXPECT_EQ(502, copy.AlignedStart());
+    EXPECT_EQ(RecordType::SUBREAD, copy.Type());
+}
+
+TEST(BamRecordTest, TypeWithoutReadGroupsTimings)
+{
+    // header lists no read groups, so each record's type falls back to its name
+    const BamHeader header;
+    const size_t numRecords = 100000;
+
+    std::vector<BamRecord> records;
+    records.reserve(numRecords);
+    for (size_t i = 0; i < numRecords; ++i) {
+        BamRecord record(header);
+        const bool isCcs = (i % 2 == 0);
+        record.Impl().Name(isCcs ? string("movie/" + std::to_string(i) + "/ccs")
+                                 : string("movie/" + std::to_string(i) + "/0_10"));
+        record.Impl().AddTag("RG", string("deadbeef"));
+        records.push_back(std::move(record));
+    }
+
+    // first call: resolves & caches type
+    size_t numCcs = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const BamRecord& record : records)
+        numCcs += (record.Type() == RecordType::CCS) ? 1 : 0;
+    auto end = std::chrono::steady_clock::now();
+    const double firstNs = std::chrono::duration<double, std::nano>(end - start).count() / numRecords;
+
+    // repeat calls (e.g. merge comparators): cached
+    size_t numCcsCached = 0;
+    start = std::chrono::steady_clock::now();
+    for (const BamRecord& record : records)
+        numCcsCached += (record.Type() == RecordType::CCS) ? 1 : 0;
+    end = std::chrono::steady_clock::now();
+    const double cachedNs = std::chrono::duration<double, std::nano>(end - start).count() / numRecords;
+
+    EXPECT_EQ(numRecords/2, numCcs);
+    EXPECT_EQ(numRecords/2, numCcsCached);
+    EXPECT_EQ(RecordType::CCS, records.at(0).Type());
+    EXPECT_EQ(RecordType::UNKNOWN, records.at(1).Type());
+
+    std::cout << "BamRecord::Type(), no read groups: "
+              << firstNs  << " ns/record (first call), "
+              << cachedNs << " ns/record (cached)" << std::endl;
+
+    // editing a record via Impl() drops its cached type
+    BamRecord& record = records.at(1);
+    record.Impl().Name("movie/1/ccs");
+    EXPECT_EQ(RecordType::CCS, record.Type());
+}
@@ -210,6 +210,113 @@ TEST(BamRecordBuilderTest, CheckSetters)
     EXPECT_EQ(std::vector<uint8_t>({34, 5, 125}), fetchedTags.at("CA").ToUInt8Array());
 }
 
+TEST(BamRecordBuilderTest, VariableLengthDataRoundTrip)
+{
+    TagCollection tags;
+    tags["HX"] = std::string("1abc75");
+    tags["HX"].Modifier(TagModifier::HEX_STRING);
+    tags["CA"] = std::vector<uint8_t>({34, 5, 125});
+    tags["XY"] = static_cast<int32_t>(-42);
+    tags["ip"] = std::vector<uint16_t>({1, 2, 3, 4, 5});
+
+    const std::string sequence  = "ACGTNACGT";  // odd length
+    const std::string qualities = "@@@@@@@@A";
+
+    Cigar cigar;
+    cigar.push_back(CigarOperation('S', 2));
+    cigar.push_back(CigarOperation('=', 3));
+    cigar.push_back(CigarOperation('X', 1));
+    cigar.push_back(CigarOperation('D', 4));
+    cigar.push_back(CigarOperation('=', 3));
+
+    BamRecordBuilder builder;
+    builder.Name("movie/42/0_9")
+           .Position(100)
+           .Sequence(sequence)
+           .Qualities(qualities)
+           .Cigar(cigar)
+           .Tags(tags);
+
+    const BamRecord bam = builder.Build();
+    tests::CheckRawData(bam);
+
+    const PBBAM_SHARED_PTR<bam1_t> rawData = bam.impl_.d_;
+    const size_t expectedDataLength = 13 + 5*4 + 5 + 9 + BamTagCodec::EncodedSize(tags);
+    EXPECT_EQ(expectedDataLength, static_cast<size_t>(rawData->l_data));
+    EXPECT_EQ(hts_reg2bin(100, 111, 14, 5), rawData->core.bin);
+
+    EXPECT_EQ("movie/42/0_9", bam.impl_.Name());
+    EXPECT_EQ(sequence,  bam.impl_.Sequence());
+    EXPECT_EQ(qualities, bam.impl_.Qualities().Fastq());
+    EXPECT_EQ(cigar.ToStdString(), bam.impl_.CigarData().ToStdString());
+
+    const TagCollection fetchedTags = bam.impl_.Tags();
+    EXPECT_EQ(std::string("1abc75"), fetchedTags.at("HX").ToString());
+    EXPECT_EQ(std::vector<uint8_t>({34, 5, 125}), fetchedTags.at("CA").ToUInt8Array());
+    EXPECT_EQ(static_cast<int32_t>(-42), fetchedTags.at("XY").ToInt32());
+    EXPECT_EQ(std::vector<uint16_t>({1, 2, 3, 4, 5}), fetchedTags.at("ip").ToUInt16Array());
+
+    // empty qualities are stored as 0xFF
+    builder.Qualities(std::string());
+    const BamRecord noQuals = builder.Build();
+    const uint8_t* qual = bam_get_qual(noQuals.impl_.d_.get());
+    for (size_t i = 0; i < sequence.size(); ++i)
+        EXPECT_EQ(0xFF, qual[i]);
+    EXPECT_EQ(sequence, noQuals.impl_.Sequence());
+}
+
+TEST(BamRecordBuilderTest, ReusedRecordKeepsItsBuffer)
+{
+    BamRecordBuilder builder;
+    BamRecord record;
+
+    builder.Name("first")
+           .Sequence(std::string(100, 'A'))
+           .Qualities(std::string(100, '5'));
+    EXPECT_TRUE(builder.BuildInPlace(record));
+    const uint8_t* data = record.impl_.d_->data;
+    const int capacity  = record.impl_.d_->m_data;
+
+    for (size_t i = 0; i < 100; ++i) {
+        TagCollection tags;
+        tags["zm"] = static_cast<int32_t>(i);
+
+        const std::string sequence(50 + i%7, "ACGT"[i%4]);
+        builder.Reset();
+        builder.Name("movie/" + std::to_string(i) + "/ccs")
+               .Sequence(sequence)
+               .Qualities(std::string(sequence.size(), '5'))
+               .Tags(tags);
+        EXPECT_TRUE(builder.BuildInPlace(record));
+
+        EXPECT_EQ(data, record.impl_.d_->data);
+        EXPECT_EQ(capacity, record.impl_.d_->m_data);
+        EXPECT_EQ(sequence, record.Sequence());
+        EXPECT_EQ(static_cast<int32_t>(i), record.impl_.TagValue("zm").ToInt32());
+    }
+}
+
+TEST(BamRecordBuilderTest, EncodeTagsIntoExistingMemory)
+{
+    TagCollection tags;
+    tags["HX"] = std::string("1abc75");
+    tags["HX"].Modifier(TagModifier::HEX_STRING);
+    tags["CA"] = std::vector<uint8_t>({34, 5, 125});
+    tags["XY"] = static_cast<int32_t>(-42);
+    tags["ZZ"] = Tag();  // null, skipped
+
+    const std::vector<uint8_t> expected = BamTagCodec::Encode(tags);
+    EXPECT_EQ(28, expected.size());
+    EXPECT_EQ(expected.size(), BamTagCodec::EncodedSize(tags));
+
+    std::vector<uint8_t> out(expected.size());
+    EXPECT_EQ(expected.size(), BamTagCodec::Encode(tags, out.data()));
+    EXPECT_EQ(expected, out);
+
+    EXPECT_EQ(0, BamTagCodec::EncodedSize(TagCollection()));
+    EXPECT_TRUE(BamTagCodec::Encode(TagCollection()).empty());
+}
+
 //#define SEQ_LENGTH  7000
 //#define NUM_RECORDS 1000
 
@@ -1211,3 +1211,88 @@ TEST(BamRecordTest, ClipCigarData)
     EXPECT_EQ(s3_cigar, s3_cigar_raw.ToStdString());
     EXPECT_EQ(string("4=1D2I2D4="), s3_cigar_clipped.ToStdString());
 }
+
+TEST(BamRecordClippingTest, ClipSlicesRawTagBytes)
+{
+    const Position qStart = 500;
+    const Position qEnd   = 511;
+    const string seq      = "AACCGTTAGCT";   // odd length
+    const string quals    = "?]?]?]?]?*+";
+    const string tagBases = "AACCGTTAGCT";
+    const string tagQuals = "?]?]?]?]?*+";
+    const f_data frames   = { 10, 10, 20, 20, 30, 40, 40, 10, 30, 20, 500 };
+
+    // lossy frame codes
+    const vector<uint8_t> codes = Frames::Encode(frames);
+
+    BamRecord prototype = tests::MakeRecord(qStart, qEnd, seq, quals, tagBases, tagQuals, frames);
+    prototype.Impl().EditTag("ip", codes);
+    prototype.Impl().AddTag("zz", std::vector<uint8_t>({ 1, 2, 3 }));
+
+    // odd start, in both orientations
+    BamRecord s1 = prototype;
+    BamRecord s1_rev = prototype;
+    s1.Map(0, 100, Strand::FORWARD, string("11="), 80);
+    s1_rev.Map(0, 100, Strand::REVERSE, string("11="), 80);
+    const uint8_t* data = s1.Impl().d_->data;
+
+    s1.Clip(ClipType::CLIP_TO_QUERY, 503, 509);
+    s1_rev.Clip(ClipType::CLIP_TO_QUERY, 503, 509);
+
+    // compacted in place
+    EXPECT_EQ(data, s1.Impl().d_->data);
+
+    EXPECT_EQ("CGTTAG",  s1.Sequence());
+    EXPECT_EQ("]?]?]?",  s1.Qualities().Fastq());
+    EXPECT_EQ("CGTTAG",  s1.DeletionTag());
+    EXPECT_EQ("]?]?]?",  s1.SubstitutionQV().Fastq());
+    EXPECT_EQ(string("6="), s1.CigarData().ToStdString());
+    EXPECT_EQ(103, s1.ReferenceStart());
+
+    EXPECT_EQ("CGTTAG",  s1_rev.Sequence());
+    EXPECT_EQ("]?]?]?",  s1_rev.Qualities().Fastq());
+    EXPECT_EQ("CGTTAG",  s1_rev.DeletionTag());
+    EXPECT_EQ("]?]?]?",  s1_rev.SubstitutionQV().Fastq());
+    EXPECT_EQ(string("6="), s1_rev.CigarData().ToStdString());
+
+    // frame codes sliced as-is (not decoded & re-encoded as full frames)
+    const vector<uint8_t> codes_clipped(codes.begin() + 3, codes.begin() + 9);
+    EXPECT_EQ(codes_clipped, s1.Impl().TagValue("ip").ToUInt8Array());
+    EXPECT_EQ(codes_clipped, s1_rev.Impl().TagValue("ip").ToUInt8Array());
+    EXPECT_EQ(f_data(frames.begin() + 3, frames.begin() + 9), s1.PulseWidth().Data());
+
+    // other tags untouched
+    EXPECT_EQ(vector<uint8_t>({ 1, 2, 3 }), s1.Impl().TagValue("zz").ToUInt8Array());
+    EXPECT_EQ(frames, s1.Impl().TagValue("pa").ToUInt16Array());
+    EXPECT_EQ(503, s1.QueryStart());
+    EXPECT_EQ(509, s1.QueryEnd());
+
+    // even start, through the tail (leaves an odd-length SEQ)
+    BamRecord s2 = prototype;
+    s2.Clip(ClipType::CLIP_TO_QUERY, 504, 511);
+    EXPECT_EQ("GTTAGCT", s2.Sequence());
+    EXPECT_EQ("?]?]?*+", s2.Qualities().Fastq());
+    EXPECT_EQ(f_data(frames.begin() + 4, frames.end()), s2.PulseWidth().Data());
+    EXPECT_EQ(vector<uint8_t>(codes.begin() + 4, codes.end()), s2.Impl().TagValue("ip").ToUInt8Array());
+}
+
+TEST(BamRecordClippingTest, ClipLeavesMalformedTagsUntouched)
+{
+    BamRecordImpl impl;
+    impl.SetSequenceAndQualities("ACGTACGT", "?]?]?]?]");
+    impl.AddTag("ip", std::vector<uint16_t>({ 1, 2, 3, 4, 5, 6, 7, 8 }));
+    impl.AddTag("zz", std::vector<uint8_t>({ 1, 2, 3 }));
+
+    // corrupt the per-base tag's array subtype ("ipB<SUBTYPE>...")
+    uint8_t* tags = bam_get_aux(impl.d_);
+    ASSERT_EQ('B', tags[2]);
+    tags[3] = 'x';
+    const string before(reinterpret_cast<const char*>(impl.d_->data), impl.d_->l_data);
+    const uint32_t seqLength = impl.d_->core.l_qseq;
+
+    // clip is refused up front, rather than leaving SEQ/QUAL clipped & tags not
+    impl.ClipSequenceAndTags(2, 2, 4, { TagId('i', 'p') });
+    EXPECT_EQ(seqLength, impl.d_->core.l_qseq);
+    EXPECT_EQ(before, string(reinterpret_cast<const char*>(impl.d_->data), impl.d_->l_data));
+    EXPECT_EQ("ACGTACGT", impl.Sequence());
+}
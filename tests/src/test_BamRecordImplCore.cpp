@@ -496,6 +496,55 @@ TEST(BamRecordImplCoreTest, CopyConstructor)
     tests::CheckRawData(bam2);
 }
 
+TEST(BamRecordImplCoreTest, CopiesShareDataUntilModified)
+{
+    BamRecordImpl bam1;
+    bam1.Name("original");
+    bam1.Position(42);
+    TagCollection tags;
+    tags["XY"] = static_cast<int32_t>(-42);
+    bam1.Tags(tags);
+
+    const uint64_t copiesBefore = BamRecordImpl::numDeepCopies_.load();
+
+    // copies share data
+    BamRecordImpl bam2(bam1);
+    BamRecordImpl bam3;
+    bam3 = bam1;
+    EXPECT_EQ(bam1.d_.get(), bam2.d_.get());
+    EXPECT_EQ(bam1.d_.get(), bam3.d_.get());
+    EXPECT_EQ(copiesBefore, BamRecordImpl::numDeepCopies_.load());
+
+    // first modification detaches (once), others are unaffected
+    bam2.Name("edited");
+    bam2.Position(100);
+    EXPECT_NE(bam1.d_.get(), bam2.d_.get());
+    EXPECT_EQ(copiesBefore + 1, BamRecordImpl::numDeepCopies_.load());
+    EXPECT_EQ(std::string("edited"), bam2.Name());
+    EXPECT_EQ(100, bam2.Position());
+    EXPECT_EQ(std::string("original"), bam1.Name());
+    EXPECT_EQ(42, bam1.Position());
+    EXPECT_EQ(std::string("original"), bam3.Name());
+
+    // tag edits detach too
+    EXPECT_TRUE(bam3.EditTag("XY", static_cast<int32_t>(7)));
+    EXPECT_EQ(copiesBefore + 2, BamRecordImpl::numDeepCopies_.load());
+    EXPECT_EQ(7, bam3.TagValue("XY").ToInt32());
+    EXPECT_EQ(-42, bam1.TagValue("XY").ToInt32());
+    EXPECT_EQ(-42, bam2.TagValue("XY").ToInt32());
+
+    // sole owner is modified in place
+    const bam1_t* data1 = bam1.d_.get();
+    bam1.Position(43);
+    EXPECT_TRUE(bam1.AddTag("XZ", static_cast<int32_t>(1)));
+    EXPECT_EQ(data1, bam1.d_.get());
+    EXPECT_EQ(copiesBefore + 2, BamRecordImpl::numDeepCopies_.load());
+
+    tests::CheckRawData(bam1);
+    tests::CheckRawData(bam2);
+    tests::CheckRawData(bam3);
+}
+
 TEST(BamRecordImplCoreTest, CreateRecord_InternalTest)
 {
     BamRecordImpl bam = tests::CreateBamImpl();
@@ -212,3 +212,210 @@ TEST(BamRecordImplTagsTest, SimpleQueryTag)
     EXPECT_EQ(Tag(), bam.TagValue("some_too_long_name"));
 }
 
+
+TEST(BamRecordImplTagsTest, TagOffsetsBuiltLazily)
+{
+    TagCollection tags;
+    tags["XY"] = (int32_t)-42;
+    tags["CA"] = std::vector<uint8_t>({34, 5, 125});
+
+    BamRecordImpl bam;
+    bam.Tags(tags);
+
+    // setting tags only invalidates offsets, first query builds them
+    EXPECT_FALSE(bam.tagMapState_.IsValid());
+    EXPECT_TRUE(bam.HasTag("XY"));
+    EXPECT_TRUE(bam.tagMapState_.IsValid());
+    EXPECT_EQ(2, bam.tagOffsets_.size());
+
+    // edits invalidate, & are seen by next query
+    EXPECT_TRUE(bam.RemoveTag("XY"));
+    EXPECT_FALSE(bam.tagMapState_.IsValid());
+    EXPECT_FALSE(bam.HasTag("XY"));
+    EXPECT_TRUE(bam.HasTag("CA"));
+
+    EXPECT_TRUE(bam.AddTag("ZZ", (int32_t)7));
+    EXPECT_EQ(7, bam.TagValue("ZZ").ToInt32());
+    EXPECT_TRUE(bam.EditTag("ZZ", (int32_t)8));
+    EXPECT_EQ(8, bam.TagValue("ZZ").ToInt32());
+    EXPECT_EQ(std::vector<uint8_t>({34, 5, 125}), bam.TagValue("CA").ToUInt8Array());
+
+    // copies & moves carry (or rebuild) valid offsets
+    const BamRecordImpl copied = bam;
+    EXPECT_EQ(8, copied.TagValue("ZZ").ToInt32());
+    BamRecordImpl moved = std::move(bam);
+    EXPECT_EQ(8, moved.TagValue("ZZ").ToInt32());
+    EXPECT_TRUE(moved.HasTag("CA"));
+}
+
+TEST(BamRecordImplTagsTest, TagValueViewsRawData)
+{
+    TagCollection tags;
+    tags["HX"] = std::string("1abc75");
+    tags["HX"].Modifier(TagModifier::HEX_STRING);
+    tags["ZS"] = std::string("ACGT");
+    tags["CA"] = std::vector<uint8_t>({34, 5, 125});
+    tags["SA"] = std::vector<uint16_t>({1, 500, 65535});
+    tags["FA"] = std::vector<float>({1.5f, -2.25f});
+    tags["XY"] = (int32_t)-42;
+
+    BamRecordImpl bam;
+    bam.Tags(tags);
+
+    // missing & invalid names
+    EXPECT_TRUE(bam.TagValueView("zz").IsNull());
+    EXPECT_TRUE(bam.TagValueView("").IsNull());
+    EXPECT_TRUE(bam.TagValueView("some_too_long_name").IsNull());
+
+    // strings
+    const TagView zs = bam.TagValueView("ZS");
+    EXPECT_TRUE(zs.IsString());
+    EXPECT_EQ(4, zs.Size());
+    EXPECT_EQ(std::string("ACGT"), zs.ToString());
+    EXPECT_EQ(tags["ZS"], zs.ToTag());
+
+    const TagView hx = bam.TagValueView("HX");
+    EXPECT_EQ(TagModifier::HEX_STRING, hx.Modifier());
+    EXPECT_EQ(std::string("1abc75"), hx.ToString());
+
+    // arrays - view points into record's own data
+    const TagView ca = bam.TagValueView("CA");
+    EXPECT_TRUE(ca.IsArray());
+    EXPECT_EQ(TagDataType::UINT8_ARRAY, ca.Type());
+    EXPECT_EQ(3, ca.Size());
+    EXPECT_EQ(125, ca.Element<uint8_t>(2));
+    const uint8_t* auxStart = bam_get_aux(bam.d_);
+    const uint8_t* auxEnd = bam.d_->data + bam.d_->l_data;
+    EXPECT_TRUE(ca.RawData() > auxStart && ca.RawData() < auxEnd);
+
+    const TagView sa = bam.TagValueView("SA");
+    EXPECT_EQ(TagDataType::UINT16_ARRAY, sa.Type());
+    EXPECT_EQ(2, sa.ElementSize());
+    EXPECT_EQ(std::vector<uint16_t>({1, 500, 65535}), sa.ToVector<uint16_t>());
+    uint16_t buffer[3];
+    sa.CopyTo(buffer);
+    EXPECT_EQ(500, buffer[1]);
+    EXPECT_THROW(sa.ToVector<uint8_t>(), std::runtime_error);
+
+    const TagView fa = bam.TagValueView("FA");
+    EXPECT_EQ(TagDataType::FLOAT_ARRAY, fa.Type());
+    EXPECT_FLOAT_EQ(-2.25f, fa.Element<float>(1));
+    EXPECT_EQ(tags["FA"], fa.ToTag());
+
+    // scalars
+    const TagView xy = bam.TagValueView("XY");
+    EXPECT_EQ(TagDataType::INT32, xy.Type());
+    EXPECT_EQ(-42, xy.Element<int32_t>(0));
+    EXPECT_EQ(tags["XY"], xy.ToTag());
+}
+
+TEST(BamRecordImplTagsTest, TagIdOverloads)
+{
+    static constexpr TagId xy('X', 'Y');
+    static constexpr TagId ca('C', 'A');
+    static_assert(xy.Code() == (('X' << 8) | 'Y'), "TagId code should be usable at compile-time");
+
+    EXPECT_EQ(xy, TagId(std::string("XY")));
+    EXPECT_EQ(std::string("XY"), xy.ToString());
+    EXPECT_THROW(TagId(std::string("XYZ")), std::runtime_error);
+
+    BamRecordImpl bam;
+    EXPECT_FALSE(bam.HasTag(xy));
+    EXPECT_TRUE(bam.TagValue(xy).IsNull());
+    EXPECT_TRUE(bam.TagValueView(xy).IsNull());
+
+    EXPECT_TRUE(bam.AddTag(xy, (int32_t)-42));
+    EXPECT_FALSE(bam.AddTag(xy, (int32_t)-42));
+    EXPECT_TRUE(bam.AddTag(ca, std::vector<uint8_t>({34, 5, 125})));
+    EXPECT_TRUE(bam.HasTag(xy));
+    EXPECT_TRUE(bam.HasTag("XY"));
+    EXPECT_EQ(-42, bam.TagValue(xy).ToInt32());
+
+    EXPECT_TRUE(bam.EditTag(xy, (int32_t)7));
+    EXPECT_EQ(7, bam.TagValue("XY").ToInt32());
+    EXPECT_EQ(7, bam.TagValueView(xy).Element<int32_t>(0));
+
+    EXPECT_TRUE(bam.RemoveTag(xy));
+    EXPECT_FALSE(bam.RemoveTag(xy));
+    EXPECT_FALSE(bam.HasTag(xy));
+    EXPECT_FALSE(bam.EditTag(xy, (int32_t)8));
+    EXPECT_EQ(std::vector<uint8_t>({34, 5, 125}), bam.TagValue(ca).ToUInt8Array());
+}
+
+TEST(BamRecordImplTagsTest, TagBatchEdits)
+{
+    TagCollection tags;
+    tags["XY"] = (int32_t)-42;
+    tags["CA"] = std::vector<uint8_t>({34, 5, 125});
+    tags["HX"] = std::string("1abc75");
+    tags["HX"].Modifier(TagModifier::HEX_STRING);
+
+    BamRecordImpl bam;
+    bam.Name("foo");
+    bam.SetSequenceAndQualities("ACGT", "IIII");
+    bam.Tags(tags);
+
+    TagBatch batch;
+    EXPECT_TRUE(batch.IsEmpty());
+    EXPECT_TRUE(batch.Set("XY", (int32_t)7));                             // edit
+    EXPECT_TRUE(batch.Set("ip", std::vector<uint16_t>({1, 2, 300})));     // add
+    EXPECT_TRUE(batch.Set("zz", std::string("dropped")));
+    EXPECT_TRUE(batch.Set("aa", (int32_t)'a', TagModifier::ASCII_CHAR));
+    batch.Remove("zz");                                                    // drops earlier Set
+    batch.Remove("HX");                                                    // remove
+    batch.Remove("NO");                                                    // not present
+    EXPECT_TRUE(batch.Set("dq", std::string("old")));
+    EXPECT_TRUE(batch.Set("dq", std::string("!!!!")));                    // last value wins
+    EXPECT_FALSE(batch.Set("too_long", (int32_t)1));
+    EXPECT_FALSE(batch.Remove("too_long"));
+    EXPECT_EQ(4, batch.NumSetTags());
+    EXPECT_EQ(3, batch.NumRemovedTags());
+
+    bam.EditTags(batch);
+
+    // tag offsets are rebuilt along with the data, without a re-scan
+    EXPECT_TRUE(bam.tagMapState_.IsValid());
+
+    EXPECT_EQ(7, bam.TagValue("XY").ToInt32());
+    EXPECT_EQ(std::vector<uint8_t>({34, 5, 125}), bam.TagValue("CA").ToUInt8Array());
+    EXPECT_EQ(std::vector<uint16_t>({1, 2, 300}), bam.TagValue("ip").ToUInt16Array());
+    EXPECT_EQ('a', bam.TagValue("aa").ToAscii());
+    EXPECT_EQ(std::string("!!!!"), bam.TagValue("dq").ToString());
+    EXPECT_FALSE(bam.HasTag("HX"));
+    EXPECT_FALSE(bam.HasTag("zz"));
+
+    // other fields untouched
+    EXPECT_EQ(std::string("foo"),  bam.Name());
+    EXPECT_EQ(std::string("ACGT"), bam.Sequence());
+    EXPECT_EQ(std::string("IIII"), bam.Qualities().Fastq());
+
+    // same result as the equivalent series of single-tag edits (kept tags
+    // stay in order, set tags follow in batch order)
+    BamRecordImpl expected;
+    expected.Name("foo");
+    expected.SetSequenceAndQualities("ACGT", "IIII");
+    expected.Tags(tags);
+    expected.EditTag("XY", (int32_t)7);
+    expected.RemoveTag("HX");
+    expected.AddTag("ip", std::vector<uint16_t>({1, 2, 300}));
+    expected.AddTag("aa", (int32_t)'a', TagModifier::ASCII_CHAR);
+    expected.AddTag("dq", std::string("!!!!"));
+    ASSERT_EQ(expected.d_->l_data, bam.d_->l_data);
+    EXPECT_EQ(0, memcmp(expected.d_->data, bam.d_->data, bam.d_->l_data));
+
+    // shared data is detached first
+    const BamRecordImpl copy = bam;
+    TagBatch removeAll;
+    for (const auto& name : { "XY", "CA", "ip", "aa", "dq" })
+        removeAll.Remove(name);
+    bam.EditTags(removeAll);
+    EXPECT_TRUE(bam.Tags().empty());
+    EXPECT_EQ(5, copy.Tags().size());
+
+    // batch may be reused
+    batch.Clear();
+    EXPECT_TRUE(batch.IsEmpty());
+    EXPECT_TRUE(batch.Set("XY", (int32_t)1));
+    bam.EditTags(batch);
+    EXPECT_EQ(1, bam.TagValue("XY").ToInt32());
+}
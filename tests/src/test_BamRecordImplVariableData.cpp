@@ -265,6 +265,31 @@ TEST(BamRecordImplVariableDataTest, CigarOnly_ThenOverwriteWithEmptyCigar)
     tests::CheckRawData(bam);
 }
 
+TEST(BamRecordImplVariableDataTest, CigarOnly_View)
+{
+    const std::string cigar = "2S100=10D100=10I100X3H";
+
+    BamRecordImpl bam;
+    EXPECT_TRUE(bam.CigarDataView().IsEmpty());
+    bam.CigarData(cigar);
+
+    // view reads the packed operations in place
+    const CigarView view = bam.CigarDataView();
+    EXPECT_EQ(7, view.Size());
+    EXPECT_EQ(bam_get_cigar(bam.d_.get()), view.RawData());
+    EXPECT_EQ(CigarOperationType::SOFT_CLIP, view.Type(0));
+    EXPECT_EQ(2, view.Length(0));
+    EXPECT_EQ(CigarOperation('D', 10), view[2]);
+    EXPECT_EQ(cigar, view.ToStdString());
+    EXPECT_EQ(bam.CigarData(), view.ToCigar());
+
+    Cigar fromIterators;
+    for (const CigarOperation& op : view)
+        fromIterators.push_back(op);
+    EXPECT_EQ(bam.CigarData(), fromIterators);
+    EXPECT_EQ(7, std::distance(view.begin(), view.end()));
+}
+
 TEST(BamRecordImplVariableDataTest, CigarTag_Init_Normal)
 {
     const std::string cigar = "100=";
@@ -540,6 +565,26 @@ TEST(BamRecordImplVariableDataTest, SeqQualOnly_Init_NormalQual)
     tests::CheckRawData(bam);
 }
 
+TEST(BamRecordImplVariableDataTest, SeqQualOnly_QualitiesView)
+{
+    const std::string sequence  = "ACGTACGTACGT";
+    const std::string qualities = "?]?]?]?]?]?]";
+
+    BamRecordImpl bam;
+    EXPECT_TRUE(bam.QualitiesView().IsNull());
+
+    bam.SetSequenceAndQualities(sequence, std::string());
+    EXPECT_TRUE(bam.QualitiesView().IsNull());
+
+    bam.SetSequenceAndQualities(sequence, qualities);
+    const TagView view = bam.QualitiesView();
+    ASSERT_FALSE(view.IsNull());
+    EXPECT_EQ(TagDataType::UINT8_ARRAY, view.Type());
+    EXPECT_EQ(qualities.size(), view.Size());
+    EXPECT_EQ(bam_get_qual(bam.d_), view.RawData());
+    EXPECT_EQ(qualities, QualityValues(view.RawData(), view.Size()).Fastq());
+}
+
 TEST(BamRecordImplVariableDataTest, SeqQualOnly_Init_EmptyQual)
 {
     const std::string sequence  = "ACGTACGTACGT";
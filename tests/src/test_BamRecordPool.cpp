@@ -0,0 +1,157 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file test_BamRecordPool.cpp
+/// \brief Tests for the BamRecordPool class.
+//
+// Author: Derek Barnett
+
+#ifdef PBBAM_TESTING
+#define private public
+#endif
+
+#include "TestData.h"
+#include <gtest/gtest.h>
+#include <pbbam/BamRecordPool.h>
+#include <pbbam/QNameQuery.h>
+#include <set>
+#include <string>
+#include <vector>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace tests {
+
+static inline
+const bam1_t* RawData(const BamRecord& record)
+{ return record.impl_.d_.get(); }
+
+} // namespace tests
+} // namespace BAM
+} // namespace PacBio
+
+TEST(BamRecordPoolTest, AcquireFromEmptyPool)
+{
+    BamRecordPool pool;
+    EXPECT_EQ(0, pool.Size());
+    EXPECT_EQ(256, pool.MaxSize());
+
+    const BamRecord record = pool.Acquire();
+    EXPECT_TRUE(tests::RawData(record) != nullptr);
+    EXPECT_EQ(0, pool.Size());
+}
+
+TEST(BamRecordPoolTest, ReleasedRecordsAreReused)
+{
+    BamRecordPool pool;
+    BamRecord record = pool.Acquire();
+    record.Impl().Name("a_fairly_long_name/12345/0_100");
+    const bam1_t* raw = tests::RawData(record);
+
+    pool.Release(std::move(record));
+    EXPECT_EQ(1, pool.Size());
+
+    const BamRecord reused = pool.Acquire();
+    EXPECT_EQ(raw, tests::RawData(reused));
+    EXPECT_EQ(0, pool.Size());
+}
+
+TEST(BamRecordPoolTest, ReleaseContainer)
+{
+    BamRecordPool pool;
+    vector<BamRecord> records(3);
+    records.reserve(10);
+    set<const bam1_t*> raw;
+    for (const BamRecord& r : records)
+        raw.insert(tests::RawData(r));
+
+    pool.Release(records);
+    EXPECT_TRUE(records.empty());
+    EXPECT_EQ(10, records.capacity());
+    EXPECT_EQ(3, pool.Size());
+
+    for (int i = 0; i < 3; ++i)
+        EXPECT_EQ(1, raw.count(tests::RawData(pool.Acquire())));
+    EXPECT_EQ(0, pool.Size());
+}
+
+TEST(BamRecordPoolTest, DiscardsMovedFromSharedAndExcessRecords)
+{
+    BamRecordPool pool(2);
+
+    BamRecord record;
+    BamRecord other(std::move(record));
+    pool.Release(std::move(record)); // moved-from: no data buffer to reuse
+    EXPECT_EQ(0, pool.Size());
+
+    BamRecord shared;
+    const BamRecord copy(shared);
+    pool.Release(std::move(shared)); // buffer still in use by 'copy'
+    EXPECT_EQ(0, pool.Size());
+
+    pool.Release(std::move(other));
+    pool.Release(BamRecord());
+    pool.Release(BamRecord());
+    EXPECT_EQ(2, pool.Size());
+
+    pool.Clear();
+    EXPECT_EQ(0, pool.Size());
+}
+
+TEST(BamRecordPoolTest, GroupQueryRecyclesRecords)
+{
+    // 14 records, in 11 QNAME groups of 1 or 2 records
+    const string fn = tests::Data_Dir + "/group/test3.bam";
+
+    size_t numRecords = 0;
+    set<const bam1_t*> buffers;
+
+    QNameQuery query(fn);
+    vector<BamRecord> records;
+    while (query.GetNext(records)) {
+        for (const BamRecord& r : records) {
+            ++numRecords;
+            buffers.insert(tests::RawData(r));
+        }
+    }
+    EXPECT_EQ(14, numRecords);
+
+    // only a handful of buffers (group size + reader look-ahead) ever in use
+    EXPECT_LT(buffers.size(), numRecords);
+}
@@ -45,10 +45,30 @@
 #include <pbbam/BamRecord.h>
 #include <pbbam/BamWriter.h>
 #include <pbbam/EntireFileQuery.h>
+#include <pbbam/PbiRawData.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
 using namespace PacBio;
 using namespace PacBio::BAM;
 using namespace std;
 
+namespace PacBio {
+namespace BAM {
+namespace tests {
+
+static
+string FileContents(const string& fn)
+{
+    ifstream in(fn, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+} // namespace tests
+} // namespace BAM
+} // namespace PacBio
+
 TEST(BamWriterTest, SingleWrite_UserRecord)
 {
     const string fullName = "test/100/0_5";
@@ -125,3 +145,80 @@ TEST(BamWriterTest, SingleWrite_UserRecord)
     // clean up
     remove(generatedBamFn.c_str());
 }
+
+TEST(BamWriterTest, IndexesCreatedDuringWrite)
+{
+    const string inputBamFn     = tests::Data_Dir + "/aligned2.bam";
+    const string generatedBamFn = "/tmp/bamwriter_indexed.bam";
+    const string generatedPbiFn = generatedBamFn + ".pbi";
+    const string generatedBaiFn = generatedBamFn + ".bai";
+
+    // copy coordinate-sorted input, generating indices on the fly
+    size_t numRecords = 0;
+    {
+        const BamFile inputFile(inputBamFn);
+        BamWriter writer(generatedBamFn,
+                         inputFile.Header(),
+                         BamWriter::DefaultCompression,
+                         4,
+                         BamWriter::BinCalculation_ON,
+                         BamWriter::PacBioIndex | BamWriter::StandardIndex);
+        EntireFileQuery entireFile(inputFile);
+        for (const BamRecord& r : entireFile) {
+            writer.Write(r);
+            ++numRecords;
+        }
+    }
+
+    const string onTheFlyBai = tests::FileContents(generatedBaiFn);
+    const PbiRawData onTheFlyPbi(generatedPbiFn);
+    EXPECT_FALSE(onTheFlyBai.empty());
+
+    // compare against indices built by re-reading the output file
+    const BamFile generatedFile(generatedBamFn);
+    generatedFile.CreateStandardIndex();
+    generatedFile.CreatePacBioIndex();
+
+    EXPECT_EQ(tests::FileContents(generatedBaiFn), onTheFlyBai);
+
+    const PbiRawData expectedPbi(generatedPbiFn);
+    EXPECT_EQ(numRecords, onTheFlyPbi.NumReads());
+    EXPECT_EQ(expectedPbi.NumReads(), onTheFlyPbi.NumReads());
+    EXPECT_EQ(expectedPbi.FileSections(), onTheFlyPbi.FileSections());
+    EXPECT_EQ(expectedPbi.BasicData().fileOffset_, onTheFlyPbi.BasicData().fileOffset_);
+    EXPECT_EQ(expectedPbi.BasicData().holeNumber_, onTheFlyPbi.BasicData().holeNumber_);
+    EXPECT_EQ(expectedPbi.MappedData().tStart_,    onTheFlyPbi.MappedData().tStart_);
+
+    remove(generatedBamFn.c_str());
+    remove(generatedPbiFn.c_str());
+    remove(generatedBaiFn.c_str());
+}
+
+TEST(BamWriterTest, StandardIndexRequiresSortedRecords)
+{
+    const string generatedBamFn = "/tmp/bamwriter_unsorted.bam";
+
+    const BamFile inputFile(tests::Data_Dir + "/aligned2.bam");
+    vector<BamRecord> records;
+    EntireFileQuery entireFile(inputFile);
+    for (const BamRecord& r : entireFile)
+        records.push_back(r);
+    std::reverse(records.begin(), records.end());
+
+    EXPECT_THROW(
+    {
+        BamWriter writer(generatedBamFn,
+                         inputFile.Header(),
+                         BamWriter::DefaultCompression,
+                         4,
+                         BamWriter::BinCalculation_ON,
+                         BamWriter::StandardIndex);
+        for (const BamRecord& r : records)
+            writer.Write(r);
+    },
+    std::runtime_error);
+
+    remove(generatedBamFn.c_str());
+    remove((generatedBamFn + ".tmp").c_str());
+    remove((generatedBamFn + ".tmp.bai").c_str());
+}
@@ -197,10 +197,10 @@ TEST(CompareTest, FromOperatorOk)
 
 TEST(CompareTest, AlignedEndOk)
 {
-    BamRecord r1; r1.alignedEnd_ = 300;
-    BamRecord r2; r2.alignedEnd_ = 200;
-    BamRecord r3; r3.alignedEnd_ = 400;
-    BamRecord r4; r4.alignedEnd_ = 100;
+    BamRecord r1; r1.alignedEnd_ = 300; r1.alignedPositionsState_.SetValid();
+    BamRecord r2; r2.alignedEnd_ = 200; r2.alignedPositionsState_.SetValid();
+    BamRecord r3; r3.alignedEnd_ = 400; r3.alignedPositionsState_.SetValid();
+    BamRecord r4; r4.alignedEnd_ = 100; r4.alignedPositionsState_.SetValid();
 
     auto records = vector<BamRecord>{ r1, r2, r3, r4 };
     std::sort(records.begin(), records.end(), Compare::AlignedEnd());
@@ -213,10 +213,10 @@ TEST(CompareTest, AlignedEndOk)
 
 TEST(CompareTest, AlignedStartOk)
 {
-    BamRecord r1; r1.alignedStart_ = 300;
-    BamRecord r2; r2.alignedStart_ = 200;
-    BamRecord r3; r3.alignedStart_ = 400;
-    BamRecord r4; r4.alignedStart_ = 100;
+    BamRecord r1; r1.alignedStart_ = 300; r1.alignedPositionsState_.SetValid();
+    BamRecord r2; r2.alignedStart_ = 200; r2.alignedPositionsState_.SetValid();
+    BamRecord r3; r3.alignedStart_ = 400; r3.alignedPositionsState_.SetValid();
+    BamRecord r4; r4.alignedStart_ = 100; r4.alignedPositionsState_.SetValid();
 
     auto records = vector<BamRecord>{ r1, r2, r3, r4 };
     std::sort(records.begin(), records.end(), Compare::AlignedStart());
@@ -35,6 +35,10 @@
 
 // Author: Derek Barnett
 
+#ifdef PBBAM_TESTING
+#define private public
+#endif
+
 #include "TestData.h"
 #include <boost/any.hpp>
 #include <gtest/gtest.h>
@@ -430,6 +434,23 @@ TEST(DataSetQueryTest, ZmwQueryTest)
     });
 }
 
+TEST(DataSetQueryTest, ZmwGroupQueryMakesNoDeepCopies)
+{
+    const std::vector<int32_t> whitelist = { 13473, 30983 };
+
+    BamFile bamFile(aligned2BamFn);
+    ASSERT_TRUE(bamFile.PacBioIndexExists());
+    DataSet dataset(bamFile);
+
+    const auto copiesBefore = BamRecordImpl::numDeepCopies_.load();
+    size_t count = 0;
+    ZmwGroupQuery query(whitelist, dataset);
+    for (vector<BamRecord>& group : query)
+        count += group.size();
+    EXPECT_EQ(4, count);
+    EXPECT_EQ(copiesBefore, BamRecordImpl::numDeepCopies_.load());
+}
+
 TEST(DataSetQueryTest, ZmwGroupQueryTest)
 {
     const std::vector<int32_t> whitelist = { 13473, 30983 };
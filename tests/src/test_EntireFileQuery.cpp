@@ -82,6 +82,25 @@ TEST(EntireFileQueryTest, NonConstBamRecord)
     });
 }
 
+TEST(EntireFileQueryTest, CopiesSurviveReadingNextRecord)
+{
+    // copies share data with the query's record until either is modified;
+    // reading the next record must not change previously taken copies
+    BamFile bamFile(inputBamFn);
+    EntireFileQuery entireFile(bamFile);
+
+    vector<BamRecord> copies;
+    vector<string> names;
+    for (const BamRecord& record : entireFile) {
+        copies.push_back(record);
+        names.push_back(record.FullName());
+    }
+
+    ASSERT_EQ(4, copies.size());
+    for (size_t i = 0; i < copies.size(); ++i)
+        EXPECT_EQ(names.at(i), copies.at(i).FullName());
+}
+
 TEST(BamRecordTest, HandlesDeletionOK)
 {
     // this file raised no error in Debug mode, but segfaulted when
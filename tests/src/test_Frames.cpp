@@ -41,7 +41,10 @@
 
 #include <gtest/gtest.h>
 #include <pbbam/Frames.h>
+#include <cmath>
+#include <cstdint>
 #include <string>
+#include <thread>
 #include <vector>
 using namespace PacBio;
 using namespace PacBio::BAM;
@@ -77,6 +80,38 @@ static const vector<uint8_t> encodedFrames =
     255, 254,  255
 };
 
+// Reference tables, built as in kineticsTools/_downsampling.py. The codec
+// computes these values directly; compare against the original construction.
+static void MakeReferenceTables(vector<uint16_t>* framepoints,
+                                vector<uint8_t>* frameToCode)
+{
+    const int T = 64;
+    int next = 0;
+    for (int i = 0; i < 4; ++i) {
+        const int grain = static_cast<int>(pow(2, i));
+        for (int j = 0; j < T; ++j)
+            framepoints->push_back(j*grain + next);
+        next = framepoints->back() + grain;
+    }
+
+    frameToCode->assign(framepoints->back()+1, 0);
+    int i = 0;
+    uint16_t fu = 0;
+    for (; i < static_cast<int>(framepoints->size()) - 1; ++i) {
+        const uint16_t fl = (*framepoints)[i];
+        fu = (*framepoints)[i+1];
+        if (fu > fl+1) {
+            const int middle = (fl+fu)/2;
+            for (int f = fl; f < middle; ++f)
+                (*frameToCode)[f] = i;
+            for (int f = middle; f < fu; ++f)
+                (*frameToCode)[f] = i+1;
+        } else
+            (*frameToCode)[fl] = i;
+    }
+    (*frameToCode)[fu] = i;
+}
+
 } // namespace tests
 
 TEST(FramesTest, Constructors)
@@ -95,3 +130,56 @@ TEST(FramesTest, Encoded)
     const auto e = f.Encode();
     ASSERT_EQ(tests::encodedFrames, e);
 }
+
+TEST(FramesTest, CodecMatchesReferenceTables)
+{
+    vector<uint16_t> framepoints;
+    vector<uint8_t> frameToCode;
+    tests::MakeReferenceTables(&framepoints, &frameToCode);
+    ASSERT_EQ(256, framepoints.size());
+
+    // every code
+    vector<uint8_t> allCodes(256);
+    for (size_t i = 0; i < allCodes.size(); ++i)
+        allCodes[i] = static_cast<uint8_t>(i);
+    EXPECT_EQ(framepoints, Frames::Decode(allCodes).Data());
+
+    // every frame value (odd length, to exercise any non-vector tail)
+    vector<uint16_t> allFrames(UINT16_MAX);
+    vector<uint8_t> expectedCodes(UINT16_MAX);
+    for (size_t i = 0; i < allFrames.size(); ++i) {
+        allFrames[i] = static_cast<uint16_t>(i);
+        expectedCodes[i] = frameToCode[std::min<size_t>(i, frameToCode.size()-1)];
+    }
+    EXPECT_EQ(expectedCodes, Frames::Encode(allFrames));
+    EXPECT_EQ(255, Frames::Encode(vector<uint16_t>(1, UINT16_MAX)).at(0));
+
+    // short inputs
+    for (size_t len = 0; len < 40; ++len) {
+        const vector<uint8_t> codes(allCodes.cbegin() + 100, allCodes.cbegin() + 100 + len);
+        const vector<uint16_t> expected(framepoints.cbegin() + 100, framepoints.cbegin() + 100 + len);
+        EXPECT_EQ(expected, Frames::Decode(codes).Data());
+        EXPECT_EQ(codes, Frames::Encode(expected));
+    }
+}
+
+TEST(FramesTest, ConcurrentEncodeDecode)
+{
+    const size_t numThreads = 8;
+    vector<int> ok(numThreads, 0);
+    vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&ok, t]() {
+            bool good = true;
+            for (int i = 0; i < 200; ++i) {
+                good &= (tests::encodedFrames == Frames::Encode(tests::testFrames));
+                const auto decoded = Frames::Decode(tests::encodedFrames).Data();
+                good &= (tests::encodedFrames == Frames::Encode(decoded));
+            }
+            ok[t] = good ? 1 : 0;
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(vector<int>(numThreads, 1), ok);
+}
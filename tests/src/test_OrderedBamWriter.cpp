@@ -0,0 +1,188 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// Author: Derek Barnett
+
+#ifdef PBBAM_TESTING
+#define private public
+#endif
+
+#include "TestData.h"
+#include <gtest/gtest.h>
+#include <pbbam/BamFile.h>
+#include <pbbam/BamRecord.h>
+#include <pbbam/EntireFileQuery.h>
+#include <pbbam/OrderedBamWriter.h>
+#include <pbbam/PbiRawData.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace tests {
+
+static
+vector<BamRecord> LoadRecords(const string& fn)
+{
+    vector<BamRecord> result;
+    EntireFileQuery query(fn);
+    for (const BamRecord& record : query)
+        result.push_back(record);
+    return result;
+}
+
+static
+vector<string> RecordNames(const vector<BamRecord>& records)
+{
+    vector<string> result;
+    result.reserve(records.size());
+    for (const BamRecord& record : records)
+        result.push_back(record.FullName());
+    return result;
+}
+
+} // namespace tests
+} // namespace BAM
+} // namespace PacBio
+
+TEST(OrderedBamWriterTest, ParallelProducersGiveDeterministicOrder)
+{
+    const string inputFn  = tests::Data_Dir + "/aligned2.bam";
+    const string outputFn = "/tmp/ordered_writer.bam";
+    const BamFile inputFile(inputFn);
+    const vector<BamRecord> input = tests::LoadRecords(inputFn);
+    ASSERT_FALSE(input.empty());
+
+    // each producer takes every Nth record, in a window smaller than the input
+    const size_t numProducers = 4;
+    {
+        OrderedBamWriter writer(outputFn,
+                                inputFile.Header(),
+                                2,
+                                BamWriter::DefaultCompression,
+                                4,
+                                BamWriter::BinCalculation_ON,
+                                BamWriter::PacBioIndex);
+        vector<thread> producers;
+        for (size_t p = 0; p < numProducers; ++p) {
+            producers.emplace_back([&, p]() {
+                for (size_t i = p; i < input.size(); i += numProducers)
+                    writer.Write(i, input.at(i));
+            });
+        }
+        for (thread& t : producers)
+            t.join();
+        writer.Close();
+    }
+
+    const vector<BamRecord> output = tests::LoadRecords(outputFn);
+    EXPECT_EQ(tests::RecordNames(input), tests::RecordNames(output));
+
+    // PBI reflects final order
+    const PbiRawData index(outputFn + ".pbi");
+    ASSERT_EQ(output.size(), index.NumReads());
+    for (size_t i = 0; i < output.size(); ++i)
+        EXPECT_EQ(output.at(i).HoleNumber(), index.BasicData().holeNumber_.at(i));
+
+    remove(outputFn.c_str());
+    remove((outputFn + ".pbi").c_str());
+}
+
+TEST(OrderedBamWriterTest, GroupedAndEmptySubmissions)
+{
+    const string inputFn  = tests::Data_Dir + "/aligned2.bam";
+    const string outputFn = "/tmp/ordered_writer_grouped.bam";
+    const BamFile inputFile(inputFn);
+    const vector<BamRecord> input = tests::LoadRecords(inputFn);
+    ASSERT_GE(input.size(), 2);
+
+    // submitted in reverse: [records 1..N), empty, [record 0]
+    {
+        OrderedBamWriter writer(outputFn, inputFile.Header());
+        writer.Write(2, vector<BamRecord>(input.begin() + 1, input.end()));
+        writer.Write(1, vector<BamRecord>());
+        writer.Write(0, BamRecord(input.front()));
+        writer.Close();
+    }
+
+    EXPECT_EQ(tests::RecordNames(input),
+              tests::RecordNames(tests::LoadRecords(outputFn)));
+    remove(outputFn.c_str());
+}
+
+TEST(OrderedBamWriterTest, ThrowsOnDuplicateSequenceNumber)
+{
+    const string inputFn  = tests::Data_Dir + "/aligned2.bam";
+    const string outputFn = "/tmp/ordered_writer_duplicate.bam";
+    const BamFile inputFile(inputFn);
+    const vector<BamRecord> input = tests::LoadRecords(inputFn);
+
+    OrderedBamWriter writer(outputFn, inputFile.Header());
+    writer.Write(1, input.front());
+    EXPECT_THROW(writer.Write(1, input.front()), std::runtime_error);
+    writer.Write(0, input.front());
+    writer.Close();
+    EXPECT_THROW(writer.Write(0, input.front()), std::runtime_error);
+
+    remove(outputFn.c_str());
+}
+
+TEST(OrderedBamWriterTest, CloseThrowsOnMissingSequenceNumber)
+{
+    const string inputFn  = tests::Data_Dir + "/aligned2.bam";
+    const string outputFn = "/tmp/ordered_writer_missing.bam";
+    const BamFile inputFile(inputFn);
+    const vector<BamRecord> input = tests::LoadRecords(inputFn);
+
+    {
+        OrderedBamWriter writer(outputFn, inputFile.Header());
+        writer.Write(0, input.front());
+        writer.Write(2, input.front());
+        EXPECT_THROW(writer.Close(), std::runtime_error);
+    }
+
+    // incomplete output is never renamed to requested filename
+    FILE* f = fopen(outputFn.c_str(), "rb");
+    EXPECT_TRUE(f == nullptr);
+    if (f)
+        fclose(f);
+    remove((outputFn + ".tmp").c_str());
+}
@@ -375,6 +375,27 @@ TEST(PacBioIndexTest, RawLoadFromPbiFile)
     tests::ExpectRawIndicesEqual(expectedIndex, loadedIndex);
 }
 
+TEST(PacBioIndexTest, CollateRowsFromExistingIndex)
+{
+    const string tempPbiFn = "/tmp/collated.bam.pbi";
+    const BamFile bamFile(test2BamFn);
+    const PbiRawData sourceIndex(bamFile.PacBioIndexFilename());
+    const PbiRawData& expectedIndex = tests::Test2Bam_NewIndex();
+
+    // copy rows, substituting new offsets
+    {
+        PbiBuilder builder(tempPbiFn, bamFile.Header().NumSequences(), true);
+        const auto& newOffsets = expectedIndex.BasicData().fileOffset_;
+        for (uint32_t i = 0; i < sourceIndex.NumReads(); ++i)
+            builder.AddRow(sourceIndex, i, newOffsets.at(i));
+    }
+
+    const PbiRawData collatedIndex(tempPbiFn);
+    tests::ExpectRawIndicesEqual(expectedIndex, collatedIndex);
+
+    remove(tempPbiFn.c_str());
+}
+
 TEST(PacBioIndexTest, BasicAndBarodeSectionsOnly)
 {
     // do this in temp directory, so we can ensure write access
@@ -0,0 +1,201 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// File Description
+/// \file test_PerBaseColumns.cpp
+/// \brief Tests for the PerBaseColumns class.
+//
+// Author: Derek Barnett
+
+#ifdef PBBAM_TESTING
+#define private public
+#endif
+
+#include <gtest/gtest.h>
+#include <pbbam/PerBaseColumns.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace tests {
+
+// records of varying length & strand, alternating lossy & lossless frames;
+// every 7th record lacks its pulse widths & deletion QVs
+static
+vector<BamRecord> MakeKineticsRecords(const size_t numRecords)
+{
+    vector<BamRecord> records;
+    records.reserve(numRecords);
+    for (size_t i = 0; i < numRecords; ++i) {
+        const size_t length = 1 + (i % 50);
+        string seq(length, 'A');
+        string quals(length, '!');
+        vector<uint16_t> frames(length);
+        for (size_t j = 0; j < length; ++j) {
+            quals[j] = static_cast<char>('!' + ((i + j) % 40));
+            frames[j] = static_cast<uint16_t>((i * 31 + j * 17) % 1000);
+        }
+
+        BamRecordImpl impl;
+        impl.SetSequenceAndQualities(seq, quals);
+        impl.SetMapped(true);
+        impl.SetReverseStrand(i % 3 == 0);
+
+        BamRecord record(std::move(impl));
+        const FrameEncodingType encoding = (i % 2 == 0) ? FrameEncodingType::LOSSY
+                                                        : FrameEncodingType::LOSSLESS;
+        record.IPD(Frames{ frames }, encoding);
+        if (i % 7 != 0) {
+            record.PulseWidth(Frames{ frames }, encoding);
+            record.DeletionQV(QualityValues::FromFastq(quals));
+        }
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+static
+void CheckColumns(const PerBaseColumns& columns,
+                  const vector<BamRecord>& records,
+                  const Orientation orientation)
+{
+    ASSERT_EQ(records.size(), columns.NumRecords());
+    const auto& ipd = columns.FrameData(PerBaseField::IPD);
+    const auto& pw  = columns.FrameData(PerBaseField::PULSE_WIDTH);
+    const auto& dq  = columns.QualityData(PerBaseField::DELETION_QV);
+    const auto& qv  = columns.QualityData(PerBaseField::QUALITIES);
+    const auto& ipdOffsets = columns.Offsets(PerBaseField::IPD);
+    const auto& pwOffsets  = columns.Offsets(PerBaseField::PULSE_WIDTH);
+    const auto& dqOffsets  = columns.Offsets(PerBaseField::DELETION_QV);
+    const auto& qvOffsets  = columns.Offsets(PerBaseField::QUALITIES);
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        const BamRecord& record = records.at(i);
+        // missing fields have empty ranges
+        const vector<uint16_t> expectedIpd = record.IPD(orientation).Data();
+        const vector<uint16_t> expectedPw  = record.HasPulseWidth() ? record.PulseWidth(orientation).Data()
+                                                                    : vector<uint16_t>();
+        const QualityValues expectedDq = record.HasDeletionQV() ? record.DeletionQV(orientation)
+                                                                : QualityValues();
+        const QualityValues expectedQv = record.Qualities(orientation);
+
+        EXPECT_EQ(expectedIpd, vector<uint16_t>(ipd.begin() + ipdOffsets.at(i),
+                                                ipd.begin() + ipdOffsets.at(i+1)));
+        EXPECT_EQ(expectedPw,  vector<uint16_t>(pw.begin() + pwOffsets.at(i),
+                                                pw.begin() + pwOffsets.at(i+1)));
+        EXPECT_EQ(expectedDq.Fastq(),
+                  QualityValues(dq.data() + dqOffsets.at(i),
+                                dqOffsets.at(i+1) - dqOffsets.at(i)).Fastq());
+        EXPECT_EQ(expectedQv.Fastq(),
+                  QualityValues(qv.data() + qvOffsets.at(i),
+                                qvOffsets.at(i+1) - qvOffsets.at(i)).Fastq());
+    }
+}
+
+} // namespace tests
+} // namespace BAM
+} // namespace PacBio
+
+TEST(PerBaseColumnsTest, MatchesPerRecordAccessors)
+{
+    const vector<PerBaseField> fields = { PerBaseField::IPD,
+                                          PerBaseField::PULSE_WIDTH,
+                                          PerBaseField::DELETION_QV,
+                                          PerBaseField::QUALITIES };
+    const vector<BamRecord> records = tests::MakeKineticsRecords(5000);
+
+    for (const Orientation orientation : { Orientation::NATIVE, Orientation::GENOMIC }) {
+        for (const size_t numThreads : { 1, 4 }) {
+            PerBaseColumns columns(fields, orientation, numThreads);
+            columns.Append(records);
+            tests::CheckColumns(columns, records, orientation);
+        }
+    }
+}
+
+TEST(PerBaseColumnsTest, AppendsBatchesAndReusesStorage)
+{
+    const vector<BamRecord> records = tests::MakeKineticsRecords(1000);
+    const vector<BamRecord> firstHalf(records.begin(), records.begin() + 500);
+    const vector<BamRecord> secondHalf(records.begin() + 500, records.end());
+
+    PerBaseColumns columns({ PerBaseField::IPD,
+                             PerBaseField::PULSE_WIDTH,
+                             PerBaseField::DELETION_QV,
+                             PerBaseField::QUALITIES });
+    EXPECT_EQ(0, columns.NumRecords());
+    EXPECT_EQ(vector<size_t>(1, 0), columns.Offsets(PerBaseField::IPD));
+
+    columns.Append(firstHalf);
+    columns.Append(secondHalf);
+    tests::CheckColumns(columns, records, Orientation::NATIVE);
+
+    // any range of records, in batches
+    columns.Clear();
+    EXPECT_EQ(0, columns.NumRecords());
+    EXPECT_EQ(1000, columns.AppendQuery(records, 300));
+    tests::CheckColumns(columns, records, Orientation::NATIVE);
+
+    // refill keeps existing storage
+    const uint16_t* ipdData = columns.FrameData(PerBaseField::IPD).data();
+    columns.Clear();
+    columns.Append(records);
+    EXPECT_EQ(ipdData, columns.FrameData(PerBaseField::IPD).data());
+}
+
+TEST(PerBaseColumnsTest, InvalidRequestsThrow)
+{
+    EXPECT_THROW(PerBaseColumns(vector<PerBaseField>()), std::runtime_error);
+    EXPECT_THROW(PerBaseColumns({ PerBaseField::IPD, PerBaseField::IPD }), std::runtime_error);
+
+    PerBaseColumns columns({ PerBaseField::IPD, PerBaseField::MERGE_QV });
+    EXPECT_TRUE(columns.HasField(PerBaseField::MERGE_QV));
+    EXPECT_FALSE(columns.HasField(PerBaseField::PULSE_WIDTH));
+    EXPECT_THROW(columns.Offsets(PerBaseField::PULSE_WIDTH), std::runtime_error);
+    EXPECT_THROW(columns.QualityData(PerBaseField::IPD), std::runtime_error);
+    EXPECT_THROW(columns.FrameData(PerBaseField::MERGE_QV), std::runtime_error);
+
+    // bad tag type: nothing appended
+    vector<BamRecord> records = tests::MakeKineticsRecords(10);
+    records.at(5).Impl().EditTag("ip", string("not frames"));
+    EXPECT_THROW(columns.Append(records), std::runtime_error);
+    EXPECT_EQ(0, columns.NumRecords());
+    EXPECT_TRUE(columns.FrameData(PerBaseField::IPD).empty());
+}
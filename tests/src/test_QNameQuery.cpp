@@ -35,10 +35,16 @@
 
 // Author: Yuan Li
 
+#ifdef PBBAM_TESTING
+#define private public
+#endif
+
 #include "TestData.h"
 #include <gtest/gtest.h>
 #include <pbbam/QNameQuery.h>
 #include <string>
+#include <type_traits>
+#include <utility>
 using namespace PacBio;
 using namespace PacBio::BAM;
 using namespace std;
@@ -94,3 +100,22 @@ TEST(QNameQueryTest, CountQSizes)
     TestNoneConstQNameQuery(fn, expected);
 }
 
+TEST(QNameQueryTest, GroupIterationMakesNoDeepCopies)
+{
+    // records must move (not copy) when a group buffer grows
+    EXPECT_TRUE(std::is_nothrow_move_constructible<BamRecord>::value);
+    EXPECT_TRUE(std::is_nothrow_move_assignable<BamRecord>::value);
+
+    const auto copiesBefore = BamRecordImpl::numDeepCopies_.load();
+
+    size_t numRecords = 0;
+    vector<vector<BamRecord> > groups;
+    QNameQuery qQuery(test3fn);
+    for (vector<BamRecord>& records : qQuery) {
+        numRecords += records.size();
+        groups.push_back(std::move(records)); // take ownership of the group
+    }
+    EXPECT_EQ(14, numRecords);
+    EXPECT_EQ(11, groups.size());
+    EXPECT_EQ(copiesBefore, BamRecordImpl::numDeepCopies_.load());
+}
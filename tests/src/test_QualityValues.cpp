@@ -41,6 +41,9 @@
 
 #include <gtest/gtest.h>
 #include <pbbam/QualityValues.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 using namespace PacBio;
 using namespace PacBio::BAM;
 using namespace std;
@@ -118,3 +121,47 @@ TEST(QualityValuesTest, FromFastq)
     for (size_t i = 0; i < fastqString.size(); ++i)
         EXPECT_EQ(values.at(i), qvs.at(i));
 }
+
+TEST(QualityValuesTest, BulkConversionsMatchPerValue)
+{
+    // every byte value, at lengths covering both full blocks & remainders
+    string allChars(256, '\0');
+    vector<uint8_t> allValues(256);
+    for (size_t i = 0; i < 256; ++i) {
+        allChars[i] = static_cast<char>(i);
+        allValues[i] = static_cast<uint8_t>(i);
+    }
+
+    for (size_t length = 0; length <= 256; ++length) {
+        const string fastq = allChars.substr(256 - length);
+        const QualityValues qvs = QualityValues::FromFastq(fastq.data(), fastq.size());
+        ASSERT_EQ(length, qvs.size());
+        for (size_t i = 0; i < length; ++i)
+            EXPECT_EQ(QualityValue::FromFastq(fastq.at(i)), qvs.at(i));
+
+        const QualityValues fromNumbers(allValues.data() + 256 - length, length);
+        ASSERT_EQ(length, fromNumbers.size());
+        string expectedFastq;
+        for (size_t i = 0; i < length; ++i) {
+            EXPECT_EQ(QualityValue(allValues.at(256 - length + i)), fromNumbers.at(i));
+            expectedFastq.push_back(fromNumbers.at(i).Fastq());
+        }
+        EXPECT_EQ(expectedFastq, fromNumbers.Fastq());
+        EXPECT_EQ(fromNumbers, QualityValues::FromFastq(fromNumbers.Fastq()));
+    }
+}
+
+TEST(QualityValuesTest, Reverse)
+{
+    for (size_t length = 0; length <= 100; ++length) {
+        vector<uint8_t> values(length);
+        for (size_t i = 0; i < length; ++i)
+            values[i] = static_cast<uint8_t>(i % (QualityValue::MAX + 1));
+
+        QualityValues qvs(values);
+        qvs.Reverse();
+        std::reverse(values.begin(), values.end());
+        EXPECT_EQ(QualityValues(values), qvs);
+        EXPECT_TRUE(std::equal(values.cbegin(), values.cend(), qvs.RawData()));
+    }
+}
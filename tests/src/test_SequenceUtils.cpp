@@ -41,6 +41,10 @@
 
 #include <gtest/gtest.h>
 #include <pbbam/../../src/SequenceUtils.h>
+#include <htslib/sam.h>
+#include <chrono>
+#include <iostream>
+#include <random>
 #include <string>
 #include <vector>
 #include <climits>
@@ -115,3 +119,135 @@ TEST(SequenceUtilsTest, ReverseComplement)
     ReverseComplement(input1);
     EXPECT_EQ(rc1, input1);
 }
+
+namespace tests {
+
+// reference implementations (per-character, as originally written)
+
+static string ReferenceReverseComplement(const string& input)
+{
+    string result(input.rbegin(), input.rend());
+    for (char& c : result)
+        c = Complement(c);
+    return result;
+}
+
+static string ReferenceReverseComplementCaseSens(const string& input)
+{
+    const string from = "ACGTUacgtuN -";
+    const string to   = "TGCAAtgcaaN -";
+    string result(input.rbegin(), input.rend());
+    for (char& c : result) {
+        const size_t pos = from.find(c);
+        c = (pos == string::npos ? 4 : to.at(pos));
+    }
+    return result;
+}
+
+static string RandomSequence(const size_t length,
+                             const string& alphabet,
+                             std::mt19937* gen)
+{
+    std::uniform_int_distribution<size_t> dist(0, alphabet.size()-1);
+    string result(length, '\0');
+    for (char& c : result)
+        c = alphabet.at(dist(*gen));
+    return result;
+}
+
+static const SequenceKernelLevel kernelLevels[] = {
+    SequenceKernelLevel::SCALAR,
+    SequenceKernelLevel::SSSE3
+};
+
+} // namespace tests
+
+TEST(SequenceUtilsTest, ReverseComplementCaseSens)
+{
+    string input = "ATatCCN-gg u";
+    ReverseComplementCaseSens(input);
+    EXPECT_EQ(string("a cc-NGGatAT"), input);
+}
+
+TEST(SequenceUtilsTest, SequenceKernelsMatchReference)
+{
+    std::mt19937 gen(42);
+    const string bases = "ACGTACGTACGTNacgtn";
+    const string mixed = "ACGTNacgtnMRWSYKVHDBU=-* .x0123";
+    const string nt16 = "=ACMGRSVTWYHKDBN";
+
+    for (const string& alphabet : { bases, mixed }) {
+        for (size_t length = 0; length < 200; ++length) {
+            const string seq = tests::RandomSequence(length, alphabet, &gen);
+            const string expectedRc = tests::ReferenceReverseComplement(seq);
+            const string expectedRcCaseSens = tests::ReferenceReverseComplementCaseSens(seq);
+
+            for (const SequenceKernelLevel level : tests::kernelLevels) {
+                string rc = seq;
+                ReverseComplement(&rc[0], rc.size(), level);
+                EXPECT_EQ(expectedRc, rc);
+
+                string rcCaseSens = seq;
+                ReverseComplementCaseSens(&rcCaseSens[0], rcCaseSens.size(), level);
+                EXPECT_EQ(expectedRcCaseSens, rcCaseSens);
+
+                // encode (each base through the BAM nt16 table) & decode back
+                vector<uint8_t> encoded((length+1)/2, 0xAB);
+                EncodeSequence(seq.data(), seq.size(), encoded.data(), level);
+                vector<uint8_t> expectedEncoded((length+1)/2, 0);
+                for (size_t i = 0; i < length; ++i)
+                    expectedEncoded[i/2] |= seq_nt16_table[static_cast<uint8_t>(seq[i])] << ((~i&1)<<2);
+                EXPECT_EQ(expectedEncoded, encoded);
+
+                string decoded(length, '\0');
+                DecodeSequence(encoded.data(), length, &decoded[0], level);
+                string expectedDecoded(length, '\0');
+                for (size_t i = 0; i < length; ++i)
+                    expectedDecoded[i] = nt16.at(bam_seqi(encoded.data(), i));
+                EXPECT_EQ(expectedDecoded, decoded);
+            }
+        }
+    }
+}
+
+TEST(SequenceUtilsTest, SequenceKernelsTimings)
+{
+    // multi-kb reads, as seen from FetchBases() on reverse-strand records
+    std::mt19937 gen(7);
+    const size_t readLength = 20000;
+    const size_t numReads = 200;
+    const string read = tests::RandomSequence(readLength, "ACGT", &gen);
+
+    auto report = [](const char* kernel,
+                     const SequenceKernelLevel level,
+                     const std::chrono::steady_clock::time_point start)
+    {
+        const auto end = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        std::cerr << kernel << " ("
+                  << (level == SequenceKernelLevel::SCALAR ? "scalar" : "ssse3")
+                  << (level == BestSequenceKernelLevel() ? ", best" : "")
+                  << "): " << ns / (numReads * readLength) << " ns/base" << std::endl;
+    };
+
+    for (const SequenceKernelLevel level : tests::kernelLevels) {
+        vector<uint8_t> encoded((readLength+1)/2);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numReads; ++i)
+            EncodeSequence(read.data(), read.size(), encoded.data(), level);
+        report("EncodeSequence", level, start);
+
+        string decoded(readLength, '\0');
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numReads; ++i)
+            DecodeSequence(encoded.data(), readLength, &decoded[0], level);
+        report("DecodeSequence", level, start);
+        EXPECT_EQ(read, decoded);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numReads; ++i)
+            ReverseComplement(&decoded[0], decoded.size(), level);
+        report("ReverseComplement", level, start);
+        EXPECT_EQ(read, decoded); // even number of round trips
+    }
+}
@@ -0,0 +1,193 @@
+// Copyright (c) 2015, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// Author: Derek Barnett
+
+#ifdef PBBAM_TESTING
+#define private public
+#endif
+
+#include "TestData.h"
+#include <gtest/gtest.h>
+#include <pbbam/BamFile.h>
+#include <pbbam/BamRecord.h>
+#include <pbbam/EntireFileQuery.h>
+#include <pbbam/PbiRawData.h>
+#include <pbbam/SortingBamWriter.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cstdio>
+using namespace PacBio;
+using namespace PacBio::BAM;
+using namespace std;
+
+namespace PacBio {
+namespace BAM {
+namespace tests {
+
+static
+vector<BamRecord> ReversedRecords(const vector<string>& filenames)
+{
+    vector<BamRecord> result;
+    for (const auto& fn : filenames) {
+        EntireFileQuery query(fn);
+        for (const BamRecord& record : query)
+            result.push_back(record);
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+static
+vector<BamRecord> SortedRecords(const vector<BamRecord>& input,
+                                const string& outputFn,
+                                const SortingBamWriter::SortOrder sortOrder,
+                                const size_t memoryLimit,
+                                const bool createPbi = false)
+{
+    {
+        SortingBamWriter writer(outputFn, input.front().Header(), sortOrder,
+                                memoryLimit, 2, createPbi);
+        for (const auto& record : input)
+            writer.Write(record);
+        writer.Close();
+    }
+
+    vector<BamRecord> result;
+    EntireFileQuery query(outputFn);
+    for (const BamRecord& record : query)
+        result.push_back(record);
+    return result;
+}
+
+} // namespace tests
+} // namespace BAM
+} // namespace PacBio
+
+TEST(SortingBamWriterTest, CoordinateOrder)
+{
+    const string outputFn = "/tmp/sorted_coordinate.bam";
+    const auto input = tests::ReversedRecords({ tests::Data_Dir + "/aligned2.bam" });
+
+    // in-memory & spilled (tiny memory limit) runs should agree
+    for (const size_t memoryLimit : { size_t(0x40000000), size_t(0x1000) }) {
+        const auto sorted = tests::SortedRecords(input, outputFn,
+                                                 SortingBamWriter::SortOrder_Coordinate,
+                                                 memoryLimit);
+        ASSERT_EQ(input.size(), sorted.size());
+        EXPECT_EQ("coordinate", BamFile(outputFn).Header().SortOrder());
+
+        for (size_t i = 1; i < sorted.size(); ++i) {
+            const BamRecord& prev = sorted.at(i-1);
+            const BamRecord& curr = sorted.at(i);
+            const uint32_t prevId = static_cast<uint32_t>(prev.ReferenceId());
+            const uint32_t currId = static_cast<uint32_t>(curr.ReferenceId());
+            EXPECT_LE(prevId, currId);
+            if (prevId == currId && curr.ReferenceId() >= 0) {
+                EXPECT_LE(prev.ReferenceStart(), curr.ReferenceStart());
+            }
+        }
+    }
+    remove(outputFn.c_str());
+}
+
+TEST(SortingBamWriterTest, QNameOrder)
+{
+    const string outputFn = "/tmp/sorted_qname.bam";
+    const string chunkPrefix = tests::Data_Dir + "/chunking/m150404_101626_42267_c100807920800000001823174110291514_s1_p0";
+    const auto input = tests::ReversedRecords({ chunkPrefix + ".1.subreads.bam",
+                                                chunkPrefix + ".2.subreads.bam",
+                                                chunkPrefix + ".3.subreads.bam" });
+
+    vector<string> inMemoryNames;
+    for (const size_t memoryLimit : { size_t(0x40000000), size_t(0x4000) }) {
+        const auto sorted = tests::SortedRecords(input, outputFn,
+                                                 SortingBamWriter::SortOrder_QName,
+                                                 memoryLimit);
+        ASSERT_EQ(input.size(), sorted.size());
+
+        vector<string> names;
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            names.push_back(sorted.at(i).FullName());
+            if (i == 0)
+                continue;
+            const BamRecord& prev = sorted.at(i-1);
+            const BamRecord& curr = sorted.at(i);
+            EXPECT_LE(prev.MovieName(), curr.MovieName());
+            if (prev.MovieName() == curr.MovieName()) {
+                EXPECT_LE(prev.HoleNumber(), curr.HoleNumber());
+                if (prev.HoleNumber() == curr.HoleNumber()) {
+                    EXPECT_LE(prev.QueryStart(), curr.QueryStart());
+                }
+            }
+        }
+
+        if (inMemoryNames.empty())
+            inMemoryNames = names;
+        else
+            EXPECT_EQ(inMemoryNames, names);
+    }
+    remove(outputFn.c_str());
+}
+
+TEST(SortingBamWriterTest, CreatesPbi)
+{
+    const string outputFn = "/tmp/sorted_with_pbi.bam";
+    const string pbiFn = outputFn + ".pbi";
+    const auto input = tests::ReversedRecords({ tests::Data_Dir + "/aligned2.bam" });
+    tests::SortedRecords(input, outputFn, SortingBamWriter::SortOrder_Coordinate,
+                         0x1000, true);
+
+    const PbiRawData index(pbiFn);
+    EXPECT_EQ(input.size(), index.NumReads());
+    EXPECT_TRUE(index.HasMappedData());
+    EXPECT_TRUE(index.HasReferenceData());
+
+    remove(outputFn.c_str());
+    remove(pbiFn.c_str());
+}
+
+TEST(SortingBamWriterTest, ThrowsOnWriteAfterClose)
+{
+    const string outputFn = "/tmp/sorted_closed.bam";
+    const auto input = tests::ReversedRecords({ tests::Data_Dir + "/aligned2.bam" });
+    SortingBamWriter writer(outputFn, input.front().Header(),
+                            SortingBamWriter::SortOrder_Coordinate);
+    writer.Write(input.front());
+    writer.Close();
+    EXPECT_THROW(writer.Write(input.front()), std::runtime_error);
+    remove(outputFn.c_str());
+}
@@ -150,6 +150,22 @@ TEST(ZmwReadStitching, FromBams_NoFilter)
     EXPECT_EQ(3, count);
 }
 
+TEST(ZmwReadStitching, FromBams_NextRawMakesNoDeepCopies)
+{
+    ZmwReadStitcher stitcher(tests::Data_Dir + "/polymerase/internal.subreads.bam",
+                             tests::Data_Dir + "/polymerase/internal.scraps.bam");
+
+    const auto copiesBefore = BamRecordImpl::numDeepCopies_.load();
+    size_t count = 0;
+    while (stitcher.HasNext()) {
+        const auto records = stitcher.NextRaw();
+        EXPECT_FALSE(records.empty());
+        ++count;
+    }
+    EXPECT_EQ(3, count);
+    EXPECT_EQ(copiesBefore, BamRecordImpl::numDeepCopies_.load());
+}
+
 TEST(ZmwReadStitching, FromBams_Filtered)
 {
     PbiFilter filter { PbiZmwFilter{100000} }; // setup to match DataSet w/ filter
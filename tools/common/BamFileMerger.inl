@@ -43,6 +43,7 @@
 #include <pbbam/BamWriter.h>
 #include <pbbam/CompositeBamReader.h>
 #include <pbbam/PbiBuilder.h>
+#include <pbbam/PbiRawData.h>
 
 #include <deque>
 #include <memory>
@@ -53,6 +54,26 @@ namespace PacBio {
 namespace BAM {
 namespace common {
 
+// MergeItem
+
+// CompositeMergeItem, plus the position of its record within its source file
+struct MergeItem : public PacBio::BAM::internal::CompositeMergeItem
+{
+public:
+    MergeItem(std::unique_ptr<PacBio::BAM::BamReader>&& rdr, const size_t source)
+        : PacBio::BAM::internal::CompositeMergeItem(std::move(rdr))
+        , sourceIndex(source)
+        , numRecordsRead(0)
+    { }
+
+    MergeItem(MergeItem&& other) = default;
+    MergeItem& operator=(MergeItem&& other) = default;
+
+public:
+    size_t sourceIndex;    // index of input file
+    size_t numRecordsRead; // number of records fetched from input file
+};
+
 // ICollator
 
 class ICollator
@@ -61,25 +82,34 @@ public:
     ~ICollator(void) { }
 
     bool GetNext(BamRecord& record)
+    { return GetNext(record, nullptr, nullptr); }
+
+    // sourceIndex & sourceRecordNumber (if non-null) receive the input file
+    // index & the record's number among those read from that input
+    bool GetNext(BamRecord& record,
+                 size_t* sourceIndex,
+                 size_t* sourceRecordNumber)
     {
         // nothing left to read
         if (mergeItems_.empty())
             return false;
 
         // non-destructive 'pop' of first item from queue
-        auto firstIter = mergeItems_.begin();
-        auto firstItem = PacBio::BAM::internal::CompositeMergeItem{ std::move(firstIter->reader),
-                                                                    std::move(firstIter->record)
-                                                                  };
+        MergeItem firstItem = std::move(mergeItems_.front());
         mergeItems_.pop_front();
 
         // store its record in our output record
         std::swap(record, firstItem.record);
+        if (sourceIndex)
+            *sourceIndex = firstItem.sourceIndex;
+        if (sourceRecordNumber)
+            *sourceRecordNumber = firstItem.numRecordsRead - 1;
 
         // try fetch 'next' from first item's reader
         // if successful, re-insert it into container & re-sort on our new values
         // otherwise, this item will go out of scope & reader destroyed
         if (firstItem.reader->GetNext(firstItem.record)) {
+            ++firstItem.numRecordsRead;
             mergeItems_.push_front(std::move(firstItem));
             UpdateSort();
         }
@@ -89,15 +119,17 @@ public:
     }
 
 protected:
-    std::deque<PacBio::BAM::internal::CompositeMergeItem> mergeItems_;
+    std::deque<MergeItem> mergeItems_;
 
 protected:
     ICollator(std::vector<std::unique_ptr<PacBio::BAM::BamReader> >&& readers)
     {
-        for (auto&& reader : readers) {
-            auto item = internal::CompositeMergeItem{std::move(reader)};
-            if (item.reader->GetNext(item.record))
+        for (size_t i = 0; i < readers.size(); ++i) {
+            auto item = MergeItem{ std::move(readers.at(i)), i };
+            if (item.reader->GetNext(item.record)) {
+                ++item.numRecordsRead;
                 mergeItems_.push_back(std::move(item));
+            }
         }
     }
 
@@ -232,8 +264,10 @@ void BamFileMerger::Merge(const DataSet& dataset,
     // do merge, creating PBI on-the-fly
     if (createPbi && (outputFilename != "-")) {
 
-        // TODO: this implementation recalculates all PBI values, when we really
-        //       only need to collate entries and update offsets
+        // collate PBI rows from inputs' existing indices, if all are available
+        bool canCollatePbi = true;
+        for (const auto& file : bamFiles)
+            canCollatePbi &= file.PacBioIndexExists();
 
         BamWriter writer(outputFilename, mergedHeader);
         PbiBuilder builder{ (outputFilename + ".pbi"),
@@ -242,9 +276,43 @@ void BamFileMerger::Merge(const DataSet& dataset,
                           };
         BamRecord record;
         int64_t vOffset = 0;
-        while (collator->GetNext(record)) {
-            writer.Write(record, &vOffset);
-            builder.AddRecord(record, vOffset);
+
+        if (canCollatePbi) {
+
+            // load indices & store the rows each reader will return, in order
+            std::vector<PbiRawData> indices;
+            std::vector<std::vector<uint32_t> > sourceRows;
+            indices.reserve(bamFiles.size());
+            sourceRows.reserve(bamFiles.size());
+            for (const auto& file : bamFiles) {
+                indices.emplace_back(file.PacBioIndexFilename());
+                const PbiRawData& index = indices.back();
+                const uint32_t numReads = index.NumReads();
+                std::vector<uint32_t> rows;
+                rows.reserve(numReads);
+                for (uint32_t i = 0; i < numReads; ++i) {
+                    if (filter.IsEmpty() || filter.Accepts(index, i))
+                        rows.push_back(i);
+                }
+                sourceRows.push_back(std::move(rows));
+            }
+
+            size_t sourceIndex = 0;
+            size_t sourceRecordNumber = 0;
+            while (collator->GetNext(record, &sourceIndex, &sourceRecordNumber)) {
+                writer.Write(record, &vOffset);
+                builder.AddRow(indices.at(sourceIndex),
+                               sourceRows.at(sourceIndex).at(sourceRecordNumber),
+                               vOffset);
+            }
+        }
+
+        // otherwise, calculate PBI values from records
+        else {
+            while (collator->GetNext(record)) {
+                writer.Write(record, &vOffset);
+                builder.AddRecord(record, vOffset);
+            }
         }
     }
 